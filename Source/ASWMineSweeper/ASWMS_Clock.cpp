@@ -0,0 +1,158 @@
+/* **************************************************************************
+ASWMS_Clock.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_Clock.h"
+//---------------------------------------------------------------------------
+#include <chrono>
+//---------------------------------------------------------------------------
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TClock
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TClock::TClock()
+{
+}
+//---------------------------------------------------------------------------
+TClock::~TClock()
+{
+}
+//---------------------------------------------------------------------------
+int64_t TClock::NowMilliSecs()
+{
+    return NowMicroSecs() / 1000;
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TSteadyClock
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TSteadyClock::TSteadyClock()
+{
+}
+//---------------------------------------------------------------------------
+TSteadyClock::~TSteadyClock()
+{
+}
+//---------------------------------------------------------------------------
+int64_t TSteadyClock::NowMicroSecs()
+{
+    std::chrono::steady_clock::duration sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count());
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// THighResClock
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+THighResClock::THighResClock()
+    : m_Frequency(0)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    if (::QueryPerformanceFrequency(&freq))
+        m_Frequency = static_cast<int64_t>(freq.QuadPart);
+#endif
+}
+//---------------------------------------------------------------------------
+THighResClock::~THighResClock()
+{
+}
+//---------------------------------------------------------------------------
+int64_t THighResClock::NowMicroSecs()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    if (m_Frequency <= 0 || !::QueryPerformanceCounter(&counter))
+        return static_cast<int64_t>(::GetTickCount64()) * 1000;
+
+    // Split into whole seconds and remainder so that the multiply can't overflow for long uptimes
+    int64_t const ticks = static_cast<int64_t>(counter.QuadPart);
+    int64_t const wholeSecs = ticks / m_Frequency;
+    int64_t const remainder = ticks % m_Frequency;
+    return wholeSecs * 1000000 + (remainder * 1000000) / m_Frequency;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + static_cast<int64_t>(ts.tv_nsec) / 1000;
+#endif
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TManualClock
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TManualClock::TManualClock()
+    : m_NowMicroSecs(0)
+{
+}
+//---------------------------------------------------------------------------
+TManualClock::TManualClock(int64_t startMicroSecs)
+    : m_NowMicroSecs(startMicroSecs)
+{
+}
+//---------------------------------------------------------------------------
+TManualClock::~TManualClock()
+{
+}
+//---------------------------------------------------------------------------
+void TManualClock::AdvanceMicroSecs(int64_t microSecs)
+{
+    m_NowMicroSecs += microSecs;
+}
+//---------------------------------------------------------------------------
+void TManualClock::AdvanceMilliSecs(int64_t milliSecs)
+{
+    m_NowMicroSecs += milliSecs * 1000;
+}
+//---------------------------------------------------------------------------
+int64_t TManualClock::NowMicroSecs()
+{
+    return m_NowMicroSecs;
+}
+//---------------------------------------------------------------------------
+void TManualClock::SetMicroSecs(int64_t microSecs)
+{
+    m_NowMicroSecs = microSecs;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
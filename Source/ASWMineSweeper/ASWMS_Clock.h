@@ -0,0 +1,105 @@
+/* **************************************************************************
+ASWMS_Clock.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_ClockH
+#define ASWMS_ClockH
+//---------------------------------------------------------------------------
+#include <stdint.h>
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TClock
+//
+// Monotonic time source for game timing. Times are in microseconds, counted
+// from an arbitrary starting point that is specific to each clock.
+/////////////////////////////////////////////////////////////////////////////
+class TClock
+{
+public:
+    TClock();
+    virtual ~TClock();
+
+    virtual int64_t NowMicroSecs() = 0;
+    int64_t NowMilliSecs();
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TSteadyClock
+//
+// Default clock - std::chrono::steady_clock.
+/////////////////////////////////////////////////////////////////////////////
+class TSteadyClock : public TClock
+{
+public:
+    TSteadyClock();
+    ~TSteadyClock();
+
+    int64_t NowMicroSecs() override;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// THighResClock
+//
+// QueryPerformanceCounter on Windows, clock_gettime(CLOCK_MONOTONIC) elsewhere.
+/////////////////////////////////////////////////////////////////////////////
+class THighResClock : public TClock
+{
+private:
+    int64_t m_Frequency;
+
+public:
+    THighResClock();
+    ~THighResClock();
+
+    int64_t NowMicroSecs() override;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TManualClock
+//
+// Only moves when told to. Used for tests and for deterministic replays.
+/////////////////////////////////////////////////////////////////////////////
+class TManualClock : public TClock
+{
+private:
+    int64_t m_NowMicroSecs;
+
+public:
+    TManualClock();
+    explicit TManualClock(int64_t startMicroSecs);
+    ~TManualClock();
+
+    int64_t NowMicroSecs() override;
+
+    void AdvanceMicroSecs(int64_t microSecs);
+    void AdvanceMilliSecs(int64_t milliSecs);
+    void SetMicroSecs(int64_t microSecs);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_ClockH
@@ -23,6 +23,7 @@ limitations under the License.
 #include "ASWMS_Engine.h"
 //---------------------------------------------------------------------------
 #include <algorithm>
+#include <limits>
 #include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -50,12 +51,19 @@ TMSEngine::TMSEngine()
       m_MouseDown_Shift(0),
       m_MouseDown_X(-1),
       m_MouseDown_Y(-1),
+      m_LastDrawMouseX(-1),
+      m_LastDrawMouseY(-1),
       m_NumMines(0),
-      m_NumFlaggedMines(0),
       m_BoomRow(GridCoord_NotSet),
       m_BoomCol(GridCoord_NotSet),
-      m_StartTick(Tick_NotSet),
-      m_PauseTick(Tick_NotSet),
+      m_StartTime(Time_NotSet),
+      m_PauseTime(Time_NotSet),
+      m_Clock(&m_DefaultClock),
+      m_GameOverDrawPending(false),
+      m_ScoreboardTime(NumDigits_Time, FrameColor),
+      m_ScoreboardMinesRemaining(NumDigits_MinesRemaining, FrameColor),
+      m_FullRedrawPending(true),
+      m_ZoomLevel(TSprites::DefaultZoomLevel),
       Grid(nullptr)
 {
 }
@@ -65,6 +73,12 @@ TMSEngine::~TMSEngine()
     delete Grid;
 }
 //---------------------------------------------------------------------------
+void TMSEngine::AddFlag(size_t row, size_t col)
+{
+    Grid->GetCell(row, col)->MarkedAsMine = true;
+    m_FlagCoords.push_back(TGridCoord(row, col));
+}
+//---------------------------------------------------------------------------
 // If flagged count is the same as mine count in neighboring cells, unflagged cells will be auto clicked. If the player
 // incorrectly marked a cell, the game is lost if a mine is clicked.
 void TMSEngine::AutoClickNeighboringCells(size_t row, size_t col)
@@ -107,6 +121,7 @@ void TMSEngine::CheckForAndSetWin()
     }
 
     m_GameState = EGameState::GameOver_Win;
+    m_GameOverDrawPending = true;
 }
 //---------------------------------------------------------------------------
 void TMSEngine::ClickNeighboringCells(TShiftState shift, size_t row, size_t col)
@@ -164,6 +179,7 @@ void TMSEngine::DoClick(TShiftState shift, size_t row, size_t col)
             m_BoomCol = col;
             cell->Discovered = true;
             cell->MarkedAsQuestion = false;
+            m_ChangedCoords.push_back(TGridCoord(row, col));
             RevealAll();
         }
         else if (!cell->Discovered)
@@ -171,6 +187,7 @@ void TMSEngine::DoClick(TShiftState shift, size_t row, size_t col)
             cell->Discovered = true;
             cell->MarkedAsMine = false;
             cell->MarkedAsQuestion = false;
+            m_ChangedCoords.push_back(TGridCoord(row, col));
 
             CheckForAndSetWin();
             if (EGameState::GameOver_Win == m_GameState)
@@ -184,7 +201,7 @@ void TMSEngine::DoClick(TShiftState shift, size_t row, size_t col)
     {
         if (cell->MarkedAsMine)
         {
-            cell->MarkedAsMine = false;
+            RemoveFlag(row, col);
 
             if (m_UseQuestionMarks)
                 cell->MarkedAsQuestion = true;
@@ -195,147 +212,62 @@ void TMSEngine::DoClick(TShiftState shift, size_t row, size_t col)
         }
         else
         {
-            cell->MarkedAsMine = true;
+            AddFlag(row, col);
         }
+
+        m_ChangedCoords.push_back(TGridCoord(row, col));
     }
 }
 //---------------------------------------------------------------------------
 void TMSEngine::DrawCell(
     TImage* image, size_t row, size_t col, int xPos, int yPos, TShiftState shift, int mouseX, int mouseY)
 {
-    uint32_t const hashStartDiscovered = 100;
-    uint32_t const hashStartUnDiscovered = 1000;
+    size_t mouseRow;
+    size_t mouseCol;
+    GridCoordsFromMouse(&mouseCol, &mouseRow, mouseX, mouseY);
 
-    TCell* cell = Grid->GetCell(row, col);
-    Graphics::TBitmap* bmp = image->Picture->Bitmap;
-    TCanvas* canvas = bmp->Canvas;
-    Graphics::TBitmap* bmpTile = nullptr;
-    Graphics::TBitmap* bmpMine = nullptr;
-    Graphics::TBitmap* bmpProx = nullptr;
-    Graphics::TBitmap* bmpFlag = nullptr;
-    Graphics::TBitmap* bmpFlagX = nullptr;
-    uint32_t drawHash = 0;
-
-    if (cell->Discovered)
-    {
-        bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::Uncovered)].Bmp;
-        drawHash = hashStartDiscovered;
-
-        if (cell->IsMine)
-        {
-            bmpMine = Sprites.Mine.Bmp;
-            drawHash++;
-
-            if (row == m_BoomRow && col == m_BoomCol)
-            {
-                bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::UncoveredBoom)].Bmp;
-                drawHash++;
-            }
-        }
-        else
-        {
-            int nMines = GetNeighboringMineCount(row, col);
-            if (nMines > 0)
-            {
-                bmpProx = Sprites.Digits_Proximity[static_cast<size_t>(nMines - 1)].Bmp;
-                drawHash -= static_cast<uint32_t>(nMines);
-            }
-
-            // Player incorrectly marked this cell as a mine - this condition occurs after game is over
-            if (cell->MarkedAsMine)
-            {
-                bmpFlagX = Sprites.FlagX.Bmp;
-                drawHash -= 10;
-            }
-        }
-    }
-    else
-    {
-        bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::Covered)].Bmp;
-        drawHash = hashStartUnDiscovered;
-
-        size_t mouseRow;
-        size_t mouseCol;
-        GridCoordsFromMouse(&mouseCol, &mouseRow, mouseX, mouseY);
-        TCell const* mouseCell = nullptr;
-
-        if (GridCoord_NotSet != mouseRow && GridCoord_NotSet != mouseCol)
-            mouseCell = Grid->GetCell(mouseRow, mouseCol);
-
-        // Is the mouse over the cell
-        if (mouseRow == row && mouseCol == col)
-        {
-            bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::CoveredLit)].Bmp;
-            drawHash++;
-
-            // Note: Allow question marks to be shown as clicking
-            if (shift.Contains(ssLeft) && !cell->MarkedAsMine)
-            {
-                bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::CoveredClicked)].Bmp;
-                drawHash++;
-            }
-        }
-
-        // Check for player attempting an auto-click for multiple cells (both mouse buttons down)
-        if (GridCoord_NotSet != mouseRow && GridCoord_NotSet != mouseCol &&
-            !cell->MarkedAsMine &&
-            mouseCell->Discovered && shift.Contains(ssLeft) && shift.Contains(ssRight))
-        {
-            int diffCol = std::abs(static_cast<int>(mouseCol) - static_cast<int>(col));
-            int diffRow = std::abs(static_cast<int>(mouseRow) - static_cast<int>(row));
-
-            if (diffCol <= 1  && diffRow <= 1)
-            {
-                bmpTile = Sprites.Tiles[static_cast<size_t>(ETile::CoveredLit)].Bmp;
-                drawHash += 10;
-            }
-        }
-    }
-
-    if (cell->MarkedAsMine)
-    {
-        bmpFlag = Sprites.Flag.Bmp;
-        m_NumFlaggedMines++;
-        drawHash -= 30;
-    }
-    else if (cell->MarkedAsQuestion)
-    {
-        bmpFlag = Sprites.Question.Bmp;
-        drawHash += 100;
-    }
+    TCellLayers layers;
+    GetCellLayers(&layers, row, col, shift, mouseRow, mouseCol);
 
     // Don't draw the cell if the hash didn't change
-    if (drawHash == cell->LastDrawHash)
+    TCell* cell = Grid->GetCell(row, col);
+    if (layers.DrawHash == cell->LastDrawHash)
         return;
 
-    cell->LastDrawHash = drawHash;
+    cell->LastDrawHash = layers.DrawHash;
+
+    TCanvas* canvas = image->Picture->Bitmap->Canvas;
+    Graphics::TBitmap* bmpTile = layers.Tile->Bmp;
 
     // Draw tile first (Layer 1)
-    if (nullptr != bmpTile)
-        canvas->Draw(xPos, yPos, bmpTile);
+    canvas->Draw(xPos, yPos, bmpTile);
 
     // Draw mine or proximity digit (layer 2)
-    if (nullptr != bmpMine)
+    if (nullptr != layers.Mine)
     {
+        Graphics::TBitmap* bmpMine = layers.Mine->Bmp;
         bmpMine->Transparent = true;
         canvas->Draw(xPos, yPos, bmpMine);
     }
-    else if (nullptr != bmpProx)
+    else if (nullptr != layers.Prox)
     {
+        Graphics::TBitmap* bmpProx = layers.Prox->Bmp;
         bmpProx->Transparent = true;
         canvas->Draw(xPos, yPos, bmpProx);
     }
 
     // Draw flag/marker (Layer 3)
-    if (nullptr != bmpFlag)
+    if (nullptr != layers.Flag)
     {
+        Graphics::TBitmap* bmpFlag = layers.Flag->Bmp;
         bmpFlag->Transparent = true;
         canvas->Draw(xPos, yPos, bmpFlag);
     }
 
     // Draw incorrect flag/marker (Layer 4)
-    if (nullptr != bmpFlagX)
+    if (nullptr != layers.FlagX)
     {
+        Graphics::TBitmap* bmpFlagX = layers.FlagX->Bmp;
         bmpFlagX->Transparent = true;
         canvas->Draw(xPos, yPos, bmpFlagX);
     }
@@ -346,38 +278,68 @@ void TMSEngine::DrawCell(
     canvas->FrameRect(rect);
 }
 //---------------------------------------------------------------------------
-void TMSEngine::DrawDigits(TImage* image, int value, size_t maxDigits)
+void TMSEngine::DrawCell(TImage* image, size_t row, size_t col, TShiftState shift, int mouseX, int mouseY)
 {
-    std::vector<int> digits = ExtractDigits(value, true);
-    if (digits.size() > maxDigits)
-        digits.resize(maxDigits);
+    int xOffset = static_cast<int>(col) * GetCellDrawWidth();
+    int yOffset = static_cast<int>(row) * GetCellDrawHeight();
+    DrawCell(image, row, col, xOffset, yOffset, shift, mouseX, mouseY);
+}
+//---------------------------------------------------------------------------
+// Draws only the listed cells, without any mouse highlighting.
+void TMSEngine::DrawCells(TImage* image, TGrid::TCoordList const& coords)
+{
+    TShiftState noShift;
 
-    TBitmap* bmp = image->Picture->Bitmap;
-    TCanvas* canvas = bmp->Canvas;
+    for (TGrid::TCoordList::const_iterator it = coords.begin(); it != coords.end(); it++)
+        DrawCell(image, it->Row, it->Col, noShift, -1, -1);
+}
+//---------------------------------------------------------------------------
+// Draws only what the final click could have changed: the cells it touched, the highlighted cells around the mouse
+// and, when the game was lost, the mines and flags. The rest of the grid already shows its final state.
+void TMSEngine::DrawGameOver(TImage* image)
+{
+    m_GameOverDrawPending = false;
 
-    for (size_t i = maxDigits - 1, count = digits.size(), idx = 0; i < maxDigits; i--, idx++)
-    {
-        int digit = TSprites::BlankScoreDigitIndex;
-        if (i < count)
-            digit = digits[i];
+    DrawCells(image, m_ChangedCoords);
+    DrawNeighborhood(image, m_MouseDown_X, m_MouseDown_Y);
+    DrawNeighborhood(image, m_LastDrawMouseX, m_LastDrawMouseY);
 
-        TBitmap* bmpDigit = Sprites.Digits_Score[static_cast<size_t>(digit)].Bmp;
-        bmpDigit->Transparent = true;
-        canvas->Draw(bmpDigit->Width * static_cast<int>(idx), 0, bmpDigit);
+    if (EGameState::GameOver_Boom == m_GameState)
+    {
+        DrawCells(image, m_MineCoords);
+        DrawCells(image, m_FlagCoords);
     }
-
-    // Draw border
-    TRect rect(0, 0, bmp->Width - 1, bmp->Height - 1);
-    canvas->Brush->Color = TColor(FrameColor);
-    canvas->FrameRect(rect);
 }
 //---------------------------------------------------------------------------
 void TMSEngine::DrawMap(TImage* image, TShiftState shift, int mouseX, int mouseY)
 {
+    if (IsGameOver())
+    {
+        // After a zoom change every cell needs drawing again, in its final state
+        if (m_FullRedrawPending)
+        {
+            m_GameOverDrawPending = false;
+            RasterizeMap(image, TShiftState(), -1, -1);
+            return;
+        }
+
+        // Nothing changes after the game over cells are drawn, so don't scan the whole grid again
+        if (m_GameOverDrawPending)
+            DrawGameOver(image);
+        return;
+    }
+
     int cellWidth = GetCellDrawWidth();
     int cellHeight = GetCellDrawHeight();
 
-    m_NumFlaggedMines = 0;
+    m_LastDrawMouseX = mouseX;
+    m_LastDrawMouseY = mouseY;
+
+    if (m_FullRedrawPending)
+    {
+        RasterizeMap(image, shift, mouseX, mouseY);
+        return;
+    }
 
     for (size_t row = 0, nRows = Grid->GetRowCount(); row < nRows; row++)
     {
@@ -397,61 +359,163 @@ void TMSEngine::DrawMap(TImage* image)
     DrawMap(image, dummy, -1, -1);
 }
 //---------------------------------------------------------------------------
+// Copies only the minimap pixels changed since the last call.
+void TMSEngine::DrawMinimap(TImage* image)
+{
+    m_Minimap.Draw(image);
+}
+//---------------------------------------------------------------------------
+// Redraws the cells surrounding the mouse position (the only cells that can be drawn as lit or clicked).
+void TMSEngine::DrawNeighborhood(TImage* image, int mouseX, int mouseY)
+{
+    size_t mouseRow;
+    size_t mouseCol;
+    GridCoordsFromMouse(&mouseCol, &mouseRow, mouseX, mouseY);
+
+    if (GridCoord_NotSet == mouseRow || GridCoord_NotSet == mouseCol)
+        return;
+
+    size_t nCols = Grid->GetColCount();
+    size_t nRows = Grid->GetRowCount();
+    TShiftState noShift;
+
+    // Note: Row/col - 1 wraps around to a huge value on the top/left edge and is skipped by the bounds check
+    for (size_t row = mouseRow - 1; row != mouseRow + 2; row++)
+    {
+        for (size_t col = mouseCol - 1; col != mouseCol + 2; col++)
+        {
+            if (row < nRows && col < nCols)
+                DrawCell(image, row, col, noShift, -1, -1);
+        }
+    }
+}
+//---------------------------------------------------------------------------
 void TMSEngine::DrawMinesRemaining(TImage* image)
 {
-    int remaining = m_NumMines - m_NumFlaggedMines;
+    int remaining = m_NumMines - static_cast<int>(m_FlagCoords.size());
     if (remaining < 0)
         remaining = 0;
 
-    size_t maxDigits = static_cast<size_t>(NumDigits_Time);
-    DrawDigits(image, remaining, maxDigits);
+    m_ScoreboardMinesRemaining.Draw(image, Sprites, remaining);
 }
 //---------------------------------------------------------------------------
 void TMSEngine::DrawTime(TImage* image)
 {
     int seconds = GetEllapsedTimeMilliSecs() / 1000;
-    size_t maxDigits = static_cast<size_t>(NumDigits_Time);
-    DrawDigits(image, seconds, maxDigits);
+    m_ScoreboardTime.Draw(image, Sprites, seconds);
+}
+//---------------------------------------------------------------------------
+int TMSEngine::GetCellDrawHeight()
+{
+    return GetMapSprites().CellHeight;
+}
+//---------------------------------------------------------------------------
+int TMSEngine::GetCellDrawWidth()
+{
+    return GetMapSprites().CellWidth;
 }
 //---------------------------------------------------------------------------
-std::vector<int> TMSEngine::ExtractDigits(int value, bool reverseOrder)
+// Picks the sprites to draw for a cell and the hash identifying that look. Only reads engine state, so it is safe
+// to call for different cells from several threads at once.
+void TMSEngine::GetCellLayers(
+    TCellLayers* layers, size_t row, size_t col, TShiftState shift, size_t mouseRow, size_t mouseCol)
 {
-    std::vector<int> result;
+    uint32_t const hashStartDiscovered = 100;
+    uint32_t const hashStartUnDiscovered = 1000;
 
-    if (0 == value)
+    TSprites::TMapSprites& map = GetMapSprites();
+
+    TCell const* cell = Grid->GetCell(row, col);
+    *layers = TCellLayers();
+
+    if (IsRevealed(cell))
     {
-        result.push_back(0);
-        return result;
-    }
+        layers->Tile = &map.Tiles[static_cast<size_t>(ETile::Uncovered)];
+        layers->DrawHash = hashStartDiscovered;
+
+        if (cell->IsMine)
+        {
+            layers->Mine = &map.Mine;
+            layers->DrawHash++;
 
-    if (value < 0)
-        value = -value;
+            if (row == m_BoomRow && col == m_BoomCol)
+            {
+                layers->Tile = &map.Tiles[static_cast<size_t>(ETile::UncoveredBoom)];
+                layers->DrawHash++;
+            }
+        }
+        else
+        {
+            int nMines = GetNeighboringMineCount(row, col);
+            if (nMines > 0)
+            {
+                layers->Prox = &map.Digits_Proximity[static_cast<size_t>(nMines - 1)];
+                layers->DrawHash -= static_cast<uint32_t>(nMines);
+            }
 
-    while (value > 0)
+            // Player incorrectly marked this cell as a mine - this condition occurs after game is over
+            if (cell->MarkedAsMine)
+            {
+                layers->FlagX = &map.FlagX;
+                layers->DrawHash -= 10;
+            }
+        }
+    }
+    else
     {
-        result.push_back(value % 10);
-        value /= 10;
+        layers->Tile = &map.Tiles[static_cast<size_t>(ETile::Covered)];
+        layers->DrawHash = hashStartUnDiscovered;
+
+        TCell const* mouseCell = nullptr;
+
+        if (GridCoord_NotSet != mouseRow && GridCoord_NotSet != mouseCol)
+            mouseCell = Grid->GetCell(mouseRow, mouseCol);
+
+        // Is the mouse over the cell
+        if (mouseRow == row && mouseCol == col)
+        {
+            layers->Tile = &map.Tiles[static_cast<size_t>(ETile::CoveredLit)];
+            layers->DrawHash++;
+
+            // Note: Allow question marks to be shown as clicking
+            if (shift.Contains(ssLeft) && !cell->MarkedAsMine)
+            {
+                layers->Tile = &map.Tiles[static_cast<size_t>(ETile::CoveredClicked)];
+                layers->DrawHash++;
+            }
+        }
+
+        // Check for player attempting an auto-click for multiple cells (both mouse buttons down)
+        if (nullptr != mouseCell &&
+            !cell->MarkedAsMine &&
+            mouseCell->Discovered && shift.Contains(ssLeft) && shift.Contains(ssRight))
+        {
+            int diffCol = std::abs(static_cast<int>(mouseCol) - static_cast<int>(col));
+            int diffRow = std::abs(static_cast<int>(mouseRow) - static_cast<int>(row));
+
+            if (diffCol <= 1  && diffRow <= 1)
+            {
+                layers->Tile = &map.Tiles[static_cast<size_t>(ETile::CoveredLit)];
+                layers->DrawHash += 10;
+            }
+        }
     }
 
-    // If caller wants the reverse order, leave as is
-    if (!reverseOrder)
-        std::reverse(result.begin(), result.end());
-    return result;
-}
-//---------------------------------------------------------------------------
-int TMSEngine::GetCellDrawHeight()
-{
-    return Sprites.Tiles[0].Bmp->Height;
-}
-//---------------------------------------------------------------------------
-int TMSEngine::GetCellDrawWidth()
-{
-    return Sprites.Tiles[0].Bmp->Width;
+    if (cell->MarkedAsMine)
+    {
+        layers->Flag = &map.Flag;
+        layers->DrawHash -= 30;
+    }
+    else if (cell->MarkedAsQuestion)
+    {
+        layers->Flag = &map.Question;
+        layers->DrawHash += 100;
+    }
 }
 //---------------------------------------------------------------------------
 int TMSEngine::GetDrawHeight()
 {
-    return static_cast<int>(Grid->GetRowCount()) * Sprites.Tiles[0].Bmp->Height;
+    return static_cast<int>(Grid->GetRowCount()) * GetCellDrawHeight();
 }
 //---------------------------------------------------------------------------
 int TMSEngine::GetDrawHeight_MinesRemaining()
@@ -466,7 +530,7 @@ int TMSEngine::GetDrawHeight_Time()
 //---------------------------------------------------------------------------
 int TMSEngine::GetDrawWidth()
 {
-    return static_cast<int>(Grid->GetColCount()) * Sprites.Tiles[0].Bmp->Width;
+    return static_cast<int>(Grid->GetColCount()) * GetCellDrawWidth();
 }
 //---------------------------------------------------------------------------
 int TMSEngine::GetDrawWidth_MinesRemaining()
@@ -479,12 +543,33 @@ int TMSEngine::GetDrawWidth_Time()
     return NumDigits_Time * Sprites.Digits_Score[0].Bmp->Width;
 }
 //---------------------------------------------------------------------------
+TClock* TMSEngine::GetClock()
+{
+    return m_Clock;
+}
+//---------------------------------------------------------------------------
+// Clamped to INT_MAX (about 24.8 days). Use GetEllapsedTimeMilliSecs64() for the full range.
 int TMSEngine::GetEllapsedTimeMilliSecs()
 {
-    if (Tick_NotSet == m_StartTick)
+    int64_t milliSecs = GetEllapsedTimeMilliSecs64();
+    if (milliSecs > std::numeric_limits<int>::max())
+        return std::numeric_limits<int>::max();
+    return static_cast<int>(milliSecs);
+}
+//---------------------------------------------------------------------------
+int64_t TMSEngine::GetEllapsedTimeMilliSecs64()
+{
+    return GetEllapsedTimeMicroSecs() / 1000;
+}
+//---------------------------------------------------------------------------
+int64_t TMSEngine::GetEllapsedTimeMicroSecs()
+{
+    if (Time_NotSet == m_StartTime)
         return 0;
-    ULONGLONG offset = (m_Paused ? ::GetTickCount64() - m_PauseTick : 0);
-    return static_cast<int>(::GetTickCount64() - (m_StartTick + offset));
+
+    int64_t now = (m_Paused ? m_PauseTime : m_Clock->NowMicroSecs());
+    int64_t ellapsed = now - m_StartTime;
+    return (ellapsed < 0 ? 0 : ellapsed);
 }
 //---------------------------------------------------------------------------
 EGameState TMSEngine::GetGameState()
@@ -492,6 +577,34 @@ EGameState TMSEngine::GetGameState()
     return m_GameState;
 }
 //---------------------------------------------------------------------------
+// Time until the displayed seconds next change, so the scoreboard timer can wake up only when there is something
+// to draw. Returns a full second when the clock isn't running.
+int TMSEngine::GetMilliSecsToNextSecond()
+{
+    if (Time_NotSet == m_StartTime || m_Paused || EGameState::InProgress != m_GameState)
+        return 1000;
+
+    int64_t const intoSecond = (GetEllapsedTimeMicroSecs() / 1000) % 1000;
+    return static_cast<int>(1000 - intoSecond);
+}
+//---------------------------------------------------------------------------
+// How the cell shows on the minimap. Mirrors what DrawMap() shows for it, less the mouse highlighting.
+TMinimap::ECell TMSEngine::GetMinimapCell(size_t row, size_t col) const
+{
+    TCell const* cell = Grid->GetCell(row, col);
+
+    if (cell->MarkedAsMine)
+        return TMinimap::ECell::Flagged;
+
+    if (cell->IsMine && EGameState::GameOver_Boom == m_GameState)
+        return TMinimap::ECell::Mine;
+
+    if (cell->Discovered)
+        return TMinimap::ECell::Revealed;
+
+    return TMinimap::ECell::Covered;
+}
+//---------------------------------------------------------------------------
 int TMSEngine::GetNeighboringFlagCount(size_t row, size_t col) const
 {
     int count = 0;
@@ -564,9 +677,15 @@ int TMSEngine::GetNeighboringMineCount(size_t row, size_t col) const
     return count;
 }
 //---------------------------------------------------------------------------
-ULONGLONG TMSEngine::GetStartedTick64() const
+// The map sprites for the current zoom level.
+TSprites::TMapSprites& TMSEngine::GetMapSprites()
+{
+    return Sprites.GetMapSprites(m_ZoomLevel);
+}
+//---------------------------------------------------------------------------
+int64_t TMSEngine::GetStartedTimeMicroSecs() const
 {
-    return m_StartTick;
+    return m_StartTime;
 }
 //---------------------------------------------------------------------------
 bool TMSEngine::GetUseQuestionMarks() const
@@ -574,6 +693,12 @@ bool TMSEngine::GetUseQuestionMarks() const
     return m_UseQuestionMarks;
 }
 //---------------------------------------------------------------------------
+// Index into TSprites::ZoomPercents.
+size_t TMSEngine::GetZoomLevel() const
+{
+    return m_ZoomLevel;
+}
+//---------------------------------------------------------------------------
 void TMSEngine::GridCoordsFromMouse(size_t* col, size_t* row, int x, int y)
 {
     if (nullptr != col)
@@ -605,6 +730,16 @@ void TMSEngine::GridCoordsFromMouse(size_t* col, size_t* row, int x, int y)
     }
 }
 //---------------------------------------------------------------------------
+// Once the game is lost, mines and wrongly flagged cells are drawn as revealed. This is derived from the game state
+// rather than written to every cell.
+bool TMSEngine::IsRevealed(TCell const* cell) const
+{
+    if (cell->Discovered)
+        return true;
+
+    return EGameState::GameOver_Boom == m_GameState && (cell->IsMine || cell->MarkedAsMine);
+}
+//---------------------------------------------------------------------------
 bool TMSEngine::IsGameOver() const
 {
     return EGameState::GameOver_Win == m_GameState || EGameState::GameOver_Boom == m_GameState;
@@ -615,6 +750,20 @@ bool TMSEngine::IsGameRunning() const
     return EGameState::InProgress == m_GameState;
 }
 //---------------------------------------------------------------------------
+// The map image point at the center of the cell under minimap point x, y, for scrolling the map to it. False if the
+// point is outside the minimap.
+bool TMSEngine::MinimapToMapPoint(int x, int y, int* mapX, int* mapY)
+{
+    size_t row;
+    size_t col;
+    if (nullptr == Grid || !m_Minimap.CellFromPoint(x, y, &row, &col))
+        return false;
+
+    *mapX = static_cast<int>(col) * GetCellDrawWidth() + GetCellDrawWidth() / 2;
+    *mapY = static_cast<int>(row) * GetCellDrawHeight() + GetCellDrawHeight() / 2;
+    return true;
+}
+//---------------------------------------------------------------------------
 void TMSEngine::MouseDown(TShiftState shift, int x, int y)
 {
     m_MouseDown_Shift = shift;
@@ -637,15 +786,25 @@ void TMSEngine::MouseUp(TShiftState shift, int x, int y)
     if (GridCoord_NotSet == row || GridCoord_NotSet == col)
         return; // Mouse coordinates are out of bounds
 
+    m_ChangedCoords.clear();
+
     if (m_firstClick)
     {
         m_firstClick = false;
         PopulateMineField(row, col);
         m_GameState = EGameState::InProgress;
-        m_StartTick = ::GetTickCount64();
+        m_StartTime = m_Clock->NowMicroSecs();
     }
 
+    EGameState const oldState = m_GameState;
+
     DoClick(shift, row, col);
+
+    UpdateMinimap(m_ChangedCoords);
+
+    // Losing shows every mine, once
+    if (EGameState::GameOver_Boom == m_GameState && oldState != m_GameState)
+        UpdateMinimap(m_MineCoords);
 }
 //---------------------------------------------------------------------------
 void TMSEngine::NewGame(size_t nRows, size_t nCols, int nMines, TImage* imgMap, TImage* imgTime,
@@ -655,16 +814,27 @@ void TMSEngine::NewGame(size_t nRows, size_t nCols, int nMines, TImage* imgMap,
     Grid = new TGrid(nRows, nCols);
 
     m_firstClick = true;
-    m_StartTick = m_PauseTick = Tick_NotSet;
+    m_StartTime = m_PauseTime = Time_NotSet;
     m_GameState = EGameState::NewGame;
     m_NumMines = std::min(static_cast<int>(nRows * nCols) - 1, nMines);
-    m_NumFlaggedMines = 0;
     m_UseQuestionMarks = useQuestionMarks;
     m_Paused = false;
+    m_GameOverDrawPending = false;
+    m_LastDrawMouseX = -1;
+    m_LastDrawMouseY = -1;
+
+    m_MineCoords.clear();
+    m_FlagCoords.clear();
+    m_ChangedCoords.clear();
 
     m_BoomRow = GridCoord_NotSet;
     m_BoomCol = GridCoord_NotSet;
 
+    m_ScoreboardTime.Invalidate();
+    m_ScoreboardMinesRemaining.Invalidate();
+    m_FullRedrawPending = true;
+    m_Minimap.Reset(nRows, nCols);
+
     // Prep the map image
     Graphics::TBitmap* bmp = imgMap->Picture->Bitmap;
     TCanvas* canvas = bmp->Canvas;
@@ -698,7 +868,7 @@ void TMSEngine::PauseTime()
     if (EGameState::InProgress != m_GameState)
         return;
     m_Paused = true;
-    m_PauseTick = ::GetTickCount64();
+    m_PauseTime = m_Clock->NowMicroSecs();
 }
 //---------------------------------------------------------------------------
 void TMSEngine::PopulateMineField(size_t mouseRow, size_t mouseCol)
@@ -727,6 +897,9 @@ void TMSEngine::PopulateMineField(size_t mouseRow, size_t mouseCol)
     if (chance < 1)
         chance = 1;
 
+    m_MineCoords.clear();
+    m_MineCoords.reserve(static_cast<size_t>(m_NumMines));
+
     do
     {
         int rowDirection = ((std::rand() % 100) < 50) ? 1 : -1;
@@ -755,6 +928,7 @@ void TMSEngine::PopulateMineField(size_t mouseRow, size_t mouseCol)
 
                 mineCount++;
                 cell->IsMine = true;
+                m_MineCoords.push_back(TGridCoord(static_cast<size_t>(row), static_cast<size_t>(col)));
             }
         }
 
@@ -769,6 +943,97 @@ void TMSEngine::PopulateMineField(size_t mouseRow, size_t mouseCol)
         m_NumMines = mineCount; // Unexpected unless the mine count to total cells ratio is too high (like 999/1000)
 }
 //---------------------------------------------------------------------------
+// Sizes the image's bitmap to the whole map as pf32bit, and points 'frameBuffer' at its scan lines. The scan line
+// addresses are taken here, on the calling thread, so drawing into them needs no GDI calls.
+void TMSEngine::AttachFrameBuffer(TImage* image, TFrameBuffer& frameBuffer)
+{
+    Graphics::TBitmap* bmp = image->Picture->Bitmap;
+    int const width = GetDrawWidth();
+    int const height = GetDrawHeight();
+
+    if (pf32bit != bmp->PixelFormat)
+        bmp->PixelFormat = pf32bit;
+    if (bmp->Width != width || bmp->Height != height)
+        bmp->SetSize(width, height);
+
+    if (width <= 0 || height <= 0)
+    {
+        frameBuffer.Clear();
+        return;
+    }
+
+    uint32_t* firstRow = static_cast<uint32_t*>(bmp->ScanLine[0]);
+    ptrdiff_t const stride = (height > 1) ? static_cast<uint32_t*>(bmp->ScanLine[1]) - firstRow : width;
+
+    frameBuffer.Attach(firstRow, width, height, stride);
+}
+//---------------------------------------------------------------------------
+// Full redraw: every cell is drawn in parallel bands straight into the image bitmap's pf32bit scan lines, so no
+// second copy of the board is kept. The sprites' portable pixel copies are used so that the workers never touch
+// VCL/GDI objects.
+void TMSEngine::RasterizeMap(TImage* image, TShiftState shift, int mouseX, int mouseY)
+{
+    m_FullRedrawPending = false;
+
+    size_t mouseRow;
+    size_t mouseCol;
+    GridCoordsFromMouse(&mouseCol, &mouseRow, mouseX, mouseY);
+
+    int const cellWidth = GetCellDrawWidth();
+    int const cellHeight = GetCellDrawHeight();
+
+    // TColor to a pf32bit pixel (0x00BBGGRR to 0xAARRGGBB)
+    uint32_t const frameRGB = static_cast<uint32_t>(ColorToRGB(TColor(FrameColor)));
+    uint32_t const framePixel =
+        0xFF000000 | ((frameRGB & 0xFF) << 16) | (frameRGB & 0xFF00) | ((frameRGB >> 16) & 0xFF);
+
+    TFrameBuffer target;
+    AttachFrameBuffer(image, target);
+
+    m_Rasterizer.Rasterize(target, Grid->GetRowCount(), Grid->GetColCount(), cellWidth, cellHeight,
+        [this, shift, mouseRow, mouseCol, cellWidth, cellHeight, framePixel](
+            TFrameBuffer& frameBuffer, size_t row, size_t col, int xPos, int yPos)
+        {
+            TCellLayers layers;
+            GetCellLayers(&layers, row, col, shift, mouseRow, mouseCol);
+            Grid->GetCell(row, col)->LastDrawHash = layers.DrawHash;
+
+            // Other bands are drawn at the same time, so a sprite bigger than the cell must not spill out of it
+            TFrameBuffer::TClipRect const cellRect(xPos, yPos, xPos + cellWidth, yPos + cellHeight);
+
+            frameBuffer.Blit(layers.Tile->GetPixels(), xPos, yPos, cellRect);
+
+            if (nullptr != layers.Mine)
+                frameBuffer.BlitTransparent(layers.Mine->GetPixels(), xPos, yPos, cellRect);
+            else if (nullptr != layers.Prox)
+                frameBuffer.BlitTransparent(layers.Prox->GetPixels(), xPos, yPos, cellRect);
+
+            if (nullptr != layers.Flag)
+                frameBuffer.BlitTransparent(layers.Flag->GetPixels(), xPos, yPos, cellRect);
+
+            if (nullptr != layers.FlagX)
+                frameBuffer.BlitTransparent(layers.FlagX->GetPixels(), xPos, yPos, cellRect);
+
+            frameBuffer.FrameRect(xPos, yPos, xPos + cellWidth - 1, yPos + cellHeight - 1, framePixel);
+        });
+
+    // Scan line writes don't raise OnChange, so let the image know to repaint
+    image->Picture->Bitmap->Modified = true;
+}
+//---------------------------------------------------------------------------
+void TMSEngine::RemoveFlag(size_t row, size_t col)
+{
+    Grid->GetCell(row, col)->MarkedAsMine = false;
+
+    TGrid::TCoordList::iterator it = std::find(m_FlagCoords.begin(), m_FlagCoords.end(), TGridCoord(row, col));
+    if (it == m_FlagCoords.end())
+        return;
+
+    // Order doesn't matter - swap with the last item to avoid shifting the list
+    *it = m_FlagCoords.back();
+    m_FlagCoords.pop_back();
+}
+//---------------------------------------------------------------------------
 void TMSEngine::ResumeTime()
 {
     if (!m_Paused)
@@ -777,20 +1042,21 @@ void TMSEngine::ResumeTime()
 
     if (EGameState::InProgress != m_GameState)
         return;
-    ULONGLONG currentTick = ::GetTickCount64();
-    m_StartTick += currentTick - m_PauseTick;
+    int64_t currentTime = m_Clock->NowMicroSecs();
+    m_StartTime += currentTime - m_PauseTime;
 }
 //---------------------------------------------------------------------------
+// Mines and wrongly flagged cells are shown as revealed by IsRevealed() once the game is lost, so no cells are written
+// here. Only the cells from the mine and flag indexes are drawn by the next DrawMap().
 void TMSEngine::RevealAll()
 {
-    for (size_t row = 0, nRows = Grid->GetRowCount(); row < nRows; row++)
-    {
-        for (size_t col = 0, nCols = Grid->GetColCount(); col < nCols; col++)
-        {
-            TCell* cell = Grid->GetCell(row, col);
-            cell->Discovered = true;
-        }
-    }
+    m_GameOverDrawPending = true;
+}
+//---------------------------------------------------------------------------
+// Passing null restores the default clock. The engine does not take ownership of 'clock'.
+void TMSEngine::SetClock(TClock* clock)
+{
+    m_Clock = (nullptr == clock ? &m_DefaultClock : clock);
 }
 //---------------------------------------------------------------------------
 void TMSEngine::SetUseQuestionMarks(bool useQuestionMarks)
@@ -798,5 +1064,32 @@ void TMSEngine::SetUseQuestionMarks(bool useQuestionMarks)
     m_UseQuestionMarks = useQuestionMarks;
 }
 //---------------------------------------------------------------------------
+// Switches to pre-scaled sprites, so nothing is resampled while drawing. The map image is resized to match and
+// redrawn in full by the next DrawMap(). Returns false if 'zoomLevel' was already current.
+bool TMSEngine::SetZoomLevel(size_t zoomLevel, TImage* imgMap)
+{
+    zoomLevel = std::min(zoomLevel, TSprites::NumZoomLevels - 1);
+    if (zoomLevel == m_ZoomLevel)
+        return false;
+
+    m_ZoomLevel = zoomLevel;
+    m_FullRedrawPending = true;
+
+    if (nullptr != Grid)
+    {
+        Graphics::TBitmap* bmp = imgMap->Picture->Bitmap;
+        bmp->SetSize(GetDrawWidth(), GetDrawHeight());
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// Only the listed cells are looked at, so the cost follows the size of the move rather than the board.
+void TMSEngine::UpdateMinimap(TGrid::TCoordList const& coords)
+{
+    for (TGrid::TCoordList::const_iterator it = coords.begin(); it != coords.end(); it++)
+        m_Minimap.SetCell(it->Row, it->Col, GetMinimapCell(it->Row, it->Col));
+}
+//---------------------------------------------------------------------------
 
 } // namespace ASWMS
@@ -27,8 +27,13 @@ limitations under the License.
 #include <Vcl.ExtCtrls.hpp>
 //---------------------------------------------------------------------------
 #include "ASWMS_Cell.h"
+#include "ASWMS_Clock.h"
+#include "ASWMS_FrameBuffer.h"
 #include "ASWMS_Grid.h"
+#include "ASWMS_Minimap.h"
+#include "ASWMS_Scoreboard.h"
 #include "ASWMS_Sprites.h"
+#include "ASWMS_TileRasterizer.h"
 //---------------------------------------------------------------------------
 
 namespace ASWMS
@@ -54,7 +59,29 @@ private: // Static vars
     static int const NumDigits_MinesRemaining = 4;
     static int const NumDigits_Time = 4;
     static size_t const GridCoord_NotSet = static_cast<size_t>(-1);
-    static ULONGLONG const Tick_NotSet = 0;
+    static int64_t const Time_NotSet = INT64_MIN;
+
+private:
+    // Sprites making up one cell, bottom layer first
+    struct TCellLayers
+    {
+        TSprite* Tile;
+        TSprite* Mine;
+        TSprite* Prox;
+        TSprite* Flag;
+        TSprite* FlagX;
+        uint32_t DrawHash;
+
+        TCellLayers()
+            : Tile(nullptr),
+              Mine(nullptr),
+              Prox(nullptr),
+              Flag(nullptr),
+              FlagX(nullptr),
+              DrawHash(0)
+        {
+        }
+    };
 
 public: // Static vars
     static size_t const BeginnerRows = 8;
@@ -75,48 +102,80 @@ private:
     TShiftState m_MouseDown_Shift;
     int m_MouseDown_X;
     int m_MouseDown_Y;
+    int m_LastDrawMouseX;
+    int m_LastDrawMouseY;
     int m_NumMines;
-    int m_NumFlaggedMines;
     size_t m_BoomRow;
     size_t m_BoomCol;
-    ULONGLONG m_StartTick;
-    ULONGLONG m_PauseTick;
+    int64_t m_StartTime; // Microseconds, from m_Clock
+    int64_t m_PauseTime; // Microseconds, from m_Clock
+    TSteadyClock m_DefaultClock;
+    TClock* m_Clock;
+    bool m_GameOverDrawPending;
+    TScoreboard m_ScoreboardTime;
+    TScoreboard m_ScoreboardMinesRemaining;
+    bool m_FullRedrawPending; // Next DrawMap() redraws every cell, through m_Rasterizer
+    TTileRasterizer m_Rasterizer;
+    size_t m_ZoomLevel; // Index into TSprites::ZoomPercents
+    TMinimap m_Minimap;
+
+    // Compact cell indexes, so that game over and partial redraws don't need to scan the whole grid
+    TGrid::TCoordList m_MineCoords; // Built during mine placement
+    TGrid::TCoordList m_FlagCoords; // Cells currently flagged as a mine
+    TGrid::TCoordList m_ChangedCoords; // Cells discovered or marked during the current click
 
 public:
     TGrid* Grid;
     TSprites Sprites;
 
 private:
+    void AddFlag(size_t row, size_t col);
+    void AttachFrameBuffer(TImage* image, TFrameBuffer& frameBuffer);
     void AutoClickNeighboringCells(size_t row, size_t col);
     void AutoDiscoverNeighboringCells(TShiftState shift, size_t row, size_t col);
     void CheckForAndSetWin();
     void ClickNeighboringCells(TShiftState shift, size_t row, size_t col);
     void DoClick(TShiftState shift, size_t row, size_t col);
     void DrawCell(TImage* image, size_t row, size_t col, int xPos, int yPos, TShiftState shift, int mouseX, int mouseY);
-    void DrawDigits(TImage* image, int value, size_t maxDigits);
+    void DrawCell(TImage* image, size_t row, size_t col, TShiftState shift, int mouseX, int mouseY);
+    void DrawCells(TImage* image, TGrid::TCoordList const& coords);
+    void DrawGameOver(TImage* image);
+    void DrawNeighborhood(TImage* image, int mouseX, int mouseY);
     int GetCellDrawHeight();
     int GetCellDrawWidth();
+    void GetCellLayers(TCellLayers* layers, size_t row, size_t col, TShiftState shift, size_t mouseRow,
+        size_t mouseCol);
     int GetDrawHeight();
     int GetDrawHeight_MinesRemaining();
     int GetDrawHeight_Time();
     int GetDrawWidth();
     int GetDrawWidth_MinesRemaining();
     int GetDrawWidth_Time();
+    TSprites::TMapSprites& GetMapSprites();
+    TMinimap::ECell GetMinimapCell(size_t row, size_t col) const;
     int GetNeighboringFlagCount(size_t row, size_t col) const;
     int GetNeighboringMineCount(size_t row, size_t col) const;
     void GridCoordsFromMouse(size_t* col, size_t* row, int x, int y);
+    bool IsRevealed(TCell const* cell) const;
     void PopulateMineField(size_t mouseRow, size_t mouseCol);
+    void RasterizeMap(TImage* image, TShiftState shift, int mouseX, int mouseY);
+    void RemoveFlag(size_t row, size_t col);
     void RevealAll();
-
-public:
-    static std::vector<int> ExtractDigits(int value, bool reverseOrder);
+    void UpdateMinimap(TGrid::TCoordList const& coords);
 
 public: // Getters/Setters
+    TClock* GetClock();
     int GetEllapsedTimeMilliSecs();
+    int64_t GetEllapsedTimeMilliSecs64();
+    int64_t GetEllapsedTimeMicroSecs();
     EGameState GetGameState();
-    ULONGLONG GetStartedTick64() const;
+    int GetMilliSecsToNextSecond();
+    int64_t GetStartedTimeMicroSecs() const;
     bool GetUseQuestionMarks() const;
+    size_t GetZoomLevel() const;
+    void SetClock(TClock* clock);
     void SetUseQuestionMarks(bool useQuestionMarks);
+    bool SetZoomLevel(size_t zoomLevel, TImage* imgMap);
 
 public:
     TMSEngine();
@@ -124,10 +183,12 @@ public:
 
     void DrawMap(TImage* image, TShiftState shift, int mouseX, int mouseY);
     void DrawMap(TImage* image);
+    void DrawMinimap(TImage* image);
     void DrawMinesRemaining(TImage* image);
     void DrawTime(TImage* image);
     bool IsGameOver() const;
     bool IsGameRunning() const;
+    bool MinimapToMapPoint(int x, int y, int* mapX, int* mapY);
     void MouseDown(TShiftState shift, int x, int y);
     void MouseUp(TShiftState shift, int x, int y);
     void NewGame(size_t nRows, size_t nCols, int nMines, TImage* imgMap, TImage* imgTime,
@@ -0,0 +1,302 @@
+/* **************************************************************************
+ASWMS_FrameBuffer.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_FrameBuffer.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+//---------------------------------------------------------------------------
+TFrameBuffer::TFrameBuffer()
+    : m_Width(0),
+      m_Height(0),
+      m_FirstRow(nullptr),
+      m_Stride(0)
+{
+}
+//---------------------------------------------------------------------------
+TFrameBuffer::TFrameBuffer(int width, int height)
+    : m_Width(0),
+      m_Height(0),
+      m_FirstRow(nullptr),
+      m_Stride(0)
+{
+    Resize(width, height);
+}
+//---------------------------------------------------------------------------
+// The copy always owns its pixels, even if 'other' is attached.
+TFrameBuffer::TFrameBuffer(TFrameBuffer const& other)
+    : m_Width(0),
+      m_Height(0),
+      m_FirstRow(nullptr),
+      m_Stride(0)
+{
+    *this = other;
+}
+//---------------------------------------------------------------------------
+TFrameBuffer::TFrameBuffer(TFrameBuffer&& other) noexcept
+    : m_Width(0),
+      m_Height(0),
+      m_FirstRow(nullptr),
+      m_Stride(0)
+{
+    Swap(other);
+}
+//---------------------------------------------------------------------------
+TFrameBuffer::~TFrameBuffer()
+{
+}
+//---------------------------------------------------------------------------
+TFrameBuffer& TFrameBuffer::operator=(TFrameBuffer const& other)
+{
+    if (this == &other)
+        return *this;
+
+    Resize(other.m_Width, other.m_Height);
+
+    for (int y = 0; y < m_Height; y++)
+        std::memcpy(GetRow(y), other.GetRow(y), static_cast<size_t>(m_Width) * sizeof(uint32_t));
+
+    return *this;
+}
+//---------------------------------------------------------------------------
+TFrameBuffer& TFrameBuffer::operator=(TFrameBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Clear();
+        Swap(other);
+    }
+
+    return *this;
+}
+//---------------------------------------------------------------------------
+// Draws into 'width' x 'height' pixels owned by the caller, which must outlive the attachment. The buffer's own
+// pixels are released. 'stride' is in pixels and is negative for bottom-up memory, such as most DIBs. Resize() or
+// Clear() detach again.
+void TFrameBuffer::Attach(uint32_t* firstRow, int width, int height, ptrdiff_t stride)
+{
+    Clear();
+
+    if (nullptr == firstRow || width <= 0 || height <= 0)
+        return;
+
+    m_Width = width;
+    m_Height = height;
+    m_FirstRow = firstRow;
+    m_Stride = stride;
+}
+//---------------------------------------------------------------------------
+// Copies 'src' with its top left corner at (x, y), clipped to this buffer.
+void TFrameBuffer::Blit(TFrameBuffer const& src, int x, int y)
+{
+    Blit(src, x, y, TClipRect(0, 0, m_Width, m_Height));
+}
+//---------------------------------------------------------------------------
+// As above, but nothing outside 'clip' is written. Parallel drawers pass the area they own, so a source larger
+// than its cell can't spill into another thread's pixels.
+void TFrameBuffer::Blit(TFrameBuffer const& src, int x, int y, TClipRect const& clip)
+{
+    int srcX;
+    int srcY;
+    int width;
+    int height;
+    if (!ClipBlit(src, x, y, clip, &srcX, &srcY, &width, &height))
+        return;
+
+    for (int row = 0; row < height; row++)
+    {
+        uint32_t const* srcRow = src.GetRow(srcY + row) + srcX;
+        uint32_t* destRow = GetRow(y + srcY + row) + x + srcX;
+        std::memcpy(destRow, srcRow, static_cast<size_t>(width) * sizeof(uint32_t));
+    }
+}
+//---------------------------------------------------------------------------
+// As Blit(), but skips the pixels matching the source's transparent color (see GetTransparentColor()).
+void TFrameBuffer::BlitTransparent(TFrameBuffer const& src, int x, int y)
+{
+    BlitTransparent(src, x, y, TClipRect(0, 0, m_Width, m_Height));
+}
+//---------------------------------------------------------------------------
+void TFrameBuffer::BlitTransparent(TFrameBuffer const& src, int x, int y, TClipRect const& clip)
+{
+    int srcX;
+    int srcY;
+    int width;
+    int height;
+    if (!ClipBlit(src, x, y, clip, &srcX, &srcY, &width, &height))
+        return;
+
+    uint32_t const transparent = src.GetTransparentColor() & RGBMask;
+
+    for (int row = 0; row < height; row++)
+    {
+        uint32_t const* srcRow = src.GetRow(srcY + row) + srcX;
+        uint32_t* destRow = GetRow(y + srcY + row) + x + srcX;
+
+        for (int col = 0; col < width; col++)
+        {
+            uint32_t const pixel = srcRow[col];
+            if ((pixel & RGBMask) != transparent)
+                destRow[col] = pixel;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// The part of 'src' that lands inside both 'clip' and this buffer when drawn at (x, y). False if none does.
+bool TFrameBuffer::ClipBlit(TFrameBuffer const& src, int x, int y, TClipRect const& clip, int* srcX, int* srcY,
+    int* width, int* height) const
+{
+    int const left = std::max(std::max(clip.Left, 0), x);
+    int const top = std::max(std::max(clip.Top, 0), y);
+    int const right = std::min(std::min(clip.Right, m_Width), x + src.m_Width);
+    int const bottom = std::min(std::min(clip.Bottom, m_Height), y + src.m_Height);
+
+    if (left >= right || top >= bottom)
+        return false;
+
+    *srcX = left - x;
+    *srcY = top - y;
+    *width = right - left;
+    *height = bottom - top;
+    return true;
+}
+//---------------------------------------------------------------------------
+// Releases the pixel memory, or detaches.
+void TFrameBuffer::Clear()
+{
+    m_Width = 0;
+    m_Height = 0;
+    m_FirstRow = nullptr;
+    m_Stride = 0;
+    std::vector<uint32_t>().swap(m_Pixels);
+}
+//---------------------------------------------------------------------------
+void TFrameBuffer::Fill(uint32_t color)
+{
+    for (int y = 0; y < m_Height; y++)
+    {
+        uint32_t* row = GetRow(y);
+        std::fill(row, row + m_Width, color);
+    }
+}
+//---------------------------------------------------------------------------
+// One pixel border, with the same exclusive right/bottom edges as the Windows FrameRect().
+void TFrameBuffer::FrameRect(int left, int top, int right, int bottom, uint32_t color)
+{
+    int const firstCol = std::max(left, 0);
+    int const firstRow = std::max(top, 0);
+    int const lastCol = std::min(right, m_Width) - 1;
+    int const lastRow = std::min(bottom, m_Height) - 1;
+
+    if (firstCol > lastCol || firstRow > lastRow)
+        return;
+
+    // Edges that were clipped away aren't drawn
+    bool const hasLeft = (left == firstCol);
+    bool const hasTop = (top == firstRow);
+    bool const hasRight = (right - 1 == lastCol);
+    bool const hasBottom = (bottom - 1 == lastRow);
+
+    for (int y = firstRow; y <= lastRow; y++)
+    {
+        uint32_t* row = GetRow(y);
+
+        if ((hasTop && y == firstRow) || (hasBottom && y == lastRow))
+        {
+            std::fill(row + firstCol, row + lastCol + 1, color);
+        }
+        else
+        {
+            if (hasLeft)
+                row[firstCol] = color;
+            if (hasRight)
+                row[lastCol] = color;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+int TFrameBuffer::GetHeight() const
+{
+    return m_Height;
+}
+//---------------------------------------------------------------------------
+uint32_t const* TFrameBuffer::GetRow(int y) const
+{
+    return m_FirstRow + static_cast<ptrdiff_t>(y) * m_Stride;
+}
+//---------------------------------------------------------------------------
+uint32_t* TFrameBuffer::GetRow(int y)
+{
+    return m_FirstRow + static_cast<ptrdiff_t>(y) * m_Stride;
+}
+//---------------------------------------------------------------------------
+// The bottom left pixel, as VCL uses for bitmaps drawn with Transparent set.
+uint32_t TFrameBuffer::GetTransparentColor() const
+{
+    if (IsEmpty())
+        return 0;
+    return GetRow(m_Height - 1)[0];
+}
+//---------------------------------------------------------------------------
+int TFrameBuffer::GetWidth() const
+{
+    return m_Width;
+}
+//---------------------------------------------------------------------------
+bool TFrameBuffer::IsEmpty() const
+{
+    return 0 == m_Width || 0 == m_Height;
+}
+//---------------------------------------------------------------------------
+// Keeps the allocation when shrinking, so redraws of the same board don't reallocate. Contents are undefined after.
+// Detaches first if attached.
+void TFrameBuffer::Resize(int width, int height)
+{
+    if (width < 0)
+        width = 0;
+    if (height < 0)
+        height = 0;
+
+    m_Width = width;
+    m_Height = height;
+    m_Pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    m_FirstRow = m_Pixels.empty() ? nullptr : &m_Pixels[0];
+    m_Stride = width;
+}
+//---------------------------------------------------------------------------
+// Exchanges pixels without copying them.
+void TFrameBuffer::Swap(TFrameBuffer& other)
+{
+    std::swap(m_Width, other.m_Width);
+    std::swap(m_Height, other.m_Height);
+    m_Pixels.swap(other.m_Pixels); // Owned rows keep their address
+    std::swap(m_FirstRow, other.m_FirstRow);
+    std::swap(m_Stride, other.m_Stride);
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
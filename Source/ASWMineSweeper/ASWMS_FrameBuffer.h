@@ -0,0 +1,109 @@
+/* **************************************************************************
+ASWMS_FrameBuffer.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_FrameBufferH
+#define ASWMS_FrameBufferH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TFrameBuffer
+//
+// Portable 32-bit pixel buffer, top row first. Pixels are laid out like a
+// pf32bit DIB (B, G, R, A in memory, 0xAARRGGBB as a uint32_t), so rows copy
+// straight to and from a bitmap's scan lines. Also used to hold sprite
+// pixels, so drawing needs no GDI calls and can run on any thread.
+// Attach() draws into memory owned elsewhere, such as a DIB's scan lines,
+// instead of the buffer's own pixels.
+/////////////////////////////////////////////////////////////////////////////
+class TFrameBuffer
+{
+public: // Static vars
+    static uint32_t const RGBMask = 0x00FFFFFF;
+
+public:
+    // Area a blit may write to. Right and bottom are exclusive.
+    struct TClipRect
+    {
+        int Left;
+        int Top;
+        int Right;
+        int Bottom;
+
+        TClipRect(int left, int top, int right, int bottom)
+            : Left(left),
+              Top(top),
+              Right(right),
+              Bottom(bottom)
+        {
+        }
+    };
+
+private:
+    int m_Width;
+    int m_Height;
+    std::vector<uint32_t> m_Pixels; // Empty while attached
+    uint32_t* m_FirstRow;
+    ptrdiff_t m_Stride; // Pixels from one row to the next, negative for bottom-up memory
+
+private:
+    bool ClipBlit(TFrameBuffer const& src, int x, int y, TClipRect const& clip, int* srcX, int* srcY, int* width,
+        int* height) const;
+
+public: // Getters/Setters
+    int GetHeight() const;
+    uint32_t const* GetRow(int y) const;
+    uint32_t* GetRow(int y);
+    uint32_t GetTransparentColor() const;
+    int GetWidth() const;
+
+public:
+    TFrameBuffer();
+    TFrameBuffer(int width, int height);
+    TFrameBuffer(TFrameBuffer const& other);
+    TFrameBuffer(TFrameBuffer&& other) noexcept;
+    ~TFrameBuffer();
+
+    TFrameBuffer& operator=(TFrameBuffer const& other);
+    TFrameBuffer& operator=(TFrameBuffer&& other) noexcept;
+
+    void Attach(uint32_t* firstRow, int width, int height, ptrdiff_t stride);
+    void Blit(TFrameBuffer const& src, int x, int y);
+    void Blit(TFrameBuffer const& src, int x, int y, TClipRect const& clip);
+    void BlitTransparent(TFrameBuffer const& src, int x, int y);
+    void BlitTransparent(TFrameBuffer const& src, int x, int y, TClipRect const& clip);
+    void Clear();
+    void Fill(uint32_t color);
+    void FrameRect(int left, int top, int right, int bottom, uint32_t color);
+    bool IsEmpty() const;
+    void Resize(int width, int height);
+    void Swap(TFrameBuffer& other);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_FrameBufferH
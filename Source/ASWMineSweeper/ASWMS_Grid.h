@@ -29,6 +29,32 @@ limitations under the License.
 namespace ASWMS
 {
 
+/////////////////////////////////////////////////////////////////////////////
+// TGridCoord
+/////////////////////////////////////////////////////////////////////////////
+struct TGridCoord
+{
+    size_t Row;
+    size_t Col;
+
+    TGridCoord()
+        : Row(0),
+          Col(0)
+    {
+    }
+    TGridCoord(size_t row, size_t col)
+        : Row(row),
+          Col(col)
+    {
+    }
+
+    bool operator==(TGridCoord const& rhs) const
+    {
+        return Row == rhs.Row && Col == rhs.Col;
+    }
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TGrid
 /////////////////////////////////////////////////////////////////////////////
@@ -37,6 +63,7 @@ class TGrid
 public:
     typedef std::vector<TCell> TRow;
     typedef std::vector<TRow> TRows;
+    typedef std::vector<TGridCoord> TCoordList;
 
 public:
     TRows* Rows;
@@ -0,0 +1,212 @@
+/* **************************************************************************
+ASWMS_Minimap.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_Minimap.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <climits>
+#include <cstring>
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TMinimap
+/////////////////////////////////////////////////////////////////////////////
+
+// Indexed by ECell (pf32bit, 0xAARRGGBB)
+uint32_t const TMinimap::CellColors[TMinimap::NumCellStates] =
+{
+    0xFF7A8899, // Covered
+    0xFFD8D8D8, // Revealed
+    0xFFFF8C00, // Flagged
+    0xFFE02020, // Mine
+};
+
+//---------------------------------------------------------------------------
+TMinimap::TMinimap()
+    : m_Rows(0),
+      m_Cols(0),
+      m_BlockSize(1)
+{
+    ClearDirty();
+}
+//---------------------------------------------------------------------------
+TMinimap::~TMinimap()
+{
+}
+//---------------------------------------------------------------------------
+// The cell at the center of the block under minimap point x, y. False if the point is outside the minimap.
+bool TMinimap::CellFromPoint(int x, int y, size_t* row, size_t* col) const
+{
+    if (x < 0 || y < 0 || x >= GetWidth() || y >= GetHeight())
+        return false;
+
+    *row = std::min(m_Rows - 1, static_cast<size_t>(y) * m_BlockSize + m_BlockSize / 2);
+    *col = std::min(m_Cols - 1, static_cast<size_t>(x) * m_BlockSize + m_BlockSize / 2);
+    return true;
+}
+//---------------------------------------------------------------------------
+void TMinimap::ClearDirty()
+{
+    m_DirtyLeft = m_DirtyTop = INT_MAX;
+    m_DirtyRight = m_DirtyBottom = -1;
+}
+//---------------------------------------------------------------------------
+// Copies the pixels changed since the last call into the image's bitmap. The whole minimap is copied if the bitmap
+// isn't already the right size.
+void TMinimap::Draw(TImage* image)
+{
+    Graphics::TBitmap* bmp = image->Picture->Bitmap;
+    int const width = m_Pixels.GetWidth();
+    int const height = m_Pixels.GetHeight();
+
+    if (pf32bit != bmp->PixelFormat || bmp->Width != width || bmp->Height != height)
+    {
+        bmp->PixelFormat = pf32bit;
+        bmp->SetSize(width, height);
+        m_DirtyLeft = m_DirtyTop = 0;
+        m_DirtyRight = width - 1;
+        m_DirtyBottom = height - 1;
+    }
+
+    if (m_DirtyLeft > m_DirtyRight || m_DirtyTop > m_DirtyBottom)
+        return;
+
+    size_t const spanBytes = static_cast<size_t>(m_DirtyRight - m_DirtyLeft + 1) * sizeof(uint32_t);
+    for (int y = m_DirtyTop; y <= m_DirtyBottom; y++)
+    {
+        uint32_t* dest = static_cast<uint32_t*>(bmp->ScanLine[y]);
+        std::memcpy(dest + m_DirtyLeft, m_Pixels.GetRow(y) + m_DirtyLeft, spanBytes);
+    }
+
+    ClearDirty();
+
+    // Scan line writes don't raise OnChange, so let the image know to repaint
+    bmp->Modified = true;
+}
+//---------------------------------------------------------------------------
+size_t TMinimap::GetBlockSize() const
+{
+    return m_BlockSize;
+}
+//---------------------------------------------------------------------------
+int TMinimap::GetHeight() const
+{
+    return m_Pixels.GetHeight();
+}
+//---------------------------------------------------------------------------
+int TMinimap::GetWidth() const
+{
+    return m_Pixels.GetWidth();
+}
+//---------------------------------------------------------------------------
+// Blends the block's cell colors by how many cells are in each state.
+void TMinimap::PaintBlock(int x, int y)
+{
+    TBlock const& block = m_Blocks[static_cast<size_t>(y) * static_cast<size_t>(GetWidth()) + static_cast<size_t>(x)];
+
+    uint32_t total = 0;
+    uint32_t r = 0;
+    uint32_t g = 0;
+    uint32_t b = 0;
+
+    for (size_t i = 0; i < NumCellStates; i++)
+    {
+        uint32_t const count = block.Counts[i];
+        uint32_t const color = CellColors[i];
+        total += count;
+        r += ((color >> 16) & 0xFF) * count;
+        g += ((color >> 8) & 0xFF) * count;
+        b += (color & 0xFF) * count;
+    }
+
+    if (0 == total)
+        return;
+
+    m_Pixels.GetRow(y)[x] = 0xFF000000 | ((r / total) << 16) | ((g / total) << 8) | (b / total);
+
+    m_DirtyLeft = std::min(m_DirtyLeft, x);
+    m_DirtyTop = std::min(m_DirtyTop, y);
+    m_DirtyRight = std::max(m_DirtyRight, x);
+    m_DirtyBottom = std::max(m_DirtyBottom, y);
+}
+//---------------------------------------------------------------------------
+// Starts a new board with every cell covered. This is the only full pass; everything after it is per cell.
+void TMinimap::Reset(size_t nRows, size_t nCols)
+{
+    m_Rows = nRows;
+    m_Cols = nCols;
+
+    // Smallest block that fits the board in MaxSize
+    size_t const longest = std::max(nRows, nCols);
+    m_BlockSize = std::max<size_t>(1, (longest + MaxSize - 1) / MaxSize);
+
+    int const width = static_cast<int>((nCols + m_BlockSize - 1) / m_BlockSize);
+    int const height = static_cast<int>((nRows + m_BlockSize - 1) / m_BlockSize);
+
+    m_Cells.assign(nRows * nCols, static_cast<uint8_t>(ECell::Covered));
+    m_Blocks.assign(static_cast<size_t>(width) * static_cast<size_t>(height), TBlock());
+    m_Pixels.Resize(width, height);
+    m_Pixels.Fill(CellColors[static_cast<size_t>(ECell::Covered)]);
+
+    // Edge blocks can be partial, so count their cells rather than assuming m_BlockSize squared
+    for (int y = 0; y < height; y++)
+    {
+        size_t const blockRows = std::min(m_BlockSize, nRows - static_cast<size_t>(y) * m_BlockSize);
+
+        for (int x = 0; x < width; x++)
+        {
+            size_t const blockCols = std::min(m_BlockSize, nCols - static_cast<size_t>(x) * m_BlockSize);
+            TBlock& block = m_Blocks[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)];
+            block.Counts[static_cast<size_t>(ECell::Covered)] = static_cast<uint32_t>(blockRows * blockCols);
+        }
+    }
+
+    m_DirtyLeft = m_DirtyTop = 0;
+    m_DirtyRight = width - 1;
+    m_DirtyBottom = height - 1;
+}
+//---------------------------------------------------------------------------
+void TMinimap::SetCell(size_t row, size_t col, ECell state)
+{
+    if (row >= m_Rows || col >= m_Cols)
+        return;
+
+    uint8_t& cell = m_Cells[row * m_Cols + col];
+    if (static_cast<uint8_t>(state) == cell)
+        return;
+
+    int const x = static_cast<int>(col / m_BlockSize);
+    int const y = static_cast<int>(row / m_BlockSize);
+    TBlock& block = m_Blocks[static_cast<size_t>(y) * static_cast<size_t>(GetWidth()) + static_cast<size_t>(x)];
+
+    block.Counts[cell]--;
+    block.Counts[static_cast<size_t>(state)]++;
+    cell = static_cast<uint8_t>(state);
+
+    PaintBlock(x, y);
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
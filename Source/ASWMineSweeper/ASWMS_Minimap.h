@@ -0,0 +1,103 @@
+/* **************************************************************************
+ASWMS_Minimap.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_MinimapH
+#define ASWMS_MinimapH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+//---------------------------------------------------------------------------
+#include <Vcl.ExtCtrls.hpp>
+//---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TMinimap
+//
+// Overview of the whole board at one pixel per block of cells, where a block
+// is 1x1 unless the board is larger than MaxSize cells across. A block's
+// color is the mix of its cells' states, kept as per-state counts, so a
+// changed cell costs one counter update and one pixel, whatever the board
+// size. Draw() only copies the rows and columns that changed.
+/////////////////////////////////////////////////////////////////////////////
+class TMinimap
+{
+public:
+    enum class ECell : uint8_t
+    {
+        Covered,
+        Revealed,
+        Flagged,
+        Mine,
+    };
+
+public: // Static vars
+    static int const MaxSize = 256; // Longest side, in pixels
+    static size_t const NumCellStates = 4;
+
+private: // Static vars
+    static uint32_t const CellColors[NumCellStates];
+
+private:
+    struct TBlock
+    {
+        uint32_t Counts[NumCellStates]; // Cells in each state, indexed by ECell
+    };
+
+private:
+    size_t m_Rows;
+    size_t m_Cols;
+    size_t m_BlockSize; // Cells per side of one minimap pixel
+    std::vector<uint8_t> m_Cells; // ECell of every cell, row major
+    std::vector<TBlock> m_Blocks; // One per pixel, row major
+    TFrameBuffer m_Pixels;
+    int m_DirtyLeft; // Pixels changed since the last Draw(), right/bottom inclusive. Empty if left > right.
+    int m_DirtyTop;
+    int m_DirtyRight;
+    int m_DirtyBottom;
+
+private:
+    void ClearDirty();
+    void PaintBlock(int x, int y);
+
+public: // Getters/Setters
+    size_t GetBlockSize() const;
+    int GetHeight() const;
+    int GetWidth() const;
+
+public:
+    TMinimap();
+    ~TMinimap();
+
+    bool CellFromPoint(int x, int y, size_t* row, size_t* col) const;
+    void Draw(TImage* image);
+    void Reset(size_t nRows, size_t nCols);
+    void SetCell(size_t row, size_t col, ECell state);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_MinimapH
@@ -0,0 +1,868 @@
+/* **************************************************************************
+ASWMS_PngDecoder.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_PngDecoder.h"
+//---------------------------------------------------------------------------
+#include <cstring>
+#include <vector>
+//---------------------------------------------------------------------------
+#include "ASWTools_Adler.h"
+//---------------------------------------------------------------------------
+using namespace ASWTools;
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+namespace
+{
+
+unsigned char const PngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Deflate length and distance codes (RFC 1951, 3.2.5)
+uint16_t const LengthBase[29] =
+{
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+uint8_t const LengthExtra[29] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+uint16_t const DistBase[30] =
+{
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+    6145, 8193, 12289, 16385, 24577,
+};
+uint8_t const DistExtra[30] =
+{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+// Order the code length code lengths are sent in
+uint8_t const CodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+//---------------------------------------------------------------------------
+uint32_t ReadU32BE(unsigned char const* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+        (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+//---------------------------------------------------------------------------
+bool IsChunk(unsigned char const* type, char const* name)
+{
+    return std::memcmp(type, name, 4) == 0;
+}
+//---------------------------------------------------------------------------
+// x / 255, rounded, for x up to 255 * 255
+unsigned int Div255(unsigned int x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+//---------------------------------------------------------------------------
+uint32_t Blend(unsigned int r, unsigned int g, unsigned int b, unsigned int a, uint32_t background)
+{
+    if (255 == a)
+        return 0xFF000000 | (r << 16) | (g << 8) | b;
+    if (0 == a)
+        return 0xFF000000 | background;
+
+    unsigned int const ia = 255 - a;
+    r = Div255(r * a + ((background >> 16) & 0xFF) * ia);
+    g = Div255(g * a + ((background >> 8) & 0xFF) * ia);
+    b = Div255(b * a + (background & 0xFF) * ia);
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TIdatReader
+//
+// Deflate bit reader (least significant bit first) over the data of
+// consecutive IDAT chunks, read in place - the chunks aren't joined.
+/////////////////////////////////////////////////////////////////////////////
+class TIdatReader
+{
+private:
+    unsigned char const* m_Data;
+    size_t m_Size;
+    size_t m_Pos; // Next byte of the current chunk
+    size_t m_ChunkEnd;
+    bool m_Exhausted;
+    uint64_t m_BitBuf;
+    unsigned int m_BitCount;
+    unsigned int m_PadBits; // Zero bits added after the last IDAT byte
+
+private:
+    bool NextChunk()
+    {
+        size_t const pos = m_ChunkEnd + 4; // Skip the CRC
+        if (pos > m_Size || m_Size - pos < 12 || !IsChunk(m_Data + pos + 4, "IDAT"))
+            return false;
+
+        uint32_t const len = ReadU32BE(m_Data + pos);
+        if (len > m_Size - pos - 12)
+            return false;
+
+        m_Pos = pos + 8;
+        m_ChunkEnd = m_Pos + len;
+        return true;
+    }
+
+    void Refill()
+    {
+        while (m_BitCount <= 56)
+        {
+            while (m_Pos == m_ChunkEnd && !m_Exhausted)
+                m_Exhausted = !NextChunk();
+
+            if (m_Exhausted)
+            {
+                // Past the end - pad with zeros. Overrun() reports if any get used.
+                m_PadBits += 8;
+                m_BitCount += 8;
+                continue;
+            }
+
+            m_BitBuf |= static_cast<uint64_t>(m_Data[m_Pos++]) << m_BitCount;
+            m_BitCount += 8;
+        }
+    }
+
+public:
+    TIdatReader(unsigned char const* data, size_t size, size_t firstDataPos, size_t firstDataLen)
+        : m_Data(data),
+          m_Size(size),
+          m_Pos(firstDataPos),
+          m_ChunkEnd(firstDataPos + firstDataLen),
+          m_Exhausted(false),
+          m_BitBuf(0),
+          m_BitCount(0),
+          m_PadBits(0)
+    {
+    }
+
+    void AlignToByte()
+    {
+        Drop(m_BitCount % 8);
+    }
+
+    uint32_t Bits(unsigned int n) // n <= 32
+    {
+        Ensure(n);
+        uint32_t const value = Peek(n);
+        Drop(n);
+        return value;
+    }
+
+    void Drop(unsigned int n)
+    {
+        m_BitBuf >>= n;
+        m_BitCount -= n;
+    }
+
+    void Ensure(unsigned int n)
+    {
+        if (m_BitCount < n)
+            Refill();
+    }
+
+    bool Overrun() const
+    {
+        return m_BitCount < m_PadBits;
+    }
+
+    uint32_t Peek(unsigned int n) const
+    {
+        return static_cast<uint32_t>(m_BitBuf & ((static_cast<uint64_t>(1) << n) - 1));
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// THuffman
+//
+// Canonical Huffman decoder. Codes up to FastBits long are a single table
+// lookup; longer ones are walked a bit at a time.
+/////////////////////////////////////////////////////////////////////////////
+class THuffman
+{
+public:
+    static unsigned int const MaxBits = 15;
+    static unsigned int const FastBits = 9;
+    static unsigned int const MaxSymbols = 288;
+
+private:
+    uint16_t m_Fast[1 << FastBits]; // (symbol << 4) | length, 0 if the code is longer than FastBits
+    uint16_t m_Count[MaxBits + 1];
+    uint16_t m_Symbol[MaxSymbols];
+
+public:
+    // False if the lengths describe more codes than fit (an incomplete set is allowed, as zlib does)
+    bool Build(uint8_t const* lengths, unsigned int numSymbols)
+    {
+        std::memset(m_Count, 0, sizeof(m_Count));
+        for (unsigned int i = 0; i < numSymbols; i++)
+            m_Count[lengths[i]]++;
+        m_Count[0] = 0;
+
+        int left = 1;
+        for (unsigned int len = 1; len <= MaxBits; len++)
+        {
+            left <<= 1;
+            left -= m_Count[len];
+            if (left < 0)
+                return false;
+        }
+
+        uint16_t offsets[MaxBits + 1];
+        offsets[1] = 0;
+        for (unsigned int len = 1; len < MaxBits; len++)
+            offsets[len + 1] = static_cast<uint16_t>(offsets[len] + m_Count[len]);
+
+        for (unsigned int i = 0; i < numSymbols; i++)
+        {
+            if (lengths[i] != 0)
+                m_Symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+        }
+
+        // Deflate sends codes most significant bit first, so the table is indexed by the reversed code
+        std::memset(m_Fast, 0, sizeof(m_Fast));
+        unsigned int code = 0;
+        unsigned int idx = 0;
+
+        for (unsigned int len = 1; len <= FastBits; len++)
+        {
+            for (unsigned int i = 0; i < m_Count[len]; i++, code++, idx++)
+            {
+                unsigned int reversed = 0;
+                for (unsigned int bit = 0; bit < len; bit++)
+                    reversed |= ((code >> bit) & 1) << (len - 1 - bit);
+
+                uint16_t const entry = static_cast<uint16_t>((m_Symbol[idx] << 4) | len);
+                for (unsigned int j = reversed; j < (1u << FastBits); j += 1u << len)
+                    m_Fast[j] = entry;
+            }
+            code <<= 1;
+        }
+
+        return true;
+    }
+
+    // The next symbol, or -1 for a code that isn't in the table
+    int Decode(TIdatReader& in) const
+    {
+        in.Ensure(MaxBits);
+
+        uint16_t const entry = m_Fast[in.Peek(FastBits)];
+        if (entry != 0)
+        {
+            in.Drop(entry & 15);
+            return entry >> 4;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+
+        for (unsigned int len = 1; len <= MaxBits; len++)
+        {
+            code |= static_cast<int>(in.Bits(1));
+            int const count = m_Count[len];
+            if (code - count < first)
+                return m_Symbol[index + (code - first)];
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+
+        return -1;
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TRowWriter
+//
+// Reverses the filter on each scan line once it has been inflated, and
+// writes it to the frame buffer.
+/////////////////////////////////////////////////////////////////////////////
+class TRowWriter
+{
+public:
+    TPngDecoder::THeader const& Header;
+    uint32_t Background;
+    uint32_t Palette[256]; // 0xAARRGGBB, straight alpha
+    unsigned int PaletteSize;
+    bool HasColorKey; // tRNS for grey and RGB
+    uint16_t KeyR; // Grey uses KeyR only
+    uint16_t KeyG;
+    uint16_t KeyB;
+
+private:
+    unsigned char const* m_Raw; // Inflated data, a filter type byte then Stride bytes per row
+    unsigned char* m_Rows; // Two unfiltered rows, previous and current
+    size_t m_Stride;
+    size_t m_BytesPerPixel; // For filtering - at least 1
+    uint32_t m_NextRow;
+    TFrameBuffer& m_Dest;
+    bool m_Error;
+
+private:
+    void Convert(unsigned char const* row, uint32_t* dest)
+    {
+        uint32_t const width = Header.Width;
+        unsigned int const depth = Header.BitDepth;
+
+        switch (Header.ColorType)
+        {
+        case 0: // Grey
+        case 3: // Palette
+        {
+            unsigned int const mask = (1u << depth) - 1;
+            unsigned int const scale = 255 / mask;
+
+            for (uint32_t x = 0; x < width; x++)
+            {
+                size_t const bit = static_cast<size_t>(x) * depth;
+                unsigned int const value = (row[bit / 8] >> (8 - depth - (bit % 8))) & mask;
+
+                if (3 == Header.ColorType)
+                {
+                    if (value >= PaletteSize)
+                    {
+                        m_Error = true;
+                        return;
+                    }
+                    uint32_t const color = Palette[value];
+                    dest[x] = Blend((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, color >> 24, Background);
+                }
+                else
+                {
+                    unsigned int const grey = value * scale;
+                    dest[x] = Blend(grey, grey, grey, HasColorKey && value == KeyR ? 0 : 255, Background);
+                }
+            }
+            break;
+        }
+        case 2: // RGB
+            for (uint32_t x = 0; x < width; x++, row += 3)
+            {
+                bool const keyed = HasColorKey && row[0] == KeyR && row[1] == KeyG && row[2] == KeyB;
+                dest[x] = Blend(row[0], row[1], row[2], keyed ? 0 : 255, Background);
+            }
+            break;
+        case 4: // Grey + alpha
+            for (uint32_t x = 0; x < width; x++, row += 2)
+                dest[x] = Blend(row[0], row[0], row[0], row[1], Background);
+            break;
+        case 6: // RGBA
+            for (uint32_t x = 0; x < width; x++, row += 4)
+                dest[x] = Blend(row[0], row[1], row[2], row[3], Background);
+            break;
+        }
+    }
+
+    bool Unfilter(unsigned char filterType, unsigned char const* src, unsigned char const* prev, unsigned char* cur)
+    {
+        size_t const stride = m_Stride;
+        size_t const bpp = m_BytesPerPixel;
+
+        switch (filterType)
+        {
+        case 0: // None
+            std::memcpy(cur, src, stride);
+            break;
+        case 1: // Sub
+            for (size_t i = 0; i < stride; i++)
+                cur[i] = static_cast<unsigned char>(src[i] + (i >= bpp ? cur[i - bpp] : 0));
+            break;
+        case 2: // Up
+            for (size_t i = 0; i < stride; i++)
+                cur[i] = static_cast<unsigned char>(src[i] + prev[i]);
+            break;
+        case 3: // Average
+            for (size_t i = 0; i < stride; i++)
+            {
+                unsigned int const left = i >= bpp ? cur[i - bpp] : 0;
+                cur[i] = static_cast<unsigned char>(src[i] + ((left + prev[i]) >> 1));
+            }
+            break;
+        case 4: // Paeth
+            for (size_t i = 0; i < stride; i++)
+            {
+                int const a = i >= bpp ? cur[i - bpp] : 0;
+                int const b = prev[i];
+                int const c = i >= bpp ? prev[i - bpp] : 0;
+                int const p = a + b - c;
+                int const pa = p > a ? p - a : a - p;
+                int const pb = p > b ? p - b : b - p;
+                int const pc = p > c ? p - c : c - p;
+                int const predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                cur[i] = static_cast<unsigned char>(src[i] + predictor);
+            }
+            break;
+        default:
+            return false;
+        }
+
+        return true;
+    }
+
+public:
+    TRowWriter(TPngDecoder::THeader const& header, TFrameBuffer& dest)
+        : Header(header),
+          Background(0),
+          PaletteSize(0),
+          HasColorKey(false),
+          KeyR(0),
+          KeyG(0),
+          KeyB(0),
+          m_Raw(nullptr),
+          m_Rows(nullptr),
+          m_Stride(0),
+          m_BytesPerPixel(1),
+          m_NextRow(0),
+          m_Dest(dest),
+          m_Error(false)
+    {
+    }
+
+    // Processes every row that has been fully inflated into the first 'available' bytes
+    void Flush(size_t available)
+    {
+        while (!m_Error && m_NextRow < Header.Height &&
+            (static_cast<size_t>(m_NextRow) + 1) * (m_Stride + 1) <= available)
+        {
+            unsigned char const* raw = m_Raw + static_cast<size_t>(m_NextRow) * (m_Stride + 1);
+            unsigned char* cur = m_Rows + (m_NextRow & 1) * m_Stride;
+            unsigned char const* prev = m_Rows + ((m_NextRow + 1) & 1) * m_Stride;
+
+            if (!Unfilter(raw[0], raw + 1, prev, cur))
+            {
+                m_Error = true;
+                return;
+            }
+
+            Convert(cur, m_Dest.GetRow(static_cast<int>(m_NextRow)));
+            m_NextRow++;
+        }
+    }
+
+    bool IsComplete() const
+    {
+        return !m_Error && m_NextRow == Header.Height;
+    }
+
+    // 'rows' must hold 2 * stride bytes
+    void Start(unsigned char const* raw, unsigned char* rows, size_t stride, size_t bytesPerPixel)
+    {
+        m_Raw = raw;
+        m_Rows = rows;
+        m_Stride = stride;
+        m_BytesPerPixel = bytesPerPixel;
+        m_NextRow = 0;
+        std::memset(rows, 0, 2 * stride); // The row above the first is all zeros
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Inflate
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+bool InflateCodes(TIdatReader& in, THuffman const& lit, THuffman const& dist, unsigned char* out, size_t outSize,
+    size_t& outPos)
+{
+    for (;;)
+    {
+        int symbol = lit.Decode(in);
+
+        if (symbol < 0)
+            return false;
+
+        if (symbol < 256)
+        {
+            if (outPos >= outSize)
+                return false;
+            out[outPos++] = static_cast<unsigned char>(symbol);
+            continue;
+        }
+
+        if (256 == symbol) // End of block
+            return !in.Overrun();
+
+        symbol -= 257;
+        if (symbol >= 29)
+            return false;
+
+        size_t const len = LengthBase[symbol] + in.Bits(LengthExtra[symbol]);
+
+        int const distSymbol = dist.Decode(in);
+        if (distSymbol < 0 || distSymbol >= 30)
+            return false;
+
+        size_t const distance = DistBase[distSymbol] + in.Bits(DistExtra[distSymbol]);
+        if (distance > outPos || len > outSize - outPos)
+            return false;
+
+        // Byte at a time - the source may overlap what is being written
+        unsigned char const* from = out + outPos - distance;
+        unsigned char* to = out + outPos;
+        for (size_t i = 0; i < len; i++)
+            to[i] = from[i];
+        outPos += len;
+    }
+}
+//---------------------------------------------------------------------------
+bool InflateDynamicTables(TIdatReader& in, THuffman& lit, THuffman& dist)
+{
+    unsigned int const numLit = in.Bits(5) + 257;
+    unsigned int const numDist = in.Bits(5) + 1;
+    unsigned int const numCodeLen = in.Bits(4) + 4;
+
+    if (numLit > 286 || numDist > 30)
+        return false;
+
+    uint8_t lengths[286 + 30];
+    std::memset(lengths, 0, 19);
+    for (unsigned int i = 0; i < numCodeLen; i++)
+        lengths[CodeLengthOrder[i]] = static_cast<uint8_t>(in.Bits(3));
+
+    THuffman codeLen;
+    if (!codeLen.Build(lengths, 19))
+        return false;
+
+    unsigned int idx = 0;
+    while (idx < numLit + numDist)
+    {
+        int const symbol = codeLen.Decode(in);
+        if (symbol < 0)
+            return false;
+
+        if (symbol < 16)
+        {
+            lengths[idx++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t value = 0;
+        unsigned int repeat;
+
+        if (16 == symbol)
+        {
+            if (0 == idx)
+                return false;
+            value = lengths[idx - 1];
+            repeat = 3 + in.Bits(2);
+        }
+        else if (17 == symbol)
+            repeat = 3 + in.Bits(3);
+        else
+            repeat = 11 + in.Bits(7);
+
+        if (repeat > numLit + numDist - idx)
+            return false;
+        while (repeat-- > 0)
+            lengths[idx++] = value;
+    }
+
+    if (0 == lengths[256]) // No end of block code
+        return false;
+
+    return lit.Build(lengths, numLit) && dist.Build(lengths + numLit, numDist) && !in.Overrun();
+}
+//---------------------------------------------------------------------------
+void BuildFixedTables(THuffman& lit, THuffman& dist)
+{
+    uint8_t lengths[288];
+    std::memset(lengths, 8, 144);
+    std::memset(lengths + 144, 9, 256 - 144);
+    std::memset(lengths + 256, 7, 280 - 256);
+    std::memset(lengths + 280, 8, 288 - 280);
+    lit.Build(lengths, 288);
+
+    std::memset(lengths, 5, 30);
+    dist.Build(lengths, 30);
+}
+//---------------------------------------------------------------------------
+// Inflates the zlib stream into 'out', which must be exactly the inflated size, handing each finished block's rows to
+// 'rows' as it goes.
+bool Inflate(TIdatReader& in, unsigned char* out, size_t outSize, TRowWriter& rows)
+{
+    uint32_t const cmf = in.Bits(8);
+    uint32_t const flg = in.Bits(8);
+
+    // Deflate, window up to 32K, no preset dictionary
+    if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20) != 0)
+        return false;
+
+    size_t outPos = 0;
+    bool final;
+
+    do
+    {
+        final = in.Bits(1) != 0;
+        uint32_t const type = in.Bits(2);
+
+        if (0 == type) // Stored
+        {
+            in.AlignToByte();
+            uint32_t const len = in.Bits(16);
+            uint32_t const nlen = in.Bits(16);
+
+            if ((len ^ 0xFFFF) != nlen || len > outSize - outPos)
+                return false;
+            for (uint32_t i = 0; i < len; i++)
+                out[outPos++] = static_cast<unsigned char>(in.Bits(8));
+            if (in.Overrun())
+                return false;
+        }
+        else if (1 == type || 2 == type)
+        {
+            THuffman lit;
+            THuffman dist;
+
+            if (1 == type)
+                BuildFixedTables(lit, dist);
+            else if (!InflateDynamicTables(in, lit, dist))
+                return false;
+
+            if (!InflateCodes(in, lit, dist, out, outSize, outPos))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+
+        rows.Flush(outPos);
+    } while (!final);
+
+    if (outPos != outSize)
+        return false;
+
+    // zlib trailer - Adler-32 of the inflated data, big endian
+    in.AlignToByte();
+    uint32_t adler = 0;
+    for (int i = 0; i < 4; i++)
+        adler = (adler << 8) | in.Bits(8);
+
+    return !in.Overrun() && adler == Crypt::TAdler::Adler32(out, outSize);
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TPngDecoder
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TPngDecoder::TPngDecoder()
+{
+}
+//---------------------------------------------------------------------------
+TPngDecoder::~TPngDecoder()
+{
+}
+//---------------------------------------------------------------------------
+// Decodes a whole PNG file held in memory into 'dest' (resized to fit). 'background' is 0x00RRGGBB - alpha is
+// ignored. On failure 'dest' holds whatever rows were decoded before the error.
+TPngDecoder::EResult TPngDecoder::Decode(unsigned char const* data, size_t size, TFrameBuffer& dest,
+    uint32_t background)
+{
+    THeader header;
+    EResult result = ReadHeader(data, size, &header);
+    if (result != EResult::OK)
+        return result;
+    if (!IsSupported(header))
+        return EResult::Unsupported;
+
+    TRowWriter rows(header, dest);
+    rows.Background = background & TFrameBuffer::RGBMask;
+
+    // Chunks up to the first IDAT
+    size_t pos = sizeof(PngSignature) + 8 + 13 + 4;
+    size_t dataPos;
+    uint32_t dataLen;
+
+    for (;;)
+    {
+        if (pos > size || size - pos < 12)
+            return EResult::Corrupt;
+
+        uint32_t const len = ReadU32BE(data + pos);
+        unsigned char const* type = data + pos + 4;
+        size_t const body = pos + 8;
+
+        if (len > size - body - 4)
+            return EResult::Corrupt;
+
+        unsigned char const* chunk = data + body;
+
+        if (IsChunk(type, "IDAT"))
+        {
+            dataPos = body;
+            dataLen = len;
+            break;
+        }
+        else if (IsChunk(type, "PLTE"))
+        {
+            if (0 == len || len % 3 != 0 || len / 3 > 256)
+                return EResult::Corrupt;
+
+            rows.PaletteSize = len / 3;
+            for (unsigned int i = 0; i < rows.PaletteSize; i++, chunk += 3)
+            {
+                rows.Palette[i] = 0xFF000000 | (static_cast<uint32_t>(chunk[0]) << 16) |
+                    (static_cast<uint32_t>(chunk[1]) << 8) | chunk[2];
+            }
+        }
+        else if (IsChunk(type, "tRNS"))
+        {
+            if (3 == header.ColorType)
+            {
+                for (unsigned int i = 0; i < len && i < rows.PaletteSize; i++)
+                {
+                    rows.Palette[i] =
+                        (rows.Palette[i] & TFrameBuffer::RGBMask) | (static_cast<uint32_t>(chunk[i]) << 24);
+                }
+            }
+            else if (0 == header.ColorType && len >= 2)
+            {
+                rows.HasColorKey = true;
+                rows.KeyR = static_cast<uint16_t>((chunk[0] << 8) | chunk[1]);
+            }
+            else if (2 == header.ColorType && len >= 6)
+            {
+                rows.HasColorKey = true;
+                rows.KeyR = static_cast<uint16_t>((chunk[0] << 8) | chunk[1]);
+                rows.KeyG = static_cast<uint16_t>((chunk[2] << 8) | chunk[3]);
+                rows.KeyB = static_cast<uint16_t>((chunk[4] << 8) | chunk[5]);
+            }
+        }
+        else if (IsChunk(type, "IEND"))
+        {
+            return EResult::Corrupt; // No image data
+        }
+        else if ((type[0] & 0x20) == 0)
+        {
+            return EResult::Unsupported; // Unknown critical chunk
+        }
+
+        pos = body + len + 4;
+    }
+
+    if (3 == header.ColorType && 0 == rows.PaletteSize)
+        return EResult::Corrupt;
+
+    static unsigned int const channels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    unsigned int const bitsPerPixel = channels[header.ColorType] * header.BitDepth;
+    size_t const stride = (static_cast<size_t>(header.Width) * bitsPerPixel + 7) / 8;
+    size_t const bytesPerPixel = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+    size_t const rawSize = static_cast<size_t>(header.Height) * (stride + 1);
+
+    // The one allocation: the inflated rows (which are also the back reference window), then two unfiltered rows
+    std::vector<unsigned char> work(rawSize + 2 * stride);
+    dest.Resize(static_cast<int>(header.Width), static_cast<int>(header.Height));
+    rows.Start(&work[0], &work[rawSize], stride, bytesPerPixel);
+
+    TIdatReader in(data, size, dataPos, dataLen);
+    if (!Inflate(in, &work[0], rawSize, rows) || !rows.IsComplete())
+        return EResult::Corrupt;
+
+    return EResult::OK;
+}
+//---------------------------------------------------------------------------
+bool TPngDecoder::IsPng(unsigned char const* data, size_t size)
+{
+    return size >= sizeof(PngSignature) && std::memcmp(data, PngSignature, sizeof(PngSignature)) == 0;
+}
+//---------------------------------------------------------------------------
+// True if Decode() handles this kind of image.
+bool TPngDecoder::IsSupported(THeader const& header)
+{
+    if (header.Interlace != 0)
+        return false;
+
+    if (0 == header.ColorType || 3 == header.ColorType)
+        return header.BitDepth <= 8;
+
+    return 8 == header.BitDepth;
+}
+//---------------------------------------------------------------------------
+// Reads and checks IHDR, which must be the first chunk.
+TPngDecoder::EResult TPngDecoder::ReadHeader(unsigned char const* data, size_t size, THeader* header)
+{
+    if (!IsPng(data, size))
+        return EResult::NotPng;
+
+    unsigned char const* ihdr = data + sizeof(PngSignature);
+    if (size < sizeof(PngSignature) + 8 + 13 + 4 || ReadU32BE(ihdr) != 13 || !IsChunk(ihdr + 4, "IHDR"))
+        return EResult::Corrupt;
+
+    ihdr += 8;
+    header->Width = ReadU32BE(ihdr);
+    header->Height = ReadU32BE(ihdr + 4);
+    header->BitDepth = ihdr[8];
+    header->ColorType = ihdr[9];
+    header->Interlace = ihdr[12];
+
+    if (0 == header->Width || 0 == header->Height || ihdr[10] != 0 || ihdr[11] != 0 || header->Interlace > 1)
+        return EResult::Corrupt;
+
+    unsigned int const depth = header->BitDepth;
+    bool validDepth;
+
+    switch (header->ColorType)
+    {
+    case 0:
+        validDepth = 1 == depth || 2 == depth || 4 == depth || 8 == depth || 16 == depth;
+        break;
+    case 3:
+        validDepth = 1 == depth || 2 == depth || 4 == depth || 8 == depth;
+        break;
+    case 2:
+    case 4:
+    case 6:
+        validDepth = 8 == depth || 16 == depth;
+        break;
+    default:
+        validDepth = false;
+        break;
+    }
+
+    if (!validDepth)
+        return EResult::Corrupt;
+
+    if (header->Width > MaxDimension || header->Height > MaxDimension)
+        return EResult::Unsupported;
+
+    return EResult::OK;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
@@ -0,0 +1,88 @@
+/* **************************************************************************
+ASWMS_PngDecoder.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_PngDecoderH
+#define ASWMS_PngDecoderH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+//---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TPngDecoder
+//
+// Self-contained PNG decoder - no VCL, GDI or zlib - so it can run on any
+// thread and any platform. Inflates the IDAT stream straight out of the
+// file data, reverses each row's filter as soon as the row is complete and
+// writes it to the frame buffer in its final format. Alpha is blended over
+// 'background', the same as drawing the PNG on a fresh bitmap. The only
+// allocation is one scratch buffer per image (plus sizing 'dest').
+//
+// Handles non-interlaced images, 8 bits per channel (grey, grey + alpha,
+// RGB, RGBA) and palette or grey at 1, 2, 4 or 8 bits, with tRNS.
+// Anything else returns Unsupported, so callers can fall back to another
+// decoder. Ancillary chunks (gAMA, iCCP, ...) are ignored, and chunk CRCs
+// aren't checked - the zlib Adler-32 is.
+/////////////////////////////////////////////////////////////////////////////
+class TPngDecoder
+{
+public: // Static vars
+    static uint32_t const DefaultBackground = 0xFFFFFFFF; // White, as a new bitmap
+    static uint32_t const MaxDimension = 16384;
+
+public:
+    enum class EResult
+    {
+        OK,
+        NotPng,
+        Unsupported,
+        Corrupt,
+    };
+
+    struct THeader
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint8_t BitDepth;
+        uint8_t ColorType;
+        uint8_t Interlace;
+    };
+
+private:
+    TPngDecoder();
+    ~TPngDecoder();
+
+public:
+    static EResult Decode(unsigned char const* data, size_t size, TFrameBuffer& dest,
+        uint32_t background = DefaultBackground);
+    static bool IsPng(unsigned char const* data, size_t size);
+    static bool IsSupported(THeader const& header);
+    static EResult ReadHeader(unsigned char const* data, size_t size, THeader* header);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_PngDecoderH
@@ -0,0 +1,279 @@
+/* **************************************************************************
+ASWMS_RenderScheduler.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_RenderScheduler.h"
+//---------------------------------------------------------------------------
+#include "ASWMS_Engine.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TTimingHistogram
+/////////////////////////////////////////////////////////////////////////////
+
+// Upper limits (exclusive) of every bucket but the last, which takes everything else
+int64_t const TTimingHistogram::BucketLimits[NumBuckets - 1] =
+{
+    1000, 2000, 4000, 8000, 16700, 33400, 66700, 125000, 250000,
+};
+
+//---------------------------------------------------------------------------
+TTimingHistogram::TTimingHistogram()
+{
+    Reset();
+}
+//---------------------------------------------------------------------------
+TTimingHistogram::~TTimingHistogram()
+{
+}
+//---------------------------------------------------------------------------
+void TTimingHistogram::Add(int64_t microSecs)
+{
+    if (microSecs < 0)
+        microSecs = 0;
+
+    size_t idx = 0;
+    while (idx < NumBuckets - 1 && microSecs >= BucketLimits[idx])
+        idx++;
+
+    m_Buckets[idx]++;
+    m_Count++;
+    m_TotalMicroSecs += microSecs;
+    if (microSecs > m_MaxMicroSecs)
+        m_MaxMicroSecs = microSecs;
+}
+//---------------------------------------------------------------------------
+uint64_t TTimingHistogram::GetBucketCount(size_t idx) const
+{
+    return (idx < NumBuckets) ? m_Buckets[idx] : 0;
+}
+//---------------------------------------------------------------------------
+// The last bucket has no upper limit and returns INT64_MAX.
+int64_t TTimingHistogram::GetBucketLimitMicroSecs(size_t idx)
+{
+    return (idx < NumBuckets - 1) ? BucketLimits[idx] : INT64_MAX;
+}
+//---------------------------------------------------------------------------
+uint64_t TTimingHistogram::GetCount() const
+{
+    return m_Count;
+}
+//---------------------------------------------------------------------------
+int64_t TTimingHistogram::GetMaxMicroSecs() const
+{
+    return m_MaxMicroSecs;
+}
+//---------------------------------------------------------------------------
+int64_t TTimingHistogram::GetMeanMicroSecs() const
+{
+    return (m_Count > 0) ? m_TotalMicroSecs / static_cast<int64_t>(m_Count) : 0;
+}
+//---------------------------------------------------------------------------
+// Returns the upper limit of the bucket holding the given percentile (the max for the overflow bucket).
+int64_t TTimingHistogram::GetPercentileMicroSecs(int percentile) const
+{
+    if (0 == m_Count)
+        return 0;
+
+    uint64_t const target = (m_Count * static_cast<uint64_t>(percentile) + 99) / 100;
+    uint64_t seen = 0;
+
+    for (size_t idx = 0; idx < NumBuckets - 1; idx++)
+    {
+        seen += m_Buckets[idx];
+        if (seen >= target)
+            return BucketLimits[idx];
+    }
+
+    return m_MaxMicroSecs;
+}
+//---------------------------------------------------------------------------
+void TTimingHistogram::Reset()
+{
+    for (size_t i = 0; i < NumBuckets; i++)
+        m_Buckets[i] = 0;
+
+    m_Count = 0;
+    m_TotalMicroSecs = 0;
+    m_MaxMicroSecs = 0;
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TRenderScheduler
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TRenderScheduler::TRenderScheduler()
+    : m_Clock(&m_DefaultClock),
+      m_FramePeriod(1000000 / Default_FrameRate),
+      m_LastRenderTime(Time_NotSet),
+      m_FirstPendingTime(Time_NotSet),
+      m_Pending(false),
+      m_Shift(0),
+      m_MouseX(-1),
+      m_MouseY(-1),
+      m_NumInputs(0),
+      m_NumMerged(0),
+      m_NumRenders(0)
+{
+}
+//---------------------------------------------------------------------------
+TRenderScheduler::~TRenderScheduler()
+{
+}
+//---------------------------------------------------------------------------
+TClock* TRenderScheduler::GetClock()
+{
+    return m_Clock;
+}
+//---------------------------------------------------------------------------
+// Frame time is how long each draw took, so idle time between frames is not included.
+TTimingHistogram const& TRenderScheduler::GetFrameTimeHistogram() const
+{
+    return m_FrameTime;
+}
+//---------------------------------------------------------------------------
+// Input latency is measured from the oldest undrawn input to the end of the draw that shows it. The draw only
+// updates the image bitmap, so the time until the window is painted and scanned out is not included.
+TTimingHistogram const& TRenderScheduler::GetInputLatencyHistogram() const
+{
+    return m_InputLatency;
+}
+//---------------------------------------------------------------------------
+// Returns 0 when a frame is already due.
+int TRenderScheduler::GetMilliSecsToNextFrame()
+{
+    if (Time_NotSet == m_LastRenderTime)
+        return 0;
+
+    int64_t const remaining = m_LastRenderTime + m_FramePeriod - m_Clock->NowMicroSecs();
+    if (remaining <= 0)
+        return 0;
+
+    // Round up so a timer set to this doesn't wake up just before the frame is due
+    return static_cast<int>((remaining + 999) / 1000);
+}
+//---------------------------------------------------------------------------
+uint64_t TRenderScheduler::GetNumInputs() const
+{
+    return m_NumInputs;
+}
+//---------------------------------------------------------------------------
+uint64_t TRenderScheduler::GetNumMerged() const
+{
+    return m_NumMerged;
+}
+//---------------------------------------------------------------------------
+uint64_t TRenderScheduler::GetNumRenders() const
+{
+    return m_NumRenders;
+}
+//---------------------------------------------------------------------------
+bool TRenderScheduler::IsFrameDue()
+{
+    return 0 == GetMilliSecsToNextFrame();
+}
+//---------------------------------------------------------------------------
+bool TRenderScheduler::IsRenderPending() const
+{
+    return m_Pending;
+}
+//---------------------------------------------------------------------------
+// Records the latest mouse state. Input that arrives while a draw is already pending replaces it.
+void TRenderScheduler::PostInput(TShiftState shift, int mouseX, int mouseY)
+{
+    m_NumInputs++;
+
+    if (m_Pending)
+    {
+        m_NumMerged++;
+    }
+    else
+    {
+        m_Pending = true;
+        m_FirstPendingTime = m_Clock->NowMicroSecs();
+    }
+
+    m_Shift = shift;
+    m_MouseX = mouseX;
+    m_MouseY = mouseY;
+}
+//---------------------------------------------------------------------------
+// Draws now if anything is pending, whether or not a frame is due. Returns true if it drew.
+bool TRenderScheduler::Render(TMSEngine& engine, TImage* image)
+{
+    if (!m_Pending)
+        return false;
+
+    m_Pending = false;
+    int64_t const start = m_Clock->NowMicroSecs();
+    engine.DrawMap(image, m_Shift, m_MouseX, m_MouseY);
+
+    int64_t const now = m_Clock->NowMicroSecs();
+    m_InputLatency.Add(now - m_FirstPendingTime);
+    m_FrameTime.Add(now - start);
+
+    m_LastRenderTime = now;
+    m_FirstPendingTime = Time_NotSet;
+    m_NumRenders++;
+    return true;
+}
+//---------------------------------------------------------------------------
+bool TRenderScheduler::RenderIfDue(TMSEngine& engine, TImage* image)
+{
+    if (!m_Pending || !IsFrameDue())
+        return false;
+
+    return Render(engine, image);
+}
+//---------------------------------------------------------------------------
+void TRenderScheduler::ResetStats()
+{
+    m_NumInputs = 0;
+    m_NumMerged = 0;
+    m_NumRenders = 0;
+    m_InputLatency.Reset();
+    m_FrameTime.Reset();
+}
+//---------------------------------------------------------------------------
+// Passing null restores the default clock. The scheduler does not take ownership of 'clock'.
+void TRenderScheduler::SetClock(TClock* clock)
+{
+    m_Clock = (nullptr == clock ? &m_DefaultClock : clock);
+    m_LastRenderTime = Time_NotSet;
+    if (m_Pending)
+        m_FirstPendingTime = m_Clock->NowMicroSecs();
+}
+//---------------------------------------------------------------------------
+void TRenderScheduler::SetFrameRate(int framesPerSec)
+{
+    if (framesPerSec <= 1)
+        framesPerSec = Default_FrameRate;
+    m_FramePeriod = 1000000 / framesPerSec;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
@@ -0,0 +1,138 @@
+/* **************************************************************************
+ASWMS_RenderScheduler.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_RenderSchedulerH
+#define ASWMS_RenderSchedulerH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+//---------------------------------------------------------------------------
+#include <System.Classes.hpp>
+#include <Vcl.ExtCtrls.hpp>
+//---------------------------------------------------------------------------
+#include "ASWMS_Clock.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+class TMSEngine;
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TTimingHistogram
+//
+// Fixed bucket histogram of durations in microseconds. Buckets are roughly
+// doubling, from under 1ms up to an overflow bucket for 250ms and over.
+/////////////////////////////////////////////////////////////////////////////
+class TTimingHistogram
+{
+public: // Static vars
+    static size_t const NumBuckets = 10;
+
+private: // Static vars
+    static int64_t const BucketLimits[NumBuckets - 1];
+
+private:
+    uint64_t m_Buckets[NumBuckets];
+    uint64_t m_Count;
+    int64_t m_TotalMicroSecs;
+    int64_t m_MaxMicroSecs;
+
+public: // Getters/Setters
+    uint64_t GetBucketCount(size_t idx) const;
+    static int64_t GetBucketLimitMicroSecs(size_t idx);
+    uint64_t GetCount() const;
+    int64_t GetMaxMicroSecs() const;
+    int64_t GetMeanMicroSecs() const;
+
+public:
+    TTimingHistogram();
+    ~TTimingHistogram();
+
+    void Add(int64_t microSecs);
+    int64_t GetPercentileMicroSecs(int percentile) const;
+    void Reset();
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TRenderScheduler
+//
+// Decouples map drawing from mouse events. Input is applied to the engine
+// straight away (so no click is lost), while drawing is deferred and done at
+// most once per display frame, using the latest mouse position and shift
+// state. Repeated hovers between frames collapse into a single draw.
+//
+// The owner posts input, then calls RenderIfDue(). When that doesn't draw,
+// it calls Render() once GetMilliSecsToNextFrame() has passed.
+/////////////////////////////////////////////////////////////////////////////
+class TRenderScheduler
+{
+public: // Static vars
+    static int const Default_FrameRate = 60;
+
+private: // Static vars
+    static int64_t const Time_NotSet = INT64_MIN;
+
+private:
+    TSteadyClock m_DefaultClock;
+    TClock* m_Clock;
+    int64_t m_FramePeriod; // Microseconds
+    int64_t m_LastRenderTime;
+    int64_t m_FirstPendingTime; // When the oldest input not yet drawn arrived
+    bool m_Pending;
+    TShiftState m_Shift;
+    int m_MouseX;
+    int m_MouseY;
+
+    uint64_t m_NumInputs;
+    uint64_t m_NumMerged;
+    uint64_t m_NumRenders;
+    TTimingHistogram m_InputLatency;
+    TTimingHistogram m_FrameTime;
+
+public: // Getters/Setters
+    TClock* GetClock();
+    TTimingHistogram const& GetFrameTimeHistogram() const;
+    TTimingHistogram const& GetInputLatencyHistogram() const;
+    int GetMilliSecsToNextFrame();
+    uint64_t GetNumInputs() const;
+    uint64_t GetNumMerged() const;
+    uint64_t GetNumRenders() const;
+    void SetClock(TClock* clock);
+    void SetFrameRate(int framesPerSec);
+
+public:
+    TRenderScheduler();
+    ~TRenderScheduler();
+
+    bool IsFrameDue();
+    bool IsRenderPending() const;
+    void PostInput(TShiftState shift, int mouseX, int mouseY);
+    bool Render(TMSEngine& engine, TImage* image);
+    bool RenderIfDue(TMSEngine& engine, TImage* image);
+    void ResetStats();
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_RenderSchedulerH
@@ -0,0 +1,152 @@
+/* **************************************************************************
+ASWMS_Resampler.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_Resampler.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TResampler
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TResampler::TResampler()
+{
+}
+//---------------------------------------------------------------------------
+TResampler::~TResampler()
+{
+}
+//---------------------------------------------------------------------------
+void TResampler::BuildAxisWeights(TAxisWeights* axis, int srcLen, int destLen)
+{
+    double const scale = static_cast<double>(srcLen) / destLen;
+
+    axis->First.resize(static_cast<size_t>(destLen));
+    axis->Count.resize(static_cast<size_t>(destLen));
+    axis->Weights.clear();
+
+    for (int i = 0; i < destLen; i++)
+    {
+        double const begin = i * scale;
+        double const end = std::min<double>(srcLen, (i + 1) * scale);
+        int const first = static_cast<int>(std::floor(begin));
+        int const last = std::min(srcLen - 1, static_cast<int>(std::ceil(end)) - 1);
+
+        axis->First[i] = first;
+        axis->Count[i] = last - first + 1;
+
+        for (int j = first; j <= last; j++)
+        {
+            double const overlap = std::min<double>(end, j + 1) - std::max<double>(begin, j);
+            axis->Weights.push_back(static_cast<float>(overlap / scale));
+        }
+    }
+}
+//---------------------------------------------------------------------------
+// Scales 'src' into 'dest' (resized to width x height). Output pixels are opaque.
+void TResampler::Resize(TFrameBuffer const& src, TFrameBuffer& dest, int width, int height, bool keyed)
+{
+    dest.Resize(width, height);
+
+    if (src.IsEmpty() || dest.IsEmpty())
+        return;
+
+    uint32_t const key = src.GetTransparentColor() & TFrameBuffer::RGBMask;
+
+    TAxisWeights xAxis;
+    TAxisWeights yAxis;
+    BuildAxisWeights(&xAxis, src.GetWidth(), width);
+    BuildAxisWeights(&yAxis, src.GetHeight(), height);
+
+    float const* yWeights = &yAxis.Weights[0];
+
+    for (int y = 0; y < height; y++)
+    {
+        uint32_t* destRow = dest.GetRow(y);
+        float const* xWeights = &xAxis.Weights[0];
+
+        for (int x = 0; x < width; x++)
+        {
+            // B, G, R and coverage, accumulated together so the compiler can keep them in one vector register
+            float sum[4] = { 0, 0, 0, 0 };
+
+            for (int sy = 0; sy < yAxis.Count[y]; sy++)
+            {
+                uint32_t const* srcRow = src.GetRow(yAxis.First[y] + sy) + xAxis.First[x];
+
+                for (int sx = 0; sx < xAxis.Count[x]; sx++)
+                {
+                    uint32_t const pixel = srcRow[sx];
+                    float weight = yWeights[sy] * xWeights[sx];
+
+                    if (keyed && (pixel & TFrameBuffer::RGBMask) == key)
+                        weight = 0;
+
+                    float const channels[4] =
+                    {
+                        static_cast<float>(pixel & 0xFF),
+                        static_cast<float>((pixel >> 8) & 0xFF),
+                        static_cast<float>((pixel >> 16) & 0xFF),
+                        1.0f,
+                    };
+
+                    for (int c = 0; c < 4; c++)
+                        sum[c] += channels[c] * weight;
+                }
+            }
+
+            xWeights += xAxis.Count[x];
+
+            if (sum[3] < 0.5f)
+            {
+                destRow[x] = 0xFF000000 | key;
+                continue;
+            }
+
+            uint32_t const b = static_cast<uint32_t>(std::min(255.0f, sum[0] / sum[3] + 0.5f));
+            uint32_t const g = static_cast<uint32_t>(std::min(255.0f, sum[1] / sum[3] + 0.5f));
+            uint32_t const r = static_cast<uint32_t>(std::min(255.0f, sum[2] / sum[3] + 0.5f));
+            uint32_t color = (r << 16) | (g << 8) | b;
+
+            // An opaque pixel must not average out to the key, or it would turn transparent
+            if (keyed && color == key)
+                color ^= 1;
+
+            destRow[x] = 0xFF000000 | color;
+        }
+
+        yWeights += yAxis.Count[y];
+    }
+
+    // Keep the key where VCL and TFrameBuffer look for it
+    if (keyed)
+        dest.GetRow(height - 1)[0] = 0xFF000000 | key;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
@@ -0,0 +1,70 @@
+/* **************************************************************************
+ASWMS_Resampler.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_ResamplerH
+#define ASWMS_ResamplerH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+//---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TResampler
+//
+// Area-average scaling: each destination pixel is the average of the
+// source area it covers, weighted by how much of each source pixel falls
+// inside it. Works both ways - shrinking averages, and enlarging keeps
+// pixel art sharp with only the edge pixels blended.
+//
+// Keyed sprites (transparent where they match the bottom-left pixel) are
+// averaged over their opaque pixels only, so edges never pick up the key
+// color. A pixel less than half covered by opaque pixels becomes the key.
+/////////////////////////////////////////////////////////////////////////////
+class TResampler
+{
+private:
+    // How the source pixels along one axis contribute to each destination pixel
+    struct TAxisWeights
+    {
+        std::vector<int> First; // First source pixel, per destination pixel
+        std::vector<int> Count; // Number of source pixels, per destination pixel
+        std::vector<float> Weights; // Count[i] weights for each destination pixel in turn, summing to 1
+    };
+
+private:
+    TResampler();
+    ~TResampler();
+
+    static void BuildAxisWeights(TAxisWeights* axis, int srcLen, int destLen);
+
+public:
+    static void Resize(TFrameBuffer const& src, TFrameBuffer& dest, int width, int height, bool keyed);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_ResamplerH
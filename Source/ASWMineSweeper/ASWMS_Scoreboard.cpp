@@ -0,0 +1,131 @@
+/* **************************************************************************
+ASWMS_Scoreboard.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_Scoreboard.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+//---------------------------------------------------------------------------
+TScoreboard::TScoreboard(size_t numDigits, uint32_t frameColor)
+    : m_NumDigits(numDigits < MaxDigits ? numDigits : MaxDigits),
+      m_FrameColor(frameColor),
+      m_Value(Value_NotSet),
+      m_Valid(false)
+{
+    for (size_t i = 0; i < MaxDigits; i++)
+        m_ShownDigits[i] = TSprites::BlankScoreDigitIndex;
+}
+//---------------------------------------------------------------------------
+TScoreboard::~TScoreboard()
+{
+}
+//---------------------------------------------------------------------------
+// Redraws only the digits that differ from the last draw. Values wider than the board show their lowest digits.
+void TScoreboard::Draw(TImage* image, TSprites& sprites, int value)
+{
+    if (m_Valid && value == m_Value)
+        return;
+
+    size_t digits[MaxDigits];
+    size_t count = ExtractDigits(value, digits, m_NumDigits);
+
+    TBitmap* bmp = image->Picture->Bitmap;
+    TCanvas* canvas = bmp->Canvas;
+    bool changed = false;
+
+    // 'digits' is least significant first, positions are left to right
+    for (size_t pos = 0; pos < m_NumDigits; pos++)
+    {
+        size_t idx = m_NumDigits - 1 - pos;
+        size_t spriteIdx = (idx < count) ? digits[idx] : TSprites::BlankScoreDigitIndex;
+
+        if (m_Valid && spriteIdx == m_ShownDigits[pos])
+            continue;
+
+        DrawDigit(canvas, sprites, pos, spriteIdx);
+        m_ShownDigits[pos] = spriteIdx;
+        changed = true;
+    }
+
+    // Digits are drawn under the border, so it only needs to be redone when one of them was
+    if (changed)
+        DrawFrame(bmp);
+
+    m_Value = value;
+    m_Valid = true;
+}
+//---------------------------------------------------------------------------
+void TScoreboard::DrawDigit(TCanvas* canvas, TSprites& sprites, size_t pos, size_t spriteIdx)
+{
+    TBitmap* bmpDigit = sprites.Digits_Score[spriteIdx].Bmp;
+    bmpDigit->Transparent = true;
+    canvas->Draw(bmpDigit->Width * static_cast<int>(pos), 0, bmpDigit);
+}
+//---------------------------------------------------------------------------
+void TScoreboard::DrawFrame(TBitmap* bmp)
+{
+    TCanvas* canvas = bmp->Canvas;
+    TRect rect(0, 0, bmp->Width - 1, bmp->Height - 1);
+    canvas->Brush->Color = TColor(m_FrameColor);
+    canvas->FrameRect(rect);
+}
+//---------------------------------------------------------------------------
+// Writes the decimal digits of |value| into 'digits', least significant first, without allocating.
+// At most 'maxDigits' are written. Returns the number written (at least 1 when maxDigits > 0).
+size_t TScoreboard::ExtractDigits(int value, size_t* digits, size_t maxDigits)
+{
+    if (0 == maxDigits)
+        return 0;
+
+    // Work in unsigned so that INT_MIN doesn't overflow when negated
+    unsigned int uValue = (value < 0) ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+
+    size_t count = 0;
+    do
+    {
+        digits[count++] = uValue % 10;
+        uValue /= 10;
+    } while (uValue > 0 && count < maxDigits);
+
+    return count;
+}
+//---------------------------------------------------------------------------
+size_t TScoreboard::GetNumDigits() const
+{
+    return m_NumDigits;
+}
+//---------------------------------------------------------------------------
+int TScoreboard::GetValue() const
+{
+    return m_Value;
+}
+//---------------------------------------------------------------------------
+// Forces the next Draw() to redraw every digit and the border, e.g. after the image was resized.
+void TScoreboard::Invalidate()
+{
+    m_Valid = false;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
@@ -0,0 +1,79 @@
+/* **************************************************************************
+ASWMS_Scoreboard.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_ScoreboardH
+#define ASWMS_ScoreboardH
+//---------------------------------------------------------------------------
+#include <climits>
+#include <stdint.h>
+//---------------------------------------------------------------------------
+#include <Vcl.ExtCtrls.hpp>
+//---------------------------------------------------------------------------
+#include "ASWMS_Sprites.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TScoreboard
+//
+// Fixed width digit display (time, mines remaining). Remembers what it last
+// drew, so redrawing the same value does nothing and a new value only blits
+// the digits that changed.
+/////////////////////////////////////////////////////////////////////////////
+class TScoreboard
+{
+public: // Static vars
+    static size_t const MaxDigits = 10; // Enough for any int
+
+private: // Static vars
+    static int const Value_NotSet = INT_MIN;
+
+private:
+    size_t m_NumDigits;
+    uint32_t m_FrameColor;
+    int m_Value;
+    bool m_Valid; // False until the first draw, or after Invalidate()
+    size_t m_ShownDigits[MaxDigits]; // Sprite index at each position, left to right
+
+private:
+    void DrawDigit(TCanvas* canvas, TSprites& sprites, size_t pos, size_t spriteIdx);
+    void DrawFrame(TBitmap* bmp);
+
+public:
+    static size_t ExtractDigits(int value, size_t* digits, size_t maxDigits);
+
+public: // Getters/Setters
+    size_t GetNumDigits() const;
+    int GetValue() const;
+
+public:
+    TScoreboard(size_t numDigits, uint32_t frameColor);
+    ~TScoreboard();
+
+    void Draw(TImage* image, TSprites& sprites, int value);
+    void Invalidate();
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_ScoreboardH
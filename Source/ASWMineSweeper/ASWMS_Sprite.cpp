@@ -24,14 +24,17 @@ limitations under the License.
 // Module header
 #include "ASWMS_Sprite.h"
 //---------------------------------------------------------------------------
-#include <fstream>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <utility>
 //---------------------------------------------------------------------------
 #include <Vcl.Imaging.GIFImg.hpp>
 #include <Vcl.Imaging.jpeg.hpp>
 #include <Vcl.Imaging.pngimage.hpp>
 //---------------------------------------------------------------------------
+#include "ASWMS_PngDecoder.h"
+#include "ASWMS_Resampler.h"
 #include "ASWTools_Path.h"
 #include "ASWTools_String.h"
 //---------------------------------------------------------------------------
@@ -46,21 +49,51 @@ namespace ASWMS
 // TSprite
 /////////////////////////////////////////////////////////////////////////////
 
+std::atomic<unsigned int> TSprite::Stat_ImageAllocs(0);
+std::atomic<unsigned int> TSprite::Stat_SharedCopies(0);
+std::atomic<unsigned int> TSprite::Stat_Moves(0);
+
+//---------------------------------------------------------------------------
+TSprite::TImageData::TImageData()
+    : Bmp(new Graphics::TBitmap())
+{
+}
+//---------------------------------------------------------------------------
+TSprite::TImageData::~TImageData()
+{
+    delete Bmp;
+}
 //---------------------------------------------------------------------------
 TSprite::TSprite()
-    : m_Bmp(nullptr)
 {
     Reset();
 }
+//---------------------------------------------------------------------------
+// Loads straight into a new image, without allocating an empty one first.
+TSprite::TSprite(std::string const& filename)
+{
+    LoadFromFile(filename);
+}
+//---------------------------------------------------------------------------
+TSprite::TSprite(std::shared_ptr<TImageData> const& data)
+    : m_Data(data)
+{
+}
+//---------------------------------------------------------------------------
 TSprite::TSprite(TSprite const& other)
-    : m_Bmp(nullptr)
+    : m_Data(other.m_Data)
+{
+    Stat_SharedCopies++;
+}
+//---------------------------------------------------------------------------
+TSprite::TSprite(TSprite&& other) noexcept
+    : m_Data(std::move(other.m_Data))
 {
-    CopyFrom(other);
+    Stat_Moves++;
 }
 //---------------------------------------------------------------------------
 TSprite::~TSprite()
 {
-    FreeBitmap();
 }
 //---------------------------------------------------------------------------
 TSprite& TSprite::operator=(TSprite const& rhs)
@@ -68,74 +101,175 @@ TSprite& TSprite::operator=(TSprite const& rhs)
     return CopyFrom(rhs);
 }
 //---------------------------------------------------------------------------
+TSprite& TSprite::operator=(TSprite&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        m_Data = std::move(rhs.m_Data);
+        Stat_Moves++;
+    }
+    return *this;
+}
+//---------------------------------------------------------------------------
+// Draws a decoded graphic into a new pf32bit image. Uses the canvas, so call from the UI thread.
+std::shared_ptr<TSprite::TImageData> TSprite::BuildImage(
+    TGraphic* graphic, std::string const& ext, std::string const& filename)
+{
+    std::shared_ptr<TImageData> data = NewImageData();
+    Graphics::TBitmap* bmp = data->Bmp;
+    data->Filename = filename;
+
+    if (ext == ".bmp")
+    {
+        bmp->Assign(graphic);
+    }
+    else
+    {
+        if (ext == ".ico" || ext == ".wmf" || ext == ".emf" || ext == ".gif")
+            bmp->PixelFormat = pf8bit;
+        else
+            bmp->PixelFormat = pf24bit;
+
+        bmp->Width = graphic->Width;
+        bmp->Height = graphic->Height;
+        bmp->Canvas->Draw(0, 0, graphic);
+    }
+
+    bmp->PixelFormat = pf32bit;
+    CapturePixels(data.get());
+
+    return data;
+}
+//---------------------------------------------------------------------------
+void TSprite::CapturePixels(TImageData* data)
+{
+    Graphics::TBitmap* bmp = data->Bmp;
+    int const width = bmp->Width;
+    int const height = bmp->Height;
+    data->Pixels.Resize(width, height);
+
+    for (int y = 0; y < height; y++)
+        std::memcpy(data->Pixels.GetRow(y), bmp->ScanLine[y], static_cast<size_t>(width) * sizeof(uint32_t));
+}
+//---------------------------------------------------------------------------
+// Shares the other sprite's image - no pixels are copied.
 TSprite& TSprite::CopyFrom(TSprite const& other)
 {
     if (this == &other)
         return *this;
 
-    FreeBitmap();
-    m_Bmp = new TBitmap();
-    m_Bmp->Assign(other.m_Bmp);
-
-    m_Filename = other.m_Filename;
+    m_Data = other.m_Data;
+    Stat_SharedCopies++;
 
     return *this;
 }
 //---------------------------------------------------------------------------
-void TSprite::FreeBitmap()
+// Creates the graphic class for 'ext' and loads it from 'stream'. The caller owns the result.
+// UI thread only - the VCL decoders create GDI objects (DIB sections, DCs) as they load.
+TGraphic* TSprite::DecodeGraphic(TMemoryStream* stream, std::string const& ext)
 {
-    delete m_Bmp;
-    m_Bmp = nullptr;
+    TGraphic* graphic;
+
+    if (ext == ".ico")
+        graphic = new TIcon();
+    else if (ext == ".wmf" || ext == ".emf") // metafile
+        graphic = new TMetafile();
+    else if (ext == ".jpg" || ext == ".jpeg")
+        graphic = new TJPEGImage();
+    else if (ext == ".gif")
+        graphic = new TGIFImage();
+    else if (ext == ".png")
+        graphic = new TPngImage();
+    else if (ext == ".bmp")
+        graphic = new Graphics::TBitmap();
+    else // TIFF or whatever else WIC can read
+        graphic = new TWICImage();
+
+    std::unique_ptr<TGraphic> auto_graphic(graphic);
+
+    stream->Position = 0;
+    graphic->LoadFromStream(stream);
+
+    return auto_graphic.release();
+}
+//---------------------------------------------------------------------------
+// Sizes the bitmap to match the pixel copy, and copies the pixels in. The reverse of CapturePixels().
+void TSprite::FillBitmap(TImageData* data)
+{
+    Graphics::TBitmap* bmp = data->Bmp;
+    int const width = data->Pixels.GetWidth();
+    int const height = data->Pixels.GetHeight();
+
+    bmp->PixelFormat = pf32bit;
+    bmp->SetSize(width, height);
+
+    for (int y = 0; y < height; y++)
+        std::memcpy(bmp->ScanLine[y], data->Pixels.GetRow(y), static_cast<size_t>(width) * sizeof(uint32_t));
+
+    bmp->Modified = true;
 }
 //---------------------------------------------------------------------------
+TSprite TSprite::FromGraphic(TGraphic* graphic, std::string const& ext, std::string const& filename)
+{
+    return TSprite(BuildImage(graphic, ext, filename));
+}
+//---------------------------------------------------------------------------
+// Builds a sprite from pf32bit pixel rows (top row first), such as the ones saved in a TSpriteCache. No decoding.
+TSprite TSprite::FromPixels(uint32_t const* pixels, int width, int height, std::string const& filename)
+{
+    std::shared_ptr<TImageData> data = NewImageData();
+    data->Filename = filename;
+    data->Pixels.Resize(width, height);
+
+    size_t const rowBytes = static_cast<size_t>(width) * sizeof(uint32_t);
+    for (int y = 0; y < height; y++)
+        std::memcpy(data->Pixels.GetRow(y), pixels + static_cast<size_t>(y) * static_cast<size_t>(width), rowBytes);
+
+    FillBitmap(data.get());
+    return TSprite(data);
+}
+//---------------------------------------------------------------------------
+// As above, but takes the pixels rather than copying them. 'pixels' is left empty.
+TSprite TSprite::FromPixels(TFrameBuffer& pixels, std::string const& filename)
+{
+    std::shared_ptr<TImageData> data = NewImageData();
+    data->Filename = filename;
+    data->Pixels.Swap(pixels);
+
+    FillBitmap(data.get());
+    return TSprite(data);
+}
+//---------------------------------------------------------------------------
+// Note: A moved from sprite has no image until it is loaded or Reset().
 Graphics::TBitmap* TSprite::GetBitmap()
 {
-    return m_Bmp;
+    return m_Data ? m_Data->Bmp : nullptr;
 }
 //---------------------------------------------------------------------------
 std::string TSprite::GetFilename()
 {
-    return m_Filename;
+    return m_Data ? m_Data->Filename : std::string();
+}
+//---------------------------------------------------------------------------
+TFrameBuffer const& TSprite::GetPixels() const
+{
+    static TFrameBuffer const empty;
+    return m_Data ? m_Data->Pixels : empty;
 }
 //---------------------------------------------------------------------------
-std::string TSprite::GetPictureFileExtension(std::string const& filename)
+// The extension for the image format in 'header' (the start of the file), or the filename's own extension if the
+// format isn't recognized.
+std::string TSprite::GetPictureFileExtension(
+    std::string const& filename, unsigned char const* header, size_t headerLen)
 {
     // Set the starting extension
     std::string ext = TPathTool::GetExtension(TStrTool::ToLower(filename));
 
-    if (!TPathTool::File_Exists_WinAPI(filename))
-        return ext;
-
-    // Scan the image file to determine actual file extension
-
-    std::ifstream in;
-    // May want to set the exception bit in the future. If so, uncomment to throw an exception on open failure, etc.
-    //in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
+    // Scan the start of the file to determine actual file extension
     static size_t const idLen = 15;
     unsigned char id[idLen + sizeof('\0')];
-    id[idLen] = '\0';
-
-    try
-    {
-#if __cplusplus >= 201103L
-        in.open(filename, std::ios::in | std::ios::binary);
-#else
-        in.open(filename.c_str(), std::ios::in | std::ios::binary);
-#endif
-        if (in.fail())
-            throw Exception(("Failed to open file: " + filename).c_str());
-    }
-    catch (std::ifstream::failure const& ex)
-    {
-        throw Exception(String("Failed to open file: ") + ex.what());
-    }
-
-    // Read in first N bytes to determine file type
-    in.read(reinterpret_cast<char*>(id), static_cast<std::streamsize>(idLen));
-    size_t bytesRead = static_cast<size_t>(in.gcount());
-    in.close();
-    id[bytesRead] = '\0';
+    std::memset(id, 0, sizeof(id));
+    std::memcpy(id, header, headerLen < idLen ? headerLen : idLen);
 
     static size_t const offsetJpg = 6;
 
@@ -146,7 +280,7 @@ std::string TSprite::GetPictureFileExtension(std::string const& filename)
         ext = ".tif";
     else if (std::memcmp("GIF", id, 3) == 0) // GIF
         ext = ".gif";
-    else if (std::memcmp("PNG", id, 3) == 0) // PNG
+    else if (std::memcmp("PNG", id + 1, 3) == 0) // PNG
         ext = ".png";
     else if (std::memcmp("JFIF", id + offsetJpg, 4) == 0) // JPG
         ext = ".jpg";
@@ -161,108 +295,83 @@ std::string TSprite::GetPictureFileExtension(std::string const& filename)
     return ext;
 }
 //---------------------------------------------------------------------------
+// Number of sprites sharing this sprite's image (0 if it has none).
+long TSprite::GetShareCount() const
+{
+    return m_Data.use_count();
+}
+//---------------------------------------------------------------------------
+TSprite::TStats TSprite::GetStats()
+{
+    TStats stats;
+    stats.ImageAllocs = Stat_ImageAllocs;
+    stats.SharedCopies = Stat_SharedCopies;
+    stats.Moves = Stat_Moves;
+    return stats;
+}
+//---------------------------------------------------------------------------
+// Builds a new image rather than replacing the current one's pixels, which may be shared with other sprites.
 void TSprite::LoadFromFile(std::string const& filename)
 {
-    Reset();
-
     if (!TPathTool::File_Exists_WinAPI(filename))
+    {
+        Reset();
         throw Exception(("File does not exist: " + filename).c_str());
+    }
 
-    m_Filename = filename;
+    // Read the file once, then sniff and decode from memory
+    std::unique_ptr<TMemoryStream> stream(new TMemoryStream());
+    stream->LoadFromFile(filename.c_str());
 
-    std::string const ext = GetPictureFileExtension(filename);
+    std::string const ext = GetPictureFileExtension(
+        filename, static_cast<unsigned char const*>(stream->Memory), static_cast<size_t>(stream->Size));
 
-    // load the picture
-    if (ext == ".ico")
+    if (ext == ".png")
     {
-        TIcon* icon = new TIcon();
-        std::unique_ptr<TIcon> auto_icon(icon);
-
-        icon->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf8bit;
-        m_Bmp->Width = icon->Width;
-        m_Bmp->Height = icon->Height;
-        m_Bmp->Canvas->Draw(0, 0, icon);
-    }
-    else if (ext == ".wmf" || ext == ".emf")//metafile
-    {
-        TMetafile* metaFile = new TMetafile();
-        std::unique_ptr<TMetafile> auto_metaFile(metaFile);
-
-        metaFile->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf8bit;
-        m_Bmp->Width = metaFile->Width;
-        m_Bmp->Height = metaFile->Height;
-        m_Bmp->Canvas->Draw(0, 0, metaFile);
-    }
-    else if (ext == ".jpg" || ext == "jpeg")
-    {
-        TJPEGImage* jpeg = new TJPEGImage;
-        std::unique_ptr<TJPEGImage> auto_jpeg(jpeg);
-
-        jpeg->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf24bit;
-        m_Bmp->Width = jpeg->Width;
-        m_Bmp->Height = jpeg->Height;
-        m_Bmp->Canvas->Draw(0, 0, jpeg);
-    }
-    else if (ext == ".gif")
-    {
-        TGIFImage* gifImage = new TGIFImage;
-        std::unique_ptr<TGIFImage> auto_gifImage(gifImage);
-
-        gifImage->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf8bit;
-        m_Bmp->Width = gifImage->Width;
-        m_Bmp->Height = gifImage->Height;
-        m_Bmp->Canvas->Draw(0, 0, gifImage);
-    }
-    else if (ext == ".png")
-    {
-        TPngImage* imagePng = new TPngImage();
-        std::unique_ptr<TPngImage> auto_imagePNG(imagePng);
-
-        imagePng->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf24bit;
-        m_Bmp->Width = imagePng->Width;
-        m_Bmp->Height = imagePng->Height;
-        m_Bmp->Canvas->Draw(0, 0, imagePng);
-    }
-    else if (ext == ".tif")
-    {
-        TPicture* tmpPic = new TPicture;
-        std::unique_ptr<TPicture> auto_tmpPic(tmpPic);
-
-        tmpPic->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf24bit;
-        m_Bmp->Width = tmpPic->Width;
-        m_Bmp->Height = tmpPic->Height;
-        m_Bmp->Canvas->Draw(0, 0, tmpPic->Graphic);
-    }
-    else if (ext == ".bmp")
-    {
-        m_Bmp->LoadFromFile(filename.c_str());
-    }
-    else //try to load whatever it is
-    {
-        TPicture* tmpPic = new TPicture;
-        std::unique_ptr<TPicture> auto_tmpPic(tmpPic);
-
-        tmpPic->LoadFromFile(filename.c_str());
-        m_Bmp->PixelFormat = pf24bit;
-        m_Bmp->Width = tmpPic->Width;
-        m_Bmp->Height = tmpPic->Height;
-        m_Bmp->Canvas->Draw(0, 0, tmpPic->Graphic);
+        TFrameBuffer pixels;
+        if (TPngDecoder::Decode(static_cast<unsigned char const*>(stream->Memory), static_cast<size_t>(stream->Size),
+            pixels) == TPngDecoder::EResult::OK)
+        {
+            *this = FromPixels(pixels, filename);
+            return;
+        }
+        // Not something TPngDecoder handles - let TPngImage try
     }
 
-    m_Bmp->PixelFormat = pf32bit;
+    std::unique_ptr<TGraphic> graphic(DecodeGraphic(stream.get(), ext));
+    LoadFromGraphic(graphic.get(), ext, filename);
+}
+//---------------------------------------------------------------------------
+void TSprite::LoadFromGraphic(TGraphic* graphic, std::string const& ext, std::string const& filename)
+{
+    m_Data = BuildImage(graphic, ext, filename);
+}
+//---------------------------------------------------------------------------
+std::shared_ptr<TSprite::TImageData> TSprite::NewImageData()
+{
+    Stat_ImageAllocs++;
+    return std::make_shared<TImageData>();
 }
 //---------------------------------------------------------------------------
+// Gives this sprite a new, empty image. Other sprites sharing the old image keep it.
 void TSprite::Reset()
 {
-    FreeBitmap();
-    m_Filename = "";
-    m_Bmp = new Graphics::TBitmap();
+    m_Data = NewImageData();
+}
+//---------------------------------------------------------------------------
+// A new sprite with this one's image resampled to width x height. 'keyed' sprites keep their transparent color.
+TSprite TSprite::Scaled(int width, int height, bool keyed) const
+{
+    TFrameBuffer pixels;
+    TResampler::Resize(GetPixels(), pixels, width, height, keyed);
+    return FromPixels(pixels, m_Data ? m_Data->Filename : std::string());
+}
+//---------------------------------------------------------------------------
+void TSprite::ResetStats()
+{
+    Stat_ImageAllocs = 0;
+    Stat_SharedCopies = 0;
+    Stat_Moves = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -21,40 +21,97 @@ limitations under the License.
 #ifndef ASWMS_SpriteH
 #define ASWMS_SpriteH
 //---------------------------------------------------------------------------
+#include <atomic>
+#include <memory>
 #include <string>
 //---------------------------------------------------------------------------
+#include <System.Classes.hpp>
 #include <Vcl.Graphics.hpp>
 //---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+//---------------------------------------------------------------------------
 
 namespace ASWMS
 {
 
 /////////////////////////////////////////////////////////////////////////////
 // TSprite
+//
+// Sprites share their loaded image. Copying a sprite only adds a reference
+// (no bitmap copy), and loading always builds a new image, so an image never
+// changes once other sprites can see it. Callers must not draw on Bmp.
 /////////////////////////////////////////////////////////////////////////////
 class TSprite
 {
+public:
+    // Counters since the last ResetStats(), to keep an eye on load time allocation and copying
+    struct TStats
+    {
+        unsigned int ImageAllocs; // Images (bitmap + pixel copy) created
+        unsigned int SharedCopies; // Copies that only added a reference
+        unsigned int Moves;
+    };
+
+private: // Static vars
+    static std::atomic<unsigned int> Stat_ImageAllocs;
+    static std::atomic<unsigned int> Stat_SharedCopies;
+    static std::atomic<unsigned int> Stat_Moves;
+
 private:
-    Graphics::TBitmap* m_Bmp;
-    std::string m_Filename;
+    struct TImageData
+    {
+        Graphics::TBitmap* Bmp;
+        TFrameBuffer Pixels; // Copy of the bitmap's pixels, for drawing off the UI thread
+        std::string Filename;
+
+        TImageData();
+        ~TImageData();
+
+        TImageData(TImageData const&) = delete;
+        TImageData& operator=(TImageData const&) = delete;
+    };
 
-    void FreeBitmap();
-    std::string GetPictureFileExtension(std::string const& filename);
+    std::shared_ptr<TImageData> m_Data;
+
+    explicit TSprite(std::shared_ptr<TImageData> const& data);
+
+    static std::shared_ptr<TImageData> BuildImage(
+        TGraphic* graphic, std::string const& ext, std::string const& filename);
+    static void CapturePixels(TImageData* data);
+    static void FillBitmap(TImageData* data);
+    static std::shared_ptr<TImageData> NewImageData();
+
+public:
+    static TGraphic* DecodeGraphic(TMemoryStream* stream, std::string const& ext);
+    static TSprite FromGraphic(TGraphic* graphic, std::string const& ext, std::string const& filename);
+    static TSprite FromPixels(uint32_t const* pixels, int width, int height, std::string const& filename);
+    static TSprite FromPixels(TFrameBuffer& pixels, std::string const& filename);
+    static std::string GetPictureFileExtension(
+        std::string const& filename, unsigned char const* header, size_t headerLen);
+    static TStats GetStats();
+    static void ResetStats();
 
 public:
     TSprite();
+    explicit TSprite(std::string const& filename);
     TSprite(TSprite const& other);
+    TSprite(TSprite&& other) noexcept;
     ~TSprite();
 
     TSprite& operator=(TSprite const& rhs);
+    TSprite& operator=(TSprite&& rhs) noexcept;
 
     TSprite& CopyFrom(TSprite const& other);
     void LoadFromFile(std::string const& filename);
+    void LoadFromGraphic(TGraphic* graphic, std::string const& ext, std::string const& filename);
     void Reset();
+    TSprite Scaled(int width, int height, bool keyed) const;
 
 public: // Getters/Setters
     Graphics::TBitmap* GetBitmap();
     std::string GetFilename();
+    TFrameBuffer const& GetPixels() const;
+    long GetShareCount() const;
 
     __property Graphics::TBitmap* Bmp = { read = GetBitmap };
     __property std::string Filename = { read = GetFilename };
@@ -0,0 +1,232 @@
+/* **************************************************************************
+ASWMS_SpriteCache.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_SpriteCache.h"
+//---------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+//---------------------------------------------------------------------------
+#include "ASWTools_Adler.h"
+#include "ASWTools_Path.h"
+#include "ASWTools_String.h"
+//---------------------------------------------------------------------------
+using namespace ASWTools;
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TSpriteCache
+/////////////////////////////////////////////////////////////////////////////
+
+char const TSpriteCache::Magic[4] = { 'A', 'S', 'P', 'C' };
+
+//---------------------------------------------------------------------------
+TSpriteCache::TSpriteCache()
+{
+}
+//---------------------------------------------------------------------------
+TSpriteCache::~TSpriteCache()
+{
+    Close();
+}
+//---------------------------------------------------------------------------
+void TSpriteCache::Close()
+{
+    m_Entries.clear();
+    m_Index.clear();
+    m_File.Close();
+}
+//---------------------------------------------------------------------------
+// Returns nullptr if there is no entry for 'filename'. Safe to call from several threads at once.
+TSpriteCache::TEntry const* TSpriteCache::Find(std::string const& filename) const
+{
+    std::map<std::string, size_t>::const_iterator it = m_Index.find(TStrTool::ToLower(filename));
+    return m_Index.end() == it ? nullptr : &m_Entries[it->second];
+}
+//---------------------------------------------------------------------------
+// One cache per images folder, so switching themes doesn't throw away the other theme's cache.
+std::string TSpriteCache::GetCacheFileName(std::string const& cacheDir, std::string const& imagesDir)
+{
+    std::string const key = TStrTool::ToLower(imagesDir);
+    char name[32];
+    std::snprintf(name, sizeof(name), "SpriteCache_%08X.bin", static_cast<unsigned int>(Crypt::TAdler::Adler32(key)));
+    return TPathTool::Combine(cacheDir, name);
+}
+//---------------------------------------------------------------------------
+size_t TSpriteCache::GetCount() const
+{
+    return m_Entries.size();
+}
+//---------------------------------------------------------------------------
+bool TSpriteCache::IsOpen() const
+{
+    return m_File.IsOpen();
+}
+//---------------------------------------------------------------------------
+// A missing or unreadable cache isn't an error - it just means everything gets decoded. Returns false if the file
+// doesn't exist or doesn't look like a cache from this version.
+bool TSpriteCache::Open(std::string const& fileName)
+{
+    Close();
+
+    if (!m_File.Open(TStrTool::Utf8ToUnicodeStr(fileName)))
+        return false;
+
+    if (!ReadEntries())
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// Checks every offset and size against the mapping, so a truncated or damaged file is rejected rather than read
+// past its end.
+bool TSpriteCache::ReadEntries()
+{
+    unsigned char const* data = m_File.GetData();
+    size_t const size = m_File.GetSize();
+
+    THeader header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0 || header.Version != Version)
+        return false;
+    if (header.NumEntries > (size - sizeof(header)) / sizeof(TFileEntry))
+        return false;
+
+    m_Entries.resize(header.NumEntries);
+
+    for (size_t i = 0; i < header.NumEntries; i++)
+    {
+        TFileEntry fileEntry;
+        std::memcpy(&fileEntry, data + sizeof(header) + i * sizeof(TFileEntry), sizeof(fileEntry));
+
+        if (fileEntry.Width < 0 || fileEntry.Height < 0 || fileEntry.NameLen == 0)
+            return false;
+        if (fileEntry.NameOffset > size || fileEntry.NameLen > size - fileEntry.NameOffset)
+            return false;
+
+        uint64_t const pixelBytes =
+            static_cast<uint64_t>(fileEntry.Width) * static_cast<uint64_t>(fileEntry.Height) * sizeof(uint32_t);
+        if (fileEntry.PixelOffset % sizeof(uint32_t) != 0 || fileEntry.PixelOffset > size ||
+            pixelBytes > size - fileEntry.PixelOffset)
+            return false;
+
+        TEntry& entry = m_Entries[i];
+        entry.Filename.assign(reinterpret_cast<char const*>(data + fileEntry.NameOffset), fileEntry.NameLen);
+        entry.Source.FileSize = fileEntry.FileSize;
+        entry.Source.LastWriteTime = fileEntry.LastWriteTime;
+        entry.Source.Adler32 = fileEntry.Adler32;
+        entry.Width = fileEntry.Width;
+        entry.Height = fileEntry.Height;
+        entry.Pixels = reinterpret_cast<uint32_t const*>(data + fileEntry.PixelOffset);
+
+        m_Index[TStrTool::ToLower(entry.Filename)] = i;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// Replaces 'fileName' through TPathTool::File_WriteAtomic(), so a crash never leaves a half written cache.
+// 'fileName' must not be open in a TSpriteCache. Returns false on failure - the caller can carry on without a cache.
+bool TSpriteCache::Save(std::string const& fileName, std::vector<TSaveItem> const& items)
+{
+    THeader header;
+    std::memcpy(header.Magic, Magic, sizeof(Magic));
+    header.Version = Version;
+    header.NumEntries = static_cast<uint32_t>(items.size());
+    header.Reserved = 0;
+
+    // Lay out the file: entry table, names, then 4 byte aligned pixels
+    std::vector<TFileEntry> fileEntries(items.size());
+    uint64_t offset = sizeof(header) + items.size() * sizeof(TFileEntry);
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        fileEntries[i].NameOffset = offset;
+        fileEntries[i].NameLen = static_cast<uint32_t>(items[i].Filename.length());
+        offset += fileEntries[i].NameLen;
+    }
+
+    offset = (offset + sizeof(uint32_t) - 1) & ~static_cast<uint64_t>(sizeof(uint32_t) - 1);
+    uint64_t const pixelStart = offset;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        TFrameBuffer const& pixels = *items[i].Pixels;
+        TFileEntry& fileEntry = fileEntries[i];
+
+        fileEntry.FileSize = items[i].Source.FileSize;
+        fileEntry.LastWriteTime = items[i].Source.LastWriteTime;
+        fileEntry.Adler32 = items[i].Source.Adler32;
+        fileEntry.Width = pixels.GetWidth();
+        fileEntry.Height = pixels.GetHeight();
+        fileEntry.PixelOffset = offset;
+
+        offset += static_cast<uint64_t>(pixels.GetWidth()) * static_cast<uint64_t>(pixels.GetHeight()) *
+            sizeof(uint32_t);
+    }
+
+    // Built in memory, so the file is written in one go. The padding before the pixels stays zero.
+    std::vector<unsigned char> data(static_cast<size_t>(offset), 0);
+    unsigned char* out = &data[0];
+
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+
+    if (!fileEntries.empty())
+        std::memcpy(out, &fileEntries[0], fileEntries.size() * sizeof(TFileEntry));
+    out += fileEntries.size() * sizeof(TFileEntry);
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        std::memcpy(out, items[i].Filename.c_str(), items[i].Filename.length());
+        out += items[i].Filename.length();
+    }
+
+    out = &data[static_cast<size_t>(pixelStart)];
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        TFrameBuffer const& pixels = *items[i].Pixels;
+        size_t const rowBytes = static_cast<size_t>(pixels.GetWidth()) * sizeof(uint32_t);
+        if (pixels.IsEmpty())
+            continue;
+
+        for (int y = 0; y < pixels.GetHeight(); y++)
+        {
+            std::memcpy(out, pixels.GetRow(y), rowBytes);
+            out += rowBytes;
+        }
+    }
+
+    return TPathTool::File_WriteAtomic(fileName, &data[0], data.size());
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
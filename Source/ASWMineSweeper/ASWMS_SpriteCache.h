@@ -0,0 +1,154 @@
+/* **************************************************************************
+ASWMS_SpriteCache.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_SpriteCacheH
+#define ASWMS_SpriteCacheH
+//---------------------------------------------------------------------------
+#include <map>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+#include "ASWTools_MappedFile.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TSpriteCache
+//
+// Decoded 32-bit sprite pixels saved to disk, so that later launches can
+// skip image decoding. Each entry records its source file's size, last
+// write time and Adler-32. The file is memory mapped while open; entry
+// pixels point straight into the mapping.
+//
+// Layout: THeader, THeader::NumEntries x TFileEntry, names, then pixel rows
+// (top row first, 4 byte aligned).
+/////////////////////////////////////////////////////////////////////////////
+class TSpriteCache
+{
+public: // Static vars
+    static uint32_t const Version = 2; // 2: PNGs decoded by TPngDecoder
+
+public:
+    // What a cache entry was built from
+    struct TSourceInfo
+    {
+        uint64_t FileSize;
+        uint64_t LastWriteTime; // FILETIME as one value
+        uint32_t Adler32;
+
+        TSourceInfo()
+            : FileSize(0),
+              LastWriteTime(0),
+              Adler32(0)
+        {
+        }
+    };
+
+    struct TEntry
+    {
+        std::string Filename;
+        TSourceInfo Source;
+        int Width;
+        int Height;
+        uint32_t const* Pixels; // Width * Height, top row first
+
+        TEntry()
+            : Width(0),
+              Height(0),
+              Pixels(nullptr)
+        {
+        }
+    };
+
+    // One sprite to save
+    struct TSaveItem
+    {
+        std::string Filename;
+        TSourceInfo Source;
+        TFrameBuffer const* Pixels;
+    };
+
+private:
+    // On disk structures - fixed size fields only, no padding
+    struct THeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t NumEntries;
+        uint32_t Reserved;
+    };
+
+    struct TFileEntry
+    {
+        uint64_t FileSize;
+        uint64_t LastWriteTime;
+        uint64_t NameOffset;
+        uint64_t PixelOffset;
+        uint32_t Adler32;
+        uint32_t NameLen;
+        int32_t Width;
+        int32_t Height;
+    };
+
+#if __cplusplus >= 201103L
+    static_assert(sizeof(THeader) == 16, "THeader must not be padded");
+    static_assert(sizeof(TFileEntry) == 48, "TFileEntry must not be padded");
+#endif
+
+private: // Static vars
+    static char const Magic[4];
+
+private:
+    ASWTools::TMappedFile m_File;
+    std::vector<TEntry> m_Entries;
+    std::map<std::string, size_t> m_Index; // Lower case filename to m_Entries index
+
+private:
+    bool ReadEntries();
+
+public:
+    static std::string GetCacheFileName(std::string const& cacheDir, std::string const& imagesDir);
+    static bool Save(std::string const& fileName, std::vector<TSaveItem> const& items); // UTF-8
+
+public: // Getters/Setters
+    size_t GetCount() const;
+    bool IsOpen() const;
+
+public:
+    TSpriteCache();
+    ~TSpriteCache();
+
+    TSpriteCache(TSpriteCache const&) = delete;
+    TSpriteCache& operator=(TSpriteCache const&) = delete;
+
+    void Close();
+    TEntry const* Find(std::string const& filename) const;
+    bool Open(std::string const& fileName); // UTF-8
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_SpriteCacheH
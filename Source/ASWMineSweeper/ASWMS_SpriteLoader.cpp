@@ -0,0 +1,298 @@
+/* **************************************************************************
+ASWMS_SpriteLoader.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+#include <vcl.h>
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_SpriteLoader.h"
+//---------------------------------------------------------------------------
+#include <exception>
+#include <memory>
+//---------------------------------------------------------------------------
+#include "ASWMS_Clock.h"
+#include "ASWMS_PngDecoder.h"
+#include "ASWTools_Adler.h"
+#include "ASWTools_Path.h"
+#include "ASWTools_ThreadPool.h"
+//---------------------------------------------------------------------------
+using namespace ASWTools;
+using namespace System;
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TSpriteLoader
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+// 1 loads on the calling thread only (the serial baseline). 0 uses one thread per hardware thread.
+TSpriteLoader::TSpriteLoader(size_t numThreads)
+    : m_NumThreads(numThreads),
+      m_Cache(nullptr),
+      m_CacheStale(false)
+{
+    if (0 == m_NumThreads)
+        m_NumThreads = TThreadPool::GetHardwareThreadCount();
+}
+//---------------------------------------------------------------------------
+TSpriteLoader::~TSpriteLoader()
+{
+    FreeData();
+}
+//---------------------------------------------------------------------------
+// Returns the index to pass to GetSprite() once Run() has finished.
+size_t TSpriteLoader::Add(std::string const& filename)
+{
+    m_Jobs.push_back(TJob());
+    m_Jobs.back().Filename = filename;
+    return m_Jobs.size() - 1;
+}
+//---------------------------------------------------------------------------
+// Calling thread only - the VCL decoders aren't safe on the pool threads
+void TSpriteLoader::Build(TJob& job, TSprite& sprite)
+{
+    if (nullptr != job.Cached)
+    {
+        sprite = TSprite::FromPixels(job.Cached->Pixels, job.Cached->Width, job.Cached->Height, job.Filename);
+        return;
+    }
+
+    if (!job.Pixels.IsEmpty())
+    {
+        sprite = TSprite::FromPixels(job.Pixels, job.Filename);
+        return;
+    }
+
+    std::unique_ptr<TMemoryStream> stream(job.Data);
+    job.Data = nullptr;
+
+    std::unique_ptr<TGraphic> graphic(TSprite::DecodeGraphic(stream.get(), job.Ext));
+    sprite = TSprite::FromGraphic(graphic.get(), job.Ext, job.Filename);
+}
+//---------------------------------------------------------------------------
+void TSpriteLoader::Clear()
+{
+    FreeData();
+    m_Jobs.clear();
+    m_Sprites.clear();
+    m_Timings = TTimings();
+    m_CacheStale = false;
+}
+//---------------------------------------------------------------------------
+void TSpriteLoader::FreeData()
+{
+    for (size_t i = 0; i < m_Jobs.size(); i++)
+    {
+        delete m_Jobs[i].Data;
+        m_Jobs[i].Data = nullptr;
+    }
+}
+//---------------------------------------------------------------------------
+size_t TSpriteLoader::GetCount() const
+{
+    return m_Jobs.size();
+}
+//---------------------------------------------------------------------------
+TSprite& TSpriteLoader::GetSprite(size_t idx)
+{
+    return m_Sprites.at(idx);
+}
+//---------------------------------------------------------------------------
+TSpriteLoader::TTimings const& TSpriteLoader::GetTimings() const
+{
+    return m_Timings;
+}
+//---------------------------------------------------------------------------
+// True if Run() found anything the cache didn't have, or had out of date. Save the cache again if so.
+bool TSpriteLoader::IsCacheStale() const
+{
+    return m_CacheStale;
+}
+//---------------------------------------------------------------------------
+// Runs on a worker thread. Reads the whole file in one go, then decodes it from memory if it is a PNG that
+// TPngDecoder handles. Anything else keeps the data for Build(), since only TPngDecoder is safe off the UI thread.
+// A cached copy is used instead if the size and last write time match (the file isn't read at all), or if the
+// size and Adler-32 match. Errors are kept on the job rather than thrown, so that every file gets its turn.
+void TSpriteLoader::ReadAndDecode(TJob& job) const
+{
+    try
+    {
+        FILETIME lastWriteTime;
+        if (!TPathTool::File_GetSizeAndLastWriteTime(job.Filename, job.Source.FileSize, lastWriteTime))
+        {
+            job.Error = "File does not exist: " + job.Filename;
+            return;
+        }
+
+        job.Source.LastWriteTime =
+            (static_cast<uint64_t>(lastWriteTime.dwHighDateTime) << 32) | lastWriteTime.dwLowDateTime;
+
+        TSpriteCache::TEntry const* cached = nullptr == m_Cache ? nullptr : m_Cache->Find(job.Filename);
+        if (nullptr != cached && cached->Source.FileSize != job.Source.FileSize)
+            cached = nullptr;
+
+        if (nullptr != cached && cached->Source.LastWriteTime == job.Source.LastWriteTime)
+        {
+            job.Source.Adler32 = cached->Source.Adler32;
+            job.Cached = cached;
+            return;
+        }
+
+        std::unique_ptr<TMemoryStream> stream(new TMemoryStream());
+        stream->LoadFromFile(job.Filename.c_str());
+
+        job.Source.FileSize = static_cast<uint64_t>(stream->Size);
+        job.Source.Adler32 = Crypt::TAdler::Adler32(
+            static_cast<unsigned char const*>(stream->Memory), static_cast<size_t>(stream->Size));
+
+        // Touched, but the same content
+        if (nullptr != cached && cached->Source.Adler32 == job.Source.Adler32)
+        {
+            job.Cached = cached;
+            return;
+        }
+
+        job.Ext = TSprite::GetPictureFileExtension(
+            job.Filename, static_cast<unsigned char const*>(stream->Memory), static_cast<size_t>(stream->Size));
+
+        if (job.Ext == ".png")
+        {
+            if (TPngDecoder::Decode(static_cast<unsigned char const*>(stream->Memory),
+                static_cast<size_t>(stream->Size), job.Pixels) == TPngDecoder::EResult::OK)
+                return;
+
+            // Not something TPngDecoder handles - let TPngImage try in Build()
+            job.Pixels.Clear();
+        }
+
+        job.Data = stream.release();
+    }
+    catch (Exception& ex)
+    {
+        job.Error = AnsiString(ex.Message).c_str();
+    }
+    catch (std::exception& ex)
+    {
+        job.Error = ex.what();
+    }
+}
+//---------------------------------------------------------------------------
+// Loads every file added so far. Throws for the first file (in the order added) that fails.
+void TSpriteLoader::Run()
+{
+    TSteadyClock clock;
+    int64_t const startTime = clock.NowMicroSecs();
+
+    FreeData();
+    m_Sprites.clear();
+    m_Sprites.resize(m_Jobs.size());
+
+    for (size_t i = 0; i < m_Jobs.size(); i++)
+    {
+        m_Jobs[i].Cached = nullptr;
+        m_Jobs[i].Pixels.Clear();
+        m_Jobs[i].Error.clear();
+    }
+
+    {
+        // Pool only lives for the load - startup is the only time it's needed
+        TThreadPool pool(m_NumThreads);
+        pool.ParallelFor(m_Jobs.size(), 1,
+            [this](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                    ReadAndDecode(m_Jobs[i]);
+            });
+    }
+
+    int64_t const decodedTime = clock.NowMicroSecs();
+
+    size_t numFromCache = 0;
+    m_CacheStale = nullptr == m_Cache || m_Cache->GetCount() != m_Jobs.size();
+
+    for (size_t i = 0; i < m_Jobs.size(); i++)
+    {
+        TJob const& job = m_Jobs[i];
+
+        if (nullptr == job.Cached)
+        {
+            m_CacheStale = true;
+            continue;
+        }
+
+        numFromCache++;
+        if (job.Cached->Source.LastWriteTime != job.Source.LastWriteTime)
+            m_CacheStale = true;
+    }
+
+    for (size_t i = 0; i < m_Jobs.size(); i++)
+    {
+        TJob& job = m_Jobs[i];
+
+        if (!job.Error.empty())
+        {
+            std::string const error = job.Error;
+            FreeData();
+            m_Sprites.clear();
+            throw Exception(error.c_str());
+        }
+
+        Build(job, m_Sprites[i]);
+    }
+
+    int64_t const endTime = clock.NowMicroSecs();
+
+    m_Timings.ReadDecodeMicroSecs = decodedTime - startTime;
+    m_Timings.BuildMicroSecs = endTime - decodedTime;
+    m_Timings.TotalMicroSecs = endTime - startTime;
+    m_Timings.NumSprites = m_Jobs.size();
+    m_Timings.NumFromCache = numFromCache;
+    m_Timings.NumThreads = m_NumThreads;
+}
+//---------------------------------------------------------------------------
+// Saves every sprite from the last Run(). Close the cache given to SetCache() first if it is the same file.
+bool TSpriteLoader::SaveCache(std::string const& fileName) const
+{
+    if (m_Sprites.size() != m_Jobs.size())
+        return false;
+
+    std::vector<TSpriteCache::TSaveItem> items(m_Jobs.size());
+
+    for (size_t i = 0; i < m_Jobs.size(); i++)
+    {
+        items[i].Filename = m_Jobs[i].Filename;
+        items[i].Source = m_Jobs[i].Source;
+        items[i].Pixels = &m_Sprites[i].GetPixels();
+    }
+
+    return TSpriteCache::Save(fileName, items);
+}
+//---------------------------------------------------------------------------
+// The cache must stay open until Run() has finished. nullptr decodes everything.
+void TSpriteLoader::SetCache(TSpriteCache const* cache)
+{
+    m_Cache = cache;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
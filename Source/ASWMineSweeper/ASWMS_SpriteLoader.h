@@ -0,0 +1,127 @@
+/* **************************************************************************
+ASWMS_SpriteLoader.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_SpriteLoaderH
+#define ASWMS_SpriteLoaderH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+#include <System.Classes.hpp>
+#include <Vcl.Graphics.hpp>
+//---------------------------------------------------------------------------
+#include "ASWMS_Sprite.h"
+#include "ASWMS_SpriteCache.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TSpriteLoader
+//
+// Loads a batch of sprites. Every file is read into memory once on a thread
+// pool, and PNGs are decoded there by TPngDecoder straight to their final
+// pixels. Everything else, including PNGs that TPngDecoder rejects, is
+// decoded by VCL in the build step on the calling thread, since the TGraphic
+// decoders create GDI objects and VCL canvases aren't thread safe.
+// With a cache set, files whose size and last write time (or, failing
+// that, Adler-32) still match are built from the cached pixels instead.
+/////////////////////////////////////////////////////////////////////////////
+class TSpriteLoader
+{
+public:
+    struct TTimings
+    {
+        int64_t ReadDecodeMicroSecs; // Parallel read + decode
+        int64_t BuildMicroSecs; // Bitmaps built on the calling thread
+        int64_t TotalMicroSecs;
+        size_t NumSprites;
+        size_t NumFromCache;
+        size_t NumThreads;
+
+        TTimings()
+            : ReadDecodeMicroSecs(0),
+              BuildMicroSecs(0),
+              TotalMicroSecs(0),
+              NumSprites(0),
+              NumFromCache(0),
+              NumThreads(0)
+        {
+        }
+    };
+
+private:
+    struct TJob
+    {
+        std::string Filename;
+        std::string Ext;
+        TSpriteCache::TSourceInfo Source;
+        TSpriteCache::TEntry const* Cached; // Still matches the source file
+        TFrameBuffer Pixels; // Decoded by TPngDecoder, if not empty
+        TMemoryStream* Data; // File contents left for VCL to decode, owned until built
+        std::string Error; // First error, empty if none
+
+        TJob()
+            : Cached(nullptr),
+              Data(nullptr)
+        {
+        }
+    };
+
+private:
+    size_t m_NumThreads;
+    TSpriteCache const* m_Cache;
+    bool m_CacheStale;
+    std::vector<TJob> m_Jobs;
+    std::vector<TSprite> m_Sprites;
+    TTimings m_Timings;
+
+private:
+    void Build(TJob& job, TSprite& sprite);
+    void FreeData();
+    void ReadAndDecode(TJob& job) const;
+
+public: // Getters/Setters
+    size_t GetCount() const;
+    TSprite& GetSprite(size_t idx);
+    TTimings const& GetTimings() const;
+    bool IsCacheStale() const;
+    void SetCache(TSpriteCache const* cache);
+
+public:
+    explicit TSpriteLoader(size_t numThreads = 0);
+    ~TSpriteLoader();
+
+    TSpriteLoader(TSpriteLoader const&) = delete;
+    TSpriteLoader& operator=(TSpriteLoader const&) = delete;
+
+    size_t Add(std::string const& filename);
+    void Clear();
+    void Run();
+    bool SaveCache(std::string const& fileName) const;
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_SpriteLoaderH
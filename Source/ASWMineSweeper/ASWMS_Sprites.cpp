@@ -22,6 +22,9 @@ limitations under the License.
 // Module header
 #include "ASWMS_Sprites.h"
 //---------------------------------------------------------------------------
+#include <algorithm>
+#include <utility>
+//---------------------------------------------------------------------------
 #include "ASWTools_Path.h"
 #include "ASWTools_String.h"
 //---------------------------------------------------------------------------
@@ -36,6 +39,20 @@ namespace ASWMS
 // TSprites
 /////////////////////////////////////////////////////////////////////////////
 
+TSprites::TGeneralSprite const TSprites::GeneralSprites[TSprites::NumGeneralSprites] =
+{
+    { "Face_Happy.png", &TSprites::FaceHappy },
+    { "Face_Scared.png", &TSprites::FaceScared },
+    { "Face_Toast.png", &TSprites::FaceToast },
+    { "Face_Win.png", &TSprites::FaceWin },
+    { "Flag.png", &TSprites::Flag },
+    { "FlagX.png", &TSprites::FlagX },
+    { "Mine.png", &TSprites::Mine },
+    { "Question.png", &TSprites::Question },
+};
+
+int const TSprites::ZoomPercents[TSprites::NumZoomLevels] = { 50, 75, 100, 125, 150, 200, 300 };
+
 //---------------------------------------------------------------------------
 TSprites::TSprites()
 {
@@ -46,100 +63,184 @@ TSprites::~TSprites()
 {
 }
 //---------------------------------------------------------------------------
-void TSprites::LoadDigits_Proximity(std::string const& digitsDir)
+// Scales the map sprites for every zoom level. 100% shares the loaded images rather than copying them.
+// Tiles are opaque; everything drawn over them is keyed on its bottom-left pixel, so stays keyed when scaled.
+void TSprites::BuildMapSprites()
+{
+    m_MapSprites.clear();
+    m_MapSprites.resize(NumZoomLevels);
+
+    if (Tiles.empty())
+        return;
+
+    int const baseWidth = Tiles[0].GetPixels().GetWidth();
+    int const baseHeight = Tiles[0].GetPixels().GetHeight();
+
+    for (size_t level = 0; level < NumZoomLevels; level++)
+    {
+        TMapSprites& map = m_MapSprites[level];
+        map.ZoomPercent = ZoomPercents[level];
+        map.CellWidth = std::max(1, (baseWidth * map.ZoomPercent + 50) / 100);
+        map.CellHeight = std::max(1, (baseHeight * map.ZoomPercent + 50) / 100);
+
+        if (map.ZoomPercent == 100)
+        {
+            map.Flag = Flag;
+            map.FlagX = FlagX;
+            map.Mine = Mine;
+            map.Question = Question;
+            map.Digits_Proximity = Digits_Proximity;
+            map.Tiles = Tiles;
+            continue;
+        }
+
+        map.Flag = ScaleSprite(Flag, map.ZoomPercent, true);
+        map.FlagX = ScaleSprite(FlagX, map.ZoomPercent, true);
+        map.Mine = ScaleSprite(Mine, map.ZoomPercent, true);
+        map.Question = ScaleSprite(Question, map.ZoomPercent, true);
+
+        map.Digits_Proximity.resize(Digits_Proximity.size());
+        for (size_t i = 0; i < Digits_Proximity.size(); i++)
+            map.Digits_Proximity[i] = ScaleSprite(Digits_Proximity[i], map.ZoomPercent, true);
+
+        map.Tiles.resize(Tiles.size());
+        for (size_t i = 0; i < Tiles.size(); i++)
+            map.Tiles[i] = ScaleSprite(Tiles[i], map.ZoomPercent, false);
+    }
+}
+//---------------------------------------------------------------------------
+// True if the last LoadSprites() wrote a new cache file.
+bool TSprites::GetCacheSaved() const
+{
+    return m_CacheSaved;
+}
+//---------------------------------------------------------------------------
+TSpriteLoader::TTimings const& TSprites::GetLoadTimings() const
+{
+    return m_LoadTimings;
+}
+//---------------------------------------------------------------------------
+// 'zoomLevel' indexes ZoomPercents. Only valid after LoadSprites().
+TSprites::TMapSprites& TSprites::GetMapSprites(size_t zoomLevel)
+{
+    return m_MapSprites.at(std::min(zoomLevel, NumZoomLevels - 1));
+}
+//---------------------------------------------------------------------------
+// Reads and decodes every image in parallel, then fills the sprites in one step at the end. Nothing is assigned
+// unless every image loaded. 'numThreads' of 1 loads serially, which is the baseline for the timings.
+// If 'cacheFile' is set, unchanged images come from it, and it is rewritten when anything changed.
+void TSprites::LoadSprites(std::string const& imagesDir, std::string const& cacheFile, size_t numThreads)
+{
+    Reset();
+
+    if (!TPathTool::Dir_Exists_WinAPI(imagesDir))
+        throw Exception(("Images directory does not exist:\n\n" + imagesDir).c_str());
+
+    TSpriteLoader loader(numThreads);
+
+    // Queued in the same order they are taken below
+    QueueGeneralSprites(loader, TPathTool::Combine(imagesDir, "Sprites"));
+    QueueDigits_Proximity(loader, TPathTool::Combine(imagesDir, "Sprites"));
+    QueueDigits_Score(loader, TPathTool::Combine(imagesDir, "Digits"));
+    QueueTiles(loader, TPathTool::Combine(imagesDir, "Tiles"));
+
+    TSpriteCache cache;
+    if (!cacheFile.empty())
+    {
+        cache.Open(cacheFile);
+        loader.SetCache(&cache);
+    }
+
+    loader.Run();
+
+    // The sprites have their own copy of the pixels now, and the file can't be replaced while it is mapped
+    cache.Close();
+
+    if (!cacheFile.empty() && loader.IsCacheStale())
+        m_CacheSaved = loader.SaveCache(cacheFile);
+
+    size_t idx = 0;
+
+    for (size_t i = 0; i < NumGeneralSprites; i++)
+        TakeSprite(this->*GeneralSprites[i].Member, loader.GetSprite(idx++));
+
+    Digits_Proximity.resize(NumProximityDigits);
+    for (size_t i = 0; i < NumProximityDigits; i++)
+        TakeSprite(Digits_Proximity[i], loader.GetSprite(idx++));
+
+    Digits_Score.resize(BlankScoreDigitIndex + 1);
+    for (size_t i = 0; i <= BlankScoreDigitIndex; i++)
+        TakeSprite(Digits_Score[i], loader.GetSprite(idx++));
+
+    Tiles.resize(NumTiles);
+    for (size_t i = 0; i < NumTiles; i++)
+        TakeSprite(Tiles[i], loader.GetSprite(idx++));
+
+    BuildMapSprites();
+
+    m_LoadTimings = loader.GetTimings();
+}
+//---------------------------------------------------------------------------
+void TSprites::QueueDigits_Proximity(TSpriteLoader& loader, std::string const& digitsDir)
 {
     if (!TPathTool::Dir_Exists_WinAPI(digitsDir))
         throw Exception(("Proximity digits directory does not exist: " + digitsDir).c_str());
 
     std::string filename;
 
-    for (size_t i = 0; i < 8; i++)
+    for (size_t i = 0; i < NumProximityDigits; i++)
     {
-        TSprite sprite;
-        Digits_Proximity.push_back(sprite);
-
 #if __cplusplus >= 201103L
         filename = "Proximity_" + std::to_string(i + 1) + ".png";
 #else
         filename = "Proximity_" + TStrTool::ToStringA(i + 1) + ".png";
 #endif
-        filename = TPathTool::Combine(digitsDir, filename);
-        Digits_Proximity[i].LoadFromFile(filename);
+        loader.Add(TPathTool::Combine(digitsDir, filename));
     }
 }
 //---------------------------------------------------------------------------
-void TSprites::LoadDigits_Score(std::string const& digitsDir)
+void TSprites::QueueDigits_Score(TSpriteLoader& loader, std::string const& digitsDir)
 {
     if (!TPathTool::Dir_Exists_WinAPI(digitsDir))
         throw Exception(("Digits directory does not exist: " + digitsDir).c_str());
 
     std::string filename;
 
-    for (size_t i = 0; i < 10; i++)
+    for (size_t i = 0; i < BlankScoreDigitIndex; i++)
     {
-        TSprite sprite;
-        Digits_Score.push_back(sprite);
-
 #if __cplusplus >= 201103L
         filename = "Digit_" + std::to_string(i) + ".png";
 #else
         filename = "Digit_" + TStrTool::ToStringA(i) + ".png";
 #endif
-        filename = TPathTool::Combine(digitsDir, filename);
-        Digits_Score[i].LoadFromFile(filename);
+        loader.Add(TPathTool::Combine(digitsDir, filename));
     }
 
-    TSprite sprite;
-    Digits_Score.push_back(sprite);
-    filename = TPathTool::Combine(digitsDir, "Digit_Blank.png");
-    Digits_Score[Digits_Score.size() - 1].LoadFromFile(filename);
+    loader.Add(TPathTool::Combine(digitsDir, "Digit_Blank.png"));
 }
 //---------------------------------------------------------------------------
-void TSprites::LoadGeneralSprites(std::string const& spritesDir)
+void TSprites::QueueGeneralSprites(TSpriteLoader& loader, std::string const& spritesDir)
 {
     if (!TPathTool::Dir_Exists_WinAPI(spritesDir))
         throw Exception(("Sprites directory does not exist: " + spritesDir).c_str());
 
-    FaceHappy.LoadFromFile(TPathTool::Combine(spritesDir, "Face_Happy.png"));
-    FaceScared.LoadFromFile(TPathTool::Combine(spritesDir, "Face_Scared.png"));
-    FaceToast.LoadFromFile(TPathTool::Combine(spritesDir, "Face_Toast.png"));
-    FaceWin.LoadFromFile(TPathTool::Combine(spritesDir, "Face_Win.png"));
-    Flag.LoadFromFile(TPathTool::Combine(spritesDir, "Flag.png"));
-    FlagX.LoadFromFile(TPathTool::Combine(spritesDir, "FlagX.png"));
-    Mine.LoadFromFile(TPathTool::Combine(spritesDir, "Mine.png"));
-    Question.LoadFromFile(TPathTool::Combine(spritesDir, "Question.png"));
+    for (size_t i = 0; i < NumGeneralSprites; i++)
+        loader.Add(TPathTool::Combine(spritesDir, GeneralSprites[i].Filename));
 }
 //---------------------------------------------------------------------------
-void TSprites::LoadSprites(std::string const& imagesDir)
-{
-    Reset();
-
-    if (!TPathTool::Dir_Exists_WinAPI(imagesDir))
-        throw Exception(("Images directory does not exist:\n\n" + imagesDir).c_str());
-
-    LoadGeneralSprites(TPathTool::Combine(imagesDir, "Sprites"));
-    LoadDigits_Proximity(TPathTool::Combine(imagesDir, "Sprites"));
-    LoadDigits_Score(TPathTool::Combine(imagesDir, "Digits"));
-    LoadTiles(TPathTool::Combine(imagesDir, "Tiles"));
-}
-//---------------------------------------------------------------------------
-void TSprites::LoadTiles(std::string const& tilesDir)
+void TSprites::QueueTiles(TSpriteLoader& loader, std::string const& tilesDir)
 {
     if (!TPathTool::Dir_Exists_WinAPI(tilesDir))
         throw Exception(("Tiles directory does not exist: " + tilesDir).c_str());
 
-    TSprite sprite;
-
-    sprite.LoadFromFile(TPathTool::Combine(tilesDir, "Covered.png"));
-    Tiles.push_back(sprite);
-    sprite.LoadFromFile(TPathTool::Combine(tilesDir, "Covered_Clicked.png"));
-    Tiles.push_back(sprite);
-    sprite.LoadFromFile(TPathTool::Combine(tilesDir, "Covered_Lit.png"));
-    Tiles.push_back(sprite);
-    sprite.LoadFromFile(TPathTool::Combine(tilesDir, "Uncovered.png"));
-    Tiles.push_back(sprite);
-    sprite.LoadFromFile(TPathTool::Combine(tilesDir, "Uncovered_Boom.png"));
-    Tiles.push_back(sprite);
+    // Same order as ETile
+    static char const* const tileFiles[NumTiles] =
+    {
+        "Covered.png", "Covered_Clicked.png", "Covered_Lit.png", "Uncovered.png", "Uncovered_Boom.png",
+    };
+
+    for (size_t i = 0; i < NumTiles; i++)
+        loader.Add(TPathTool::Combine(tilesDir, tileFiles[i]));
 }
 //---------------------------------------------------------------------------
 void TSprites::Reset()
@@ -147,6 +248,7 @@ void TSprites::Reset()
     Digits_Proximity.clear();
     Digits_Score.clear();
     Tiles.clear();
+    m_MapSprites.clear();
 
     FaceHappy.Reset();
     FaceScared.Reset();
@@ -156,6 +258,23 @@ void TSprites::Reset()
     FlagX.Reset();
     Mine.Reset();
     Question.Reset();
+
+    m_LoadTimings = TSpriteLoader::TTimings();
+    m_CacheSaved = false;
+}
+//---------------------------------------------------------------------------
+// Overlays can be a different size to the tiles, so each one scales by the zoom on its own.
+TSprite TSprites::ScaleSprite(TSprite const& src, int zoomPercent, bool keyed)
+{
+    TFrameBuffer const& pixels = src.GetPixels();
+    int const width = std::max(1, (pixels.GetWidth() * zoomPercent + 50) / 100);
+    int const height = std::max(1, (pixels.GetHeight() * zoomPercent + 50) / 100);
+    return src.Scaled(width, height, keyed);
+}
+//---------------------------------------------------------------------------
+void TSprites::TakeSprite(TSprite& dst, TSprite& src)
+{
+    dst = std::move(src);
 }
 //---------------------------------------------------------------------------
 
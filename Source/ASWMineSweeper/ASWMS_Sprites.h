@@ -25,6 +25,7 @@ limitations under the License.
 #include <vector>
 //---------------------------------------------------------------------------
 #include "ASWMS_Sprite.h"
+#include "ASWMS_SpriteLoader.h"
 //---------------------------------------------------------------------------
 
 namespace ASWMS
@@ -45,23 +46,76 @@ enum class ETile
 /////////////////////////////////////////////////////////////////////////////
 class TSprites
 {
+private:
+    // Named single sprites, in load order
+    struct TGeneralSprite
+    {
+        char const* Filename;
+        TSprite TSprites::* Member;
+    };
+
+private: // Static vars
+    static size_t const NumGeneralSprites = 8;
+    static TGeneralSprite const GeneralSprites[NumGeneralSprites];
+
 public: // Static vars
     static size_t const BlankScoreDigitIndex = 10;
+    static size_t const NumProximityDigits = 8;
+    static size_t const NumTiles = 5;
+
+    static size_t const NumZoomLevels = 7;
+    static int const ZoomPercents[NumZoomLevels];
+    static size_t const DefaultZoomLevel = 2; // 100%
 
 public:
     typedef std::vector<TSprite> TSpriteList;
 
+    // The sprites drawn on the map, scaled for one zoom level. Built once per load, so zooming never scales
+    // anything while drawing.
+    struct TMapSprites
+    {
+        int ZoomPercent;
+        int CellWidth;
+        int CellHeight;
+        TSprite Flag;
+        TSprite FlagX;
+        TSprite Mine;
+        TSprite Question;
+        TSpriteList Digits_Proximity;
+        TSpriteList Tiles;
+
+        TMapSprites()
+            : ZoomPercent(0),
+              CellWidth(0),
+              CellHeight(0)
+        {
+        }
+    };
+
+private:
+    TSpriteLoader::TTimings m_LoadTimings;
+    bool m_CacheSaved;
+    std::vector<TMapSprites> m_MapSprites; // One per zoom level
+
 private:
-    void LoadDigits_Proximity(std::string const& digitsDir);
-    void LoadDigits_Score(std::string const& digitsDir);
-    void LoadGeneralSprites(std::string const& spritesDir);
-    void LoadTiles(std::string const& tilesDir);
+    void BuildMapSprites();
+    void QueueDigits_Proximity(TSpriteLoader& loader, std::string const& digitsDir);
+    void QueueDigits_Score(TSpriteLoader& loader, std::string const& digitsDir);
+    void QueueGeneralSprites(TSpriteLoader& loader, std::string const& spritesDir);
+    void QueueTiles(TSpriteLoader& loader, std::string const& tilesDir);
+    static TSprite ScaleSprite(TSprite const& src, int zoomPercent, bool keyed);
+    static void TakeSprite(TSprite& dst, TSprite& src);
+
+public: // Getters/Setters
+    bool GetCacheSaved() const;
+    TSpriteLoader::TTimings const& GetLoadTimings() const;
+    TMapSprites& GetMapSprites(size_t zoomLevel);
 
 public:
     TSprites();
     ~TSprites();
 
-    void LoadSprites(std::string const& imagesDir);
+    void LoadSprites(std::string const& imagesDir, std::string const& cacheFile = "", size_t numThreads = 0);
     void Reset();
 
 public:
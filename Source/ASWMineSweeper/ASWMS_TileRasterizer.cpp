@@ -0,0 +1,95 @@
+/* **************************************************************************
+ASWMS_TileRasterizer.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWMS_TileRasterizer.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+//---------------------------------------------------------------------------
+using namespace ASWTools;
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+//---------------------------------------------------------------------------
+TTileRasterizer::TTileRasterizer()
+    : m_Pool(nullptr),
+      m_NumThreads(std::min<size_t>(TThreadPool::GetHardwareThreadCount(), 8))
+{
+}
+//---------------------------------------------------------------------------
+TTileRasterizer::~TTileRasterizer()
+{
+    delete m_Pool;
+}
+//---------------------------------------------------------------------------
+TThreadPool& TTileRasterizer::GetPool()
+{
+    if (nullptr == m_Pool)
+        m_Pool = new TThreadPool(m_NumThreads);
+    return *m_Pool;
+}
+//---------------------------------------------------------------------------
+size_t TTileRasterizer::GetThreadCount() const
+{
+    return m_NumThreads;
+}
+//---------------------------------------------------------------------------
+// Draws every cell. The frame buffer must already be sized to hold nCols x nRows cells.
+void TTileRasterizer::Rasterize(TFrameBuffer& frameBuffer, size_t nRows, size_t nCols, int cellWidth,
+    int cellHeight, TDrawCellFunc const& drawCell)
+{
+    if (0 == nRows || 0 == nCols)
+        return;
+
+    size_t const numBands = m_NumThreads * BandsPerThread;
+    size_t const rowsPerBand = std::max<size_t>(1, (nRows + numBands - 1) / numBands);
+
+    GetPool().ParallelFor(nRows, rowsPerBand,
+        [&frameBuffer, nCols, cellWidth, cellHeight, &drawCell](size_t beginRow, size_t endRow)
+        {
+            for (size_t row = beginRow; row < endRow; row++)
+            {
+                int const yPos = static_cast<int>(row) * cellHeight;
+
+                for (size_t col = 0; col < nCols; col++)
+                    drawCell(frameBuffer, row, col, static_cast<int>(col) * cellWidth, yPos);
+            }
+        });
+}
+//---------------------------------------------------------------------------
+// 1 draws on the calling thread only. 0 uses one thread per hardware thread.
+void TTileRasterizer::SetThreadCount(size_t numThreads)
+{
+    if (0 == numThreads)
+        numThreads = TThreadPool::GetHardwareThreadCount();
+
+    if (numThreads == m_NumThreads)
+        return;
+
+    delete m_Pool;
+    m_Pool = nullptr;
+    m_NumThreads = numThreads;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWMS
@@ -0,0 +1,77 @@
+/* **************************************************************************
+ASWMS_TileRasterizer.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWMS_TileRasterizerH
+#define ASWMS_TileRasterizerH
+//---------------------------------------------------------------------------
+#include <functional>
+#include <stddef.h>
+//---------------------------------------------------------------------------
+#include "ASWMS_FrameBuffer.h"
+#include "ASWTools_ThreadPool.h"
+//---------------------------------------------------------------------------
+
+namespace ASWMS
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TTileRasterizer
+//
+// Draws a whole grid of equally sized cells into a frame buffer, split into
+// horizontal bands of cell rows that are drawn in parallel. Bands never
+// share a cell, so the draw callback only has to be safe for different
+// cells at the same time, and must not write outside its own cell (see
+// TFrameBuffer::TClipRect). Portable - no VCL/GDI - so it can be timed
+// headless.
+/////////////////////////////////////////////////////////////////////////////
+class TTileRasterizer
+{
+public: // Static vars
+    static size_t const BandsPerThread = 4; // Extra bands even out uneven rows
+
+public:
+    typedef std::function<void(TFrameBuffer& frameBuffer, size_t row, size_t col, int xPos, int yPos)> TDrawCellFunc;
+
+private:
+    ASWTools::TThreadPool* m_Pool; // Created on first use
+    size_t m_NumThreads;
+
+private:
+    ASWTools::TThreadPool& GetPool();
+
+public: // Getters/Setters
+    size_t GetThreadCount() const;
+    void SetThreadCount(size_t numThreads);
+
+public:
+    TTileRasterizer();
+    ~TTileRasterizer();
+
+    TTileRasterizer(TTileRasterizer const&) = delete;
+    TTileRasterizer& operator=(TTileRasterizer const&) = delete;
+
+    void Rasterize(TFrameBuffer& frameBuffer, size_t nRows, size_t nCols, int cellWidth, int cellHeight,
+        TDrawCellFunc const& drawCell);
+};
+
+} // namespace ASWMS
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWMS_TileRasterizerH
@@ -24,7 +24,7 @@ limitations under the License.
 // Module header
 #include "ASWTools_BasicINI.h"
 //---------------------------------------------------------------------------
-#include <memory>
+#include <cstring>
 //---------------------------------------------------------------------------
 #include "ASWTools_Path.h"
 #include "ASWTools_String.h"
@@ -36,6 +36,183 @@ namespace ASWTools
 namespace BasicINI
 {
 
+namespace
+{
+
+char const FileLineEnd[] = "\r\n"; //what "\n" written in text mode gave, so saved files don't change
+
+//---------------------------------------------------------------------------
+char* AppendText(char* dest, TStrView text)
+{
+    if (text.size() > 0)
+        memcpy(dest, text.data(), text.size());
+
+    return dest + text.size();
+}
+//---------------------------------------------------------------------------
+bool GetFileStamp(std::string const& fileName, uint64_t* size, uint64_t* lastWriteTime)
+{
+    FILETIME lastWrite;
+
+    if (!TPathTool::File_GetSizeAndLastWriteTime(TStrTool::Utf8ToUnicodeStr(fileName), *size, lastWrite))
+        return false;
+
+    *lastWriteTime = (static_cast<uint64_t>(lastWrite.dwHighDateTime) << 32) | lastWrite.dwLowDateTime;
+    return true;
+}
+//---------------------------------------------------------------------------
+bool NameMatches(TStrView name, TStrView find, bool ignoreCase)
+{
+    if (ignoreCase)
+        return TStrTool::EqualsIC(find, name);
+
+    return name == find;
+}
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TINIText
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TINIText& TINIText::operator=(TINIText const& rhs)
+{
+    if (this != &rhs)
+        Assign(rhs.data(), rhs.size());
+
+    return *this;
+}
+//---------------------------------------------------------------------------
+TINIText& TINIText::operator=(std::string const& str)
+{
+    m_ViewData = nullptr;
+    m_ViewSize = 0;
+    m_Owned = str;
+    return *this;
+}
+//---------------------------------------------------------------------------
+TINIText& TINIText::operator=(char const* str)
+{
+    m_ViewData = nullptr;
+    m_ViewSize = 0;
+    m_Owned = nullptr == str ? "" : str;
+    return *this;
+}
+//---------------------------------------------------------------------------
+#if __cplusplus >= 201103L
+TINIText& TINIText::operator=(TINIText&& rhs) noexcept
+{
+    m_ViewData = rhs.m_ViewData;
+    m_ViewSize = rhs.m_ViewSize;
+    m_Owned = std::move(rhs.m_Owned);
+    return *this;
+}
+//---------------------------------------------------------------------------
+TINIText& TINIText::operator=(std::string&& str)
+{
+    m_ViewData = nullptr;
+    m_ViewSize = 0;
+    m_Owned = std::move(str);
+    return *this;
+}
+#endif // #if __cplusplus >= 201103L
+//---------------------------------------------------------------------------
+// -Copies 'data' into the owned string. 'data' may point into this text.
+void TINIText::Assign(char const* data, size_t size)
+{
+    m_Owned.assign(data, size);
+    m_ViewData = nullptr;
+    m_ViewSize = 0;
+}
+//---------------------------------------------------------------------------
+// -Points at 'data' without copying it. The caller keeps 'data' alive for as long as this text views it.
+void TINIText::SetView(char const* data, size_t size)
+{
+    m_Owned.clear();
+    m_ViewData = data;
+    m_ViewSize = size;
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TNameIndex
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TNameIndex::TNameIndex()
+    : m_Built(false)
+{
+}
+//---------------------------------------------------------------------------
+// -Static
+// -FNV-1a over the name with ASCII folded to lower case. Bytes from 0x80 up all hash alike, since EqualsIC() may
+//  fold them through the locale, and names that compare equal must hash equal.
+uint32_t TNameIndex::HashName(TStrView name)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < name.size(); i++)
+    {
+        unsigned char c = static_cast<unsigned char>(name[i]);
+
+        if (c >= 'A' && c <= 'Z')
+            c = static_cast<unsigned char>(c + ('a' - 'A'));
+        else if (c >= 0x80)
+            c = 0x80;
+
+        hash = (hash ^ c) * 16777619u;
+    }
+
+    return hash;
+}
+//---------------------------------------------------------------------------
+void TNameIndex::Invalidate()
+{
+    m_Chains.clear();
+    m_Next.clear();
+    m_Built = false;
+}
+//---------------------------------------------------------------------------
+// -Empties the index and marks it built, ready for 'entryCount' calls to Append() in list order.
+void TNameIndex::Start(size_t entryCount)
+{
+    Invalidate();
+    m_Chains.reserve(entryCount);
+    m_Next.reserve(entryCount);
+    m_Built = true;
+}
+//---------------------------------------------------------------------------
+// -Indexes the entry after the last one indexed.
+void TNameIndex::Append(TStrView name)
+{
+    size_t const idx = m_Next.size();
+    TChain const chain = { idx, idx };
+
+    m_Next.push_back(static_cast<size_t>(NotFound)); //a copy - push_back() would bind a reference to NotFound
+
+    std::pair<std::unordered_map<uint32_t, TChain>::iterator, bool> inserted =
+        m_Chains.insert(std::make_pair(HashName(name), chain));
+
+    if (!inserted.second)
+    {
+        m_Next[inserted.first->second.Last] = idx;
+        inserted.first->second.Last = idx;
+    }
+}
+//---------------------------------------------------------------------------
+// -The first entry whose name may match 'name', or NotFound. Follow with Next() - the chain holds every entry with
+//  the same hash, in list order.
+size_t TNameIndex::First(TStrView name) const
+{
+    std::unordered_map<uint32_t, TChain>::const_iterator it = m_Chains.find(HashName(name));
+    return m_Chains.end() == it ? NotFound : it->second.First;
+}
+//---------------------------------------------------------------------------
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TKeyVal
 /////////////////////////////////////////////////////////////////////////////
@@ -100,6 +277,7 @@ bool TKeyVal::IsEmpty() const
 
 //---------------------------------------------------------------------------
 TSection::TSection()
+    : m_Dirty(false)
 {
 }
 //---------------------------------------------------------------------------
@@ -111,6 +289,8 @@ TSection& TSection::operator=(TSection const& rhs)
 {
     Name = rhs.Name;
     KeyVals = rhs.KeyVals;
+    m_KeyIndex.Invalidate();
+    m_Dirty = true;
     return *this;
 }
 //---------------------------------------------------------------------------
@@ -119,6 +299,76 @@ void TSection::Reset()
     //reset class vars here
     Name = "";
     KeyVals.clear();
+    m_KeyIndex.Invalidate();
+    m_Dirty = true;
+}
+//---------------------------------------------------------------------------
+// -Builds the key index if KeyVals is long enough to be worth it. Returns false if FindKey() should scan instead.
+bool TSection::UseKeyIndex() const
+{
+    if (KeyVals.size() < TNameIndex::MinEntries)
+        return false;
+
+    if (!m_KeyIndex.IsBuilt(KeyVals.size()))
+    {
+        m_KeyIndex.Start(KeyVals.size());
+
+        for (size_t i = 0; i < KeyVals.size(); i++)
+            m_KeyIndex.Append(KeyVals[i].Key);
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// -Call after adding to the end of KeyVals. Keeps a built index up to date, or drops it if KeyVals was changed some
+//  other way since it was built.
+void TSection::IndexAddedKeyVal()
+{
+    if (m_KeyIndex.IsBuilt(KeyVals.size() - 1))
+        m_KeyIndex.Append(KeyVals.back().Key);
+    else
+        m_KeyIndex.Invalidate();
+}
+//---------------------------------------------------------------------------
+// -Needed only after renaming keys in place. Adding, inserting and deleting through TSection keep the index right.
+void TSection::InvalidateIndex()
+{
+    m_KeyIndex.Invalidate();
+}
+//---------------------------------------------------------------------------
+// -Marks the section dirty only if the name changes. The owning TBasicINI's index is not updated - see
+//  TBasicINI::InvalidateIndex().
+void TSection::SetName(TStrView name)
+{
+    if (Name == name)
+        return;
+
+    Name.Assign(name.data(), name.size());
+    m_Dirty = true;
+}
+//---------------------------------------------------------------------------
+// -Sets the key and value at 'index', marking the section dirty only if either changes.
+bool TSection::SetKeyVal(size_t index, TStrView key, TStrView value)
+{
+    if (index >= KeyVals.size())
+        return false;
+
+    TKeyVal* keyValP = &KeyVals[index];
+
+    if (keyValP->Key != key)
+    {
+        keyValP->Key.Assign(key.data(), key.size());
+        m_KeyIndex.Invalidate();
+        m_Dirty = true;
+    }
+
+    if (keyValP->Value != value)
+    {
+        keyValP->Value.Assign(value.data(), value.size());
+        m_Dirty = true;
+    }
+
+    return true;
 }
 //---------------------------------------------------------------------------
 bool TSection::IsGlobalSection()
@@ -142,6 +392,8 @@ bool TSection::AddKeyVal(TKeyVal const& keyVal)
     //	return false;
 
     KeyVals.push_back(keyVal);
+    IndexAddedKeyVal();
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
@@ -184,12 +436,15 @@ bool TSection::InsertKeyVal(size_t index, TKeyVal const& keyVal)
     if (index >= KeyVals.size())
     {
         KeyVals.push_back(keyVal);
+        IndexAddedKeyVal();
     }
     else
     {
         std::vector<TKeyVal>::iterator itIdx = KeyVals.begin() + static_cast<std::ptrdiff_t>(index);
         KeyVals.insert(itIdx, keyVal);
+        m_KeyIndex.Invalidate(); //every later entry moved - rebuilt by the next FindKey()
     }
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
@@ -217,21 +472,29 @@ bool TSection::DeleteKeyVal(size_t index)
 
     std::vector<TKeyVal>::iterator itIdx = KeyVals.begin() + static_cast<std::ptrdiff_t>(index);
     KeyVals.erase(itIdx);
+    m_KeyIndex.Invalidate(); //every later entry moved - rebuilt by the next FindKey()
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
-size_t TSection::FindKey(std::string const& key, bool ignoreCase) const
+// -Duplicate keys are allowed - this finds the first.
+size_t TSection::FindKey(TStrView key, bool ignoreCase) const
 {
-    for (size_t i = 0; i < KeyVals.size(); i++)
+    if (UseKeyIndex())
     {
-        TKeyVal const* keyValP = &KeyVals[i];
-
-        if ((key.length() == 0 && keyValP->Key.length() == 0) ||
-            (ignoreCase && _stricmp(key.c_str(), keyValP->Key.c_str()) == 0) ||
-            (!ignoreCase && strcmp(key.c_str(), keyValP->Key.c_str()) == 0))
+        for (size_t i = m_KeyIndex.First(key); TNameIndex::NotFound != i; i = m_KeyIndex.Next(i))
         {
-            return i;
+            if (NameMatches(KeyVals[i].Key, key, ignoreCase))
+                return i;
         }
+
+        return NotFound;
+    }
+
+    for (size_t i = 0; i < KeyVals.size(); i++)
+    {
+        if (NameMatches(KeyVals[i].Key, key, ignoreCase))
+            return i;
     }
 
     return NotFound;
@@ -246,24 +509,20 @@ size_t TSection::FindOrCreateKey(std::string const& key, bool ignoreCase)
         KeyVals.push_back(TKeyVal());
         size_t insertIdx = KeyVals.size() - 1;
         KeyVals[insertIdx].Key = key;
+        IndexAddedKeyVal();
+        m_Dirty = true;
         idx = insertIdx;
     }
 
     return idx;
 }
 //---------------------------------------------------------------------------
-size_t TSection::FindVal(std::string const& value, bool ignoreCase) const
+size_t TSection::FindVal(TStrView value, bool ignoreCase) const
 {
     for (size_t i = 0; i < KeyVals.size(); i++)
     {
-        TKeyVal const* keyValP = &KeyVals[i];
-
-        if ((value.length() == 0 && keyValP->Value.length() == 0) ||
-            (ignoreCase && _stricmp(value.c_str(), keyValP->Value.c_str()) == 0) ||
-            (!ignoreCase && strcmp(value.c_str(), keyValP->Value.c_str()) == 0))
-        {
+        if (NameMatches(KeyVals[i].Value, value, ignoreCase))
             return i;
-        }
     }
 
     return NotFound;
@@ -279,36 +538,78 @@ bool TSection::HasOneOrMoreKeyValuePairs() const
     return false;
 }
 //---------------------------------------------------------------------------
-EErrINI TSection::Save(FILE* fOut, char const assignOperator, std::string const& paddingAfterOperator)
+// -The exact number of chars SaveTo() writes.
+size_t TSection::GetSaveSize(char const assignOperator, TStrView paddingAfterOperator, TStrView lineEnd) const
 {
-    if (nullptr == fOut)
+    (void)assignOperator; //always one char
+
+    size_t size = 0;
+
+    if (Name.length() > 0)
+        size += TStrTool::Trim_View(Name).size() + lineEnd.size();
+
+    for (size_t i = 0; i < KeyVals.size(); i++)
     {
-        return EErrINI::EI_BadParameter;
-    }
+        TKeyVal const* keyValP = &KeyVals[i];
+        size_t const keyLen = TStrTool::Trim_View(keyValP->Key).size();
 
-    EErrINI result = EErrINI::EI_NoError;
-    bool writeErr = false;
+        if (keyLen > 0)
+            size += keyLen + 1 + paddingAfterOperator.size();
+
+        size += keyValP->Value.size() + lineEnd.size();
+    }
 
+    return size;
+}
+//---------------------------------------------------------------------------
+// -Writes the section as text to 'dest', which must have room for GetSaveSize() chars. Returns the end of what was
+//  written. No null terminator.
+char* TSection::SaveTo(char* dest, char const assignOperator, TStrView paddingAfterOperator, TStrView lineEnd) const
+{
     if (Name.length() > 0)
-        writeErr |= -1 == fprintf(fOut, "%s\n", TStrTool::Trim_Copy(Name).c_str());
+    {
+        dest = AppendText(dest, TStrTool::Trim_View(Name));
+        dest = AppendText(dest, lineEnd);
+    }
 
-    for (size_t i = 0; i < KeyVals.size() && !writeErr; i++)
+    for (size_t i = 0; i < KeyVals.size(); i++)
     {
-        TKeyVal* keyValP = &KeyVals[i];
-        std::string key = TStrTool::Trim_Copy(keyValP->Key);
+        TKeyVal const* keyValP = &KeyVals[i];
+        TStrView const key = TStrTool::Trim_View(keyValP->Key);
+
+        //if there is no key, write the value as is (could be a comment line, or a value only line)
+        if (key.length() > 0)
+        {
+            dest = AppendText(dest, key);
+            *dest++ = assignOperator;
+            dest = AppendText(dest, paddingAfterOperator);
+        }
 
-        if (key.length() == 0) //if there is no key, write the value as is (could be a comment line, or a value only line
-            writeErr |= -1 == fprintf(fOut, "%s\n", keyValP->Value.c_str());
-        else
-            writeErr |= -1 == fprintf(fOut, "%s%c%s%s\n", key.c_str(), assignOperator, paddingAfterOperator.c_str(), keyValP->Value.c_str());
+        dest = AppendText(dest, keyValP->Value);
+        dest = AppendText(dest, lineEnd);
     }
 
-    if (writeErr)
+    return dest;
+}
+//---------------------------------------------------------------------------
+EErrINI TSection::Save(FILE* fOut, char const assignOperator, std::string const& paddingAfterOperator)
+{
+    if (nullptr == fOut)
     {
-        result = EErrINI::EI_WriteError;
+        return EErrINI::EI_BadParameter;
     }
 
-    return result;
+    std::string text(GetSaveSize(assignOperator, paddingAfterOperator, "\n"), '\0');
+    if (text.empty())
+        return EErrINI::EI_NoError;
+
+    SaveTo(&text[0], assignOperator, paddingAfterOperator, "\n");
+
+    //flushed here so a full disk shows up as an error now, not at fclose()
+    if (::fwrite(text.data(), 1, text.size(), fOut) != text.size() || ::fflush(fOut) != 0)
+        return EErrINI::EI_WriteError;
+
+    return EErrINI::EI_NoError;
 }
 //---------------------------------------------------------------------------
 
@@ -347,7 +648,11 @@ bool TBasicINI::Reset_Private()
     PaddingAfterOperator_Write = "";
     AlternateAssignOperator_Read = ':';
 
-    Sections.clear();
+    Sections.clear(); //before the text they may view
+    m_LoadedText.clear();
+    m_SectionIndex.Invalidate();
+    m_Dirty = false;
+    ClearDiskStamp();
 
     return true;
 }
@@ -357,15 +662,54 @@ bool TBasicINI::Reset() //virtual
     return Reset_Private();
 }
 //---------------------------------------------------------------------------
+// -Builds the section index if Sections is long enough to be worth it. Returns false if FindSection() should scan
+//  instead.
+bool TBasicINI::UseSectionIndex() const
+{
+    if (Sections.size() < TNameIndex::MinEntries)
+        return false;
+
+    if (!m_SectionIndex.IsBuilt(Sections.size()))
+    {
+        m_SectionIndex.Start(Sections.size());
+
+        for (size_t i = 0; i < Sections.size(); i++)
+            m_SectionIndex.Append(Sections[i].Name);
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// -Call after adding to the end of Sections. Keeps a built index up to date, or drops it if Sections was changed
+//  some other way since it was built.
+void TBasicINI::IndexAddedSection()
+{
+    if (m_SectionIndex.IsBuilt(Sections.size() - 1))
+        m_SectionIndex.Append(Sections.back().Name);
+    else
+        m_SectionIndex.Invalidate();
+}
+//---------------------------------------------------------------------------
+// -Needed only after renaming sections in place. Adding, inserting and deleting through TBasicINI keep the index
+//  right.
+void TBasicINI::InvalidateIndex()
+{
+    m_SectionIndex.Invalidate();
+}
+//---------------------------------------------------------------------------
 bool TBasicINI::AddSection()
 {
     Sections.push_back(TSection());
+    IndexAddedSection();
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
 bool TBasicINI::AddSection(TSection const& section)
 {
     Sections.push_back(section);
+    IndexAddedSection();
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
@@ -379,13 +723,16 @@ bool TBasicINI::InsertSection(size_t index, TSection const& section)
     if (index >= Sections.size())
     {
         Sections.push_back(section);
+        IndexAddedSection();
     }
     else
     {
         std::vector<TSection>::iterator itIdx = Sections.begin() + static_cast<std::ptrdiff_t>(index);
         Sections.insert(itIdx, section);
+        m_SectionIndex.Invalidate(); //every later section moved - rebuilt by the next FindSection()
     }
 
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
@@ -396,18 +743,27 @@ bool TBasicINI::DeleteSection(size_t index)
 
     std::vector<TSection>::iterator itIdx = Sections.begin() + static_cast<std::ptrdiff_t>(index);
     Sections.erase(itIdx);
+    m_SectionIndex.Invalidate(); //every later section moved - rebuilt by the next FindSection()
+    m_Dirty = true;
     return true;
 }
 //---------------------------------------------------------------------------
-size_t TBasicINI::FindSection(const std::string& sectionName, bool ignoreCase) const
+size_t TBasicINI::FindSection(TStrView sectionName, bool ignoreCase) const
 {
-    for (size_t i = 0; i < Sections.size(); i++)
+    if (UseSectionIndex())
     {
-        TSection const* secP = &Sections[i];
+        for (size_t i = m_SectionIndex.First(sectionName); TNameIndex::NotFound != i; i = m_SectionIndex.Next(i))
+        {
+            if (NameMatches(Sections[i].Name, sectionName, ignoreCase))
+                return i;
+        }
+
+        return TSection::NotFound;
+    }
 
-        if ((sectionName.length() == 0 && secP->Name.length() == 0) ||
-            (ignoreCase && _stricmp(sectionName.c_str(), secP->Name.c_str()) == 0) ||
-            (!ignoreCase && strcmp(sectionName.c_str(), secP->Name.c_str()) == 0))
+    for (size_t i = 0; i < Sections.size(); i++)
+    {
+        if (NameMatches(Sections[i].Name, sectionName, ignoreCase))
             return i;
     }
 
@@ -429,14 +785,106 @@ size_t TBasicINI::FindOrCreateSection(std::string const& sectionName, bool ignor
         Sections.push_back(TSection());
         size_t insertIdx = Sections.size() - 1;
         Sections[insertIdx].Name = sectionName;
+        IndexAddedSection();
+        m_Dirty = true;
         idx = insertIdx;
     }
 
     return idx;
 }
 //---------------------------------------------------------------------------
+void TBasicINI::ClearDiskStamp()
+{
+    m_DiskStamp.FileName.clear();
+    m_DiskStamp.Size = 0;
+    m_DiskStamp.LastWriteTime = 0;
+    m_DiskStamp.AssignOperator = DefaultAssignOperator;
+    m_DiskStamp.PaddingAfterOperator.clear();
+    m_DiskStamp.FromLoad = false;
+    m_DiskStamp.MaxLineLen = 0;
+}
+//---------------------------------------------------------------------------
+// -Records 'fileNameINI', as it was at 'size' and 'lastWriteTime', as matching the document.
+void TBasicINI::SetDiskStamp(std::string const& fileNameINI, uint64_t size, uint64_t lastWriteTime,
+    char const assignOperator, bool fromLoad, size_t maxLineLen)
+{
+    m_DiskStamp.FileName = fileNameINI;
+    m_DiskStamp.Size = size;
+    m_DiskStamp.LastWriteTime = lastWriteTime;
+    m_DiskStamp.AssignOperator = assignOperator;
+    m_DiskStamp.PaddingAfterOperator = PaddingAfterOperator_Write;
+    m_DiskStamp.FromLoad = fromLoad;
+    m_DiskStamp.MaxLineLen = maxLineLen;
+}
+//---------------------------------------------------------------------------
+// -True if 'fileNameINI' is the stamped file, with the same size and last write time, and would be written the same
+//  way. Whether the document itself changed is up to IsDirty().
+bool TBasicINI::IsDiskStampCurrent(std::string const& fileNameINI, char const assignOperator) const
+{
+    if (m_DiskStamp.FileName.empty() || m_DiskStamp.FileName != fileNameINI ||
+        m_DiskStamp.AssignOperator != assignOperator || m_DiskStamp.PaddingAfterOperator != PaddingAfterOperator_Write)
+    {
+        return false;
+    }
+
+    uint64_t size = 0;
+    uint64_t lastWriteTime = 0;
+
+    if (!GetFileStamp(fileNameINI, &size, &lastWriteTime))
+        return false;
+
+    return size == m_DiskStamp.Size && lastWriteTime == m_DiskStamp.LastWriteTime;
+}
+//---------------------------------------------------------------------------
+// -True if anything was added, inserted, deleted or set since the last Load(), Save() or SetDirty(false).
+bool TBasicINI::IsDirty() const //virtual
+{
+    if (m_Dirty)
+        return true;
+
+    for (size_t i = 0; i < Sections.size(); i++)
+    {
+        if (Sections[i].IsDirty())
+            return true;
+    }
+
+    return false;
+}
+//---------------------------------------------------------------------------
+// -Clearing also clears every section.
+void TBasicINI::SetDirty(bool dirty)
+{
+    m_Dirty = dirty;
+
+    if (dirty)
+        return;
+
+    for (size_t i = 0; i < Sections.size(); i++)
+        Sections[i].SetDirty(false);
+}
+//---------------------------------------------------------------------------
+// -True if Load() with these arguments would give what is already parsed: nothing is dirty, and the file is the one
+//  last loaded, with the same size and last write time.
+bool TBasicINI::IsLoadCurrent(std::string const& fileNameINI, char const assignOperator, size_t maxLineLen) const
+{
+    if (!m_DiskStamp.FromLoad || m_DiskStamp.MaxLineLen != maxLineLen)
+        return false;
+
+    return !IsDirty() && IsDiskStampCurrent(fileNameINI, assignOperator);
+}
+//---------------------------------------------------------------------------
+/*
+    TBasicINI::Load
+
+    - If IsLoadCurrent(), the document already parsed is kept and nothing is read.
+*/
 EErrINI TBasicINI::Load(std::string const& fileNameINI, char const assignOperator, size_t maxLineLen)
 {
+    if (IsLoadCurrent(fileNameINI, assignOperator, maxLineLen))
+    {
+        return EErrINI::EI_NoError;
+    }
+
     Reset();
 
     if (TStrTool::IsEmptyOrWhiteSpace(fileNameINI))
@@ -449,9 +897,15 @@ EErrINI TBasicINI::Load(std::string const& fileNameINI, char const assignOperato
         return EErrINI::EI_FileNotExists;
     }
 
+    //stamped before reading, so a write that lands during the read shows up as a change next time
+    uint64_t size = 0;
+    uint64_t lastWriteTime = 0;
+    bool const haveStamp = GetFileStamp(fileNameINI, &size, &lastWriteTime);
+
     FILE* fIn = nullptr;
 
-    if (!TPathTool::File_Open(TStrTool::Utf8ToUnicodeStr(fileNameINI), fIn, L"r", SH_DENYWR))
+    //binary, so the whole file is read without translation - ParseText() handles "\r\n"
+    if (!TPathTool::File_Open(TStrTool::Utf8ToUnicodeStr(fileNameINI), fIn, L"rb", SH_DENYWR))
     {
         return EErrINI::EI_FailOpenRead;
     }
@@ -459,9 +913,19 @@ EErrINI TBasicINI::Load(std::string const& fileNameINI, char const assignOperato
     EErrINI result = Load(fIn, assignOperator, maxLineLen);
     TPathTool::File_Close(fIn);
 
+    if (EErrINI::EI_NoError == result && haveStamp)
+        SetDiskStamp(fileNameINI, size, lastWriteTime, assignOperator, true, maxLineLen);
+
     return result;
 }
 //---------------------------------------------------------------------------
+/*
+    TBasicINI::Load
+
+    - Reads the rest of 'fIn' in one go and parses it in place. Keys, values and section names are views into the
+      read text, which the TBasicINI keeps until Reset(), so no line is copied.
+    - Lines longer than 'maxLineLen' are split into more than one line, as reading them with fgets() did.
+*/
 EErrINI TBasicINI::Load(FILE* fIn, char const assignOperator, size_t maxLineLen)
 {
     if (nullptr == fIn)
@@ -470,45 +934,94 @@ EErrINI TBasicINI::Load(FILE* fIn, char const assignOperator, size_t maxLineLen)
     }
 
     EErrINI result = EErrINI::EI_NoError;
-    size_t const lineSize = maxLineLen + sizeof('\0') + sizeof('\r') + sizeof('\n');
-    char* line = new char[lineSize];
-    std::unique_ptr<char[]> auto_line(line);
+    std::vector<char> text;
 
-    //read in one line at a time and parse
-    while (!::feof(fIn))
+    //size the buffer from the file where possible, one byte over so the read that finds the end needn't grow it
+    long const startPos = ::ftell(fIn);
+    if (startPos >= 0 && 0 == ::fseek(fIn, 0, SEEK_END))
     {
-        if (::fgets(line, static_cast<int>(lineSize), fIn) == nullptr)
-        {
-            int fErr = ::ferror(fIn);
+        long const endPos = ::ftell(fIn);
+        if (endPos > startPos)
+            text.reserve(static_cast<size_t>(endPos - startPos) + 1);
 
-            if (0 != fErr)
-            {
+        ::fseek(fIn, startPos, SEEK_SET);
+    }
+
+    size_t const minReadSize = 64 * 1024;
+
+    while (true)
+    {
+        size_t const oldSize = text.size();
+        size_t const readSize = text.capacity() - oldSize > 0 ? text.capacity() - oldSize : minReadSize;
+
+        text.resize(oldSize + readSize);
+        size_t const nRead = ::fread(&text[oldSize], 1, readSize, fIn);
+        text.resize(oldSize + nRead);
+
+        if (nRead < readSize)
+        {
+            if (0 != ::ferror(fIn))
                 result = EErrINI::EI_ReadError;
-            }
 
             break;
         }
+    }
+
+    if (EErrINI::EI_NoError != result || text.empty())
+        return result;
+
+    m_LoadedText.push_back(std::vector<char>());
+    m_LoadedText.back().swap(text);
 
-        char* lineP = line;
+    std::vector<char> const& loaded = m_LoadedText.back();
+    ParseText(&loaded[0], loaded.size(), assignOperator, maxLineLen);
+
+    //what was read is the baseline now, but not of any file Save() could skip writing
+    ClearDiskStamp();
+    SetDirty(false);
+
+    return result;
+}
+//---------------------------------------------------------------------------
+void TBasicINI::ParseText(char const* text, size_t textLen, char const assignOperator, size_t maxLineLen)
+{
+    char const* const textEnd = text + textLen;
+    char const* nextLineP = text;
+
+    while (nextLineP < textEnd)
+    {
+        char const* lineP = nextLineP;
+        char const* newLineP = static_cast<char const*>(memchr(lineP, '\n', static_cast<size_t>(textEnd - lineP)));
+        char const* lineEndP = nullptr == newLineP ? textEnd : newLineP;
+
+        nextLineP = nullptr == newLineP ? textEnd : newLineP + 1;
+
+        //drop the carriage return of a "\r\n" ender, as text mode reading used to
+        if (nullptr != newLineP && lineEndP > lineP && '\r' == lineEndP[-1])
+            lineEndP--;
+
+        //fgets() read at most maxLineLen + 2 chars, new line included, and left the rest for the next line
+        size_t const readLen = static_cast<size_t>(lineEndP - lineP) + (nullptr == newLineP ? 0 : 1);
+        if (readLen > 2 && readLen - 2 > maxLineLen)
+        {
+            lineEndP = lineP + maxLineLen + 2;
+            nextLineP = lineEndP;
+        }
 
         //skip spaces at start
-        while (' ' == *lineP || '\n' == *lineP)
+        while (lineP < lineEndP && ' ' == *lineP)
             lineP++;
 
-        if (!*lineP)
+        if (lineP == lineEndP)
             continue; //skip empty lines
 
-        size_t len = strlen(lineP);
-
-        //remove the new line ender if there is one
-        if (lineP[len - 1] == '\n')
-            lineP[--len] = '\0';
+        size_t const len = static_cast<size_t>(lineEndP - lineP);
 
         if (TSection::SectionStart == *lineP)
         {
-            TSection section;
-            section.Name = lineP;
-            Sections.push_back(section);
+            //construct in place, so the section is never copied
+            Sections.push_back(TSection());
+            Sections.back().Name.SetView(lineP, len);
             continue;
         }
 
@@ -518,24 +1031,24 @@ EErrINI TBasicINI::Load(FILE* fIn, char const assignOperator, size_t maxLineLen)
             Sections.push_back(TSection());
         }
 
-        //get pointer to current section
+        //get pointer to current section, and add the key value to be filled in place
         TSection* sectionP = &Sections[Sections.size() - 1];
-        TKeyVal keyVal;
+        sectionP->KeyVals.push_back(TKeyVal());
+        TKeyVal& keyVal = sectionP->KeyVals.back();
 
         if (*lineP == TKeyVal::CommentStart1 || *lineP == TKeyVal::CommentStart2) //add comment lines as values only (no key)
         {
-            keyVal.Value = lineP;
-            sectionP->KeyVals.push_back(keyVal);
+            keyVal.Value.SetView(lineP, len);
             continue;
         }
 
         //add key value pair by finding the assignment operator
         //Note: the first operator will determine the "key" portion. If not found, the whole line will be added as a value without a key
-        char* valStartP = lineP;
-        char* keyEndP = nullptr;
+        char const* valStartP = lineP;
+        char const* keyEndP = nullptr;
         bool operatorFound = false;
 
-        while (*valStartP)
+        while (valStartP < lineEndP)
         {
             if (' ' == *valStartP || assignOperator == *valStartP || AlternateAssignOperator_Read == *valStartP)
             {
@@ -548,7 +1061,7 @@ EErrINI TBasicINI::Load(FILE* fIn, char const assignOperator, size_t maxLineLen)
                     //found an operator, skip it
                     valStartP++;
                     //skip white space in order to find the start of the value
-                    while (' ' == *valStartP)
+                    while (valStartP < lineEndP && ' ' == *valStartP)
                         valStartP++;
 
                     break; //found the beginning of the value, or an empty value
@@ -560,21 +1073,23 @@ EErrINI TBasicINI::Load(FILE* fIn, char const assignOperator, size_t maxLineLen)
 
         if (operatorFound)
         {
-            *keyEndP = '\0';
-            keyVal.Key = lineP;
-            keyVal.Value = valStartP;
+            keyVal.Key.SetView(lineP, static_cast<size_t>(keyEndP - lineP));
+            keyVal.Value.SetView(valStartP, static_cast<size_t>(lineEndP - valStartP));
         }
         else //operator not found - treat the entire line as a value with an empty key
         {
-            keyVal.Value = lineP;
+            keyVal.Value.SetView(lineP, len);
         }
-
-        sectionP->KeyVals.push_back(keyVal);
     }
-
-    return result;
 }
 //---------------------------------------------------------------------------
+/*
+    TBasicINI::Save
+
+    - The whole file is built in memory and written in one go to a temporary file beside 'fileNameINI', which then
+      replaces it. A failed or interrupted save leaves the previous file as it was.
+    - Nothing is written if nothing is dirty and 'fileNameINI' is unchanged since it was last loaded or saved.
+*/
 EErrINI TBasicINI::Save(std::string const& fileNameINI, bool overWrite, char const assignOperator)
 {
     if (TStrTool::IsEmptyOrWhiteSpace(fileNameINI))
@@ -587,17 +1102,32 @@ EErrINI TBasicINI::Save(std::string const& fileNameINI, bool overWrite, char con
         return EErrINI::EI_FileExists;
     }
 
-    FILE* fOut = nullptr;
+    if (!IsDirty() && IsDiskStampCurrent(fileNameINI, assignOperator))
+    {
+        return EErrINI::EI_NoError;
+    }
+
+    std::string text;
+    SaveTo(&text, assignOperator, FileLineEnd);
 
-    if (!TPathTool::File_Open(TStrTool::Utf8ToUnicodeStr(fileNameINI), fOut, L"w", SH_DENYWR))
+    if (!TPathTool::File_WriteAtomic(fileNameINI, text.data(), text.size()))
     {
-        return EErrINI::EI_FailOpenWrite;
+        return EErrINI::EI_WriteError;
     }
 
-    EErrINI result = Save(fOut, assignOperator);
-    TPathTool::File_Close(fOut);
+    //a Load() of the file may not parse back exactly as the document is now (trimmed keys, long lines split), so
+    //only the next Save() may rely on this stamp
+    uint64_t size = 0;
+    uint64_t lastWriteTime = 0;
 
-    return result;
+    SetDirty(false);
+
+    if (GetFileStamp(fileNameINI, &size, &lastWriteTime))
+        SetDiskStamp(fileNameINI, size, lastWriteTime, assignOperator, false, 0);
+    else
+        ClearDiskStamp();
+
+    return EErrINI::EI_NoError;
 }
 //---------------------------------------------------------------------------
 EErrINI TBasicINI::Save(FILE* fOut, char const assignOperator)
@@ -607,33 +1137,52 @@ EErrINI TBasicINI::Save(FILE* fOut, char const assignOperator)
         return EErrINI::EI_BadParameter;
     }
 
-    EErrINI result = EErrINI::EI_NoError;
-    bool writeErr = false;
+    //"\n" - a text mode 'fOut' expands it itself
+    std::string text;
+    SaveTo(&text, assignOperator, "\n");
 
-    for (size_t i = 0; i < Sections.size(); i++)
+    if (::fwrite(text.data(), 1, text.size(), fOut) != text.size() || ::fflush(fOut) != 0)
     {
-        TSection* secP = &Sections[i];
+        return EErrINI::EI_WriteError;
+    }
 
-        if (i > 0)
-            writeErr |= -1 == fprintf(fOut, "\n");
+    return EErrINI::EI_NoError;
+}
+//---------------------------------------------------------------------------
+// -The exact number of chars SaveTo() writes.
+size_t TBasicINI::GetSaveSize(char const assignOperator, TStrView lineEnd) const
+{
+    size_t size = 0;
 
-        EErrINI resultTmp = secP->Save(fOut, assignOperator, PaddingAfterOperator_Write);
+    for (size_t i = 0; i < Sections.size(); i++)
+    {
+        if (i > 0)
+            size += lineEnd.size(); //blank line between sections
 
-        if (EErrINI::EI_NoError != result)
-        {
-            result = resultTmp;
-            //break; //save what can be saved
-        }
+        size += Sections[i].GetSaveSize(assignOperator, PaddingAfterOperator_Write, lineEnd);
     }
 
-    if (writeErr)
+    return size;
+}
+//---------------------------------------------------------------------------
+// -Replaces 'dest' with the document as text, sized once up front.
+void TBasicINI::SaveTo(std::string* dest, char const assignOperator, TStrView lineEnd) const
+{
+    dest->assign(GetSaveSize(assignOperator, lineEnd), '\0');
+
+    if (dest->empty())
+        return;
+
+    char* pos = &(*dest)[0];
+
+    for (size_t i = 0; i < Sections.size(); i++)
     {
-        result = EErrINI::EI_WriteError;
-    }
+        if (i > 0)
+            pos = AppendText(pos, lineEnd); //blank line between sections
 
-    return result;
+        pos = Sections[i].SaveTo(pos, assignOperator, PaddingAfterOperator_Write, lineEnd);
+    }
 }
-
 //---------------------------------------------------------------------------
 
 } // namespace BasicINI
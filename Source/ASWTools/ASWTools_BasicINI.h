@@ -25,10 +25,13 @@ limitations under the License.
 #ifndef ASWTools_BasicINIH
 #define ASWTools_BasicINIH
 //---------------------------------------------------------------------------
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 //---------------------------------------------------------------------------
 #include "ASWTools_Common.h"
+#include "ASWTools_String.h"
 //---------------------------------------------------------------------------
 
 namespace ASWTools
@@ -53,6 +56,105 @@ enum class EErrINI
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// TINIText
+//
+// A key, value or section name. After a Load() it is a view into the text
+// TBasicINI read the file into, so loading copies nothing per line. The first
+// assignment, or a copy, gives it its own std::string. A move keeps the view,
+// so don't move one out of a TBasicINI that will be reset or destroyed first.
+/////////////////////////////////////////////////////////////////////////////
+class TINIText
+{
+private:
+    char const* m_ViewData; // Null once the text is owned
+    size_t m_ViewSize;
+    std::string m_Owned;
+
+public:
+    TINIText() : m_ViewData(nullptr), m_ViewSize(0) {}
+    TINIText(char const* str) : m_ViewData(nullptr), m_ViewSize(0), m_Owned(nullptr == str ? "" : str) {}
+    TINIText(std::string const& str) : m_ViewData(nullptr), m_ViewSize(0), m_Owned(str) {}
+    TINIText(TINIText const& rhs) : m_ViewData(nullptr), m_ViewSize(0), m_Owned(rhs.data(), rhs.size()) {}
+#if __cplusplus >= 201103L
+    TINIText(TINIText&& rhs) noexcept
+        : m_ViewData(rhs.m_ViewData), m_ViewSize(rhs.m_ViewSize), m_Owned(std::move(rhs.m_Owned)) {}
+#endif
+
+    TINIText& operator=(TINIText const& rhs);
+    TINIText& operator=(std::string const& str);
+    TINIText& operator=(char const* str);
+#if __cplusplus >= 201103L
+    TINIText& operator=(TINIText&& rhs) noexcept;
+    TINIText& operator=(std::string&& str);
+#endif
+
+    char const* data() const { return nullptr != m_ViewData ? m_ViewData : m_Owned.data(); }
+    size_t size() const { return nullptr != m_ViewData ? m_ViewSize : m_Owned.size(); }
+    size_t length() const { return size(); }
+    bool empty() const { return 0 == size(); }
+    char operator[](size_t idx) const { return data()[idx]; }
+    bool IsView() const { return nullptr != m_ViewData; }
+
+    void Assign(char const* data, size_t size);
+    void SetView(char const* data, size_t size);
+
+    operator TStrView() const { return TStrView(data(), size()); }
+    std::string ToString() const { return std::string(data(), size()); }
+
+    bool operator==(TStrView rhs) const { return TStrView(data(), size()) == rhs; }
+    bool operator!=(TStrView rhs) const { return !(*this == rhs); }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TNameIndex
+//
+// Hash index over a list of names (keys or section names), keyed on the
+// case-folded name so that one index serves both ignoreCase lookups and exact
+// ones. Each hash chains its entries in list order, so the first of several
+// duplicate names is always found first. It only holds hashes - the owner
+// compares the names of the candidates it returns.
+//
+// The owner builds it lazily on the first lookup in a list of at least
+// MinEntries, appends to it as entries are added at the end, and drops it when
+// entries are inserted or deleted elsewhere. A list whose size no longer
+// matches is rebuilt, but a name changed in place is not noticed - call the
+// owner's InvalidateIndex() after renaming.
+/////////////////////////////////////////////////////////////////////////////
+class TNameIndex
+{
+public: // Static variables
+    static size_t const MinEntries = 16; // Shorter lists are scanned
+    static size_t const NotFound = static_cast<size_t>(-1);
+
+private:
+    struct TChain
+    {
+        size_t First;
+        size_t Last;
+    };
+
+private:
+    std::unordered_map<uint32_t, TChain> m_Chains;
+    std::vector<size_t> m_Next; // Per entry, the next entry with the same hash
+    bool m_Built;
+
+public:
+    TNameIndex();
+
+    static uint32_t HashName(TStrView name);
+
+    bool IsBuilt() const { return m_Built; }
+    bool IsBuilt(size_t entryCount) const { return m_Built && m_Next.size() == entryCount; }
+    void Invalidate();
+    void Start(size_t entryCount);
+    void Append(TStrView name);
+    size_t First(TStrView name) const;
+    size_t Next(size_t idx) const { return m_Next[idx]; }
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TKeyVal
 /////////////////////////////////////////////////////////////////////////////
@@ -63,18 +165,20 @@ public: // Static variables
     static const char CommentStart2 = '/';
 
 public:
-    std::string Key;
-    std::string Value;
+    TINIText Key;
+    TINIText Value;
 
 public:
     TKeyVal();
 #if __cplusplus >= 201103L
     TKeyVal(TKeyVal const&) = default;
+    TKeyVal(TKeyVal&&) = default;
 #endif
     ~TKeyVal();
 
 #if __cplusplus >= 201103L
     TKeyVal& operator=(TKeyVal const& rhs) = default;
+    TKeyVal& operator=(TKeyVal&& rhs) = default;
 #endif
 
     void Reset();
@@ -87,6 +191,10 @@ public:
 
 /////////////////////////////////////////////////////////////////////////////
 // TSection
+//
+// Adding, inserting, deleting, SetName() and SetKeyVal() mark the section
+// dirty. SetName() and SetKeyVal() only do so if the text actually changes.
+// Editing Name or KeyVals directly does not - call SetDirty() after.
 /////////////////////////////////////////////////////////////////////////////
 class TSection
 {
@@ -96,17 +204,29 @@ public: // Static variables
     static size_t const NotFound = static_cast<size_t>(-1);
 
 public:
-    std::string Name;
+    TINIText Name;
     std::vector<TKeyVal> KeyVals;
 
+private:
+    mutable TNameIndex m_KeyIndex;
+    bool m_Dirty;
+
+private:
+    void IndexAddedKeyVal();
+    bool UseKeyIndex() const;
+
 public:
     TSection();
 #if __cplusplus >= 201103L
     TSection(TSection const&) = default;
+    TSection(TSection&&) = default;
 #endif
     ~TSection();
 
     TSection& operator=(TSection const& rhs);
+#if __cplusplus >= 201103L
+    TSection& operator=(TSection&& rhs) = default;
+#endif
 
     void Reset();
 
@@ -118,19 +238,31 @@ public:
     bool InsertKeyVal(size_t index, TKeyVal const& keyVal);
     bool InsertComment(size_t index, std::string const& comment);
     bool DeleteKeyVal(size_t index);
-    size_t FindKey(std::string const& key, bool ignoreCase) const;
+    size_t FindKey(TStrView key, bool ignoreCase) const;
     size_t FindOrCreateKey(std::string const& key, bool ignoreCase);
-    size_t FindVal(std::string const& value, bool ignoreCase) const;
+    size_t FindVal(TStrView value, bool ignoreCase) const;
+    void InvalidateIndex();
+
+    void SetName(TStrView name);
+    bool SetKeyVal(size_t index, TStrView key, TStrView value);
+    bool IsDirty() const { return m_Dirty; }
+    void SetDirty(bool dirty = true) { m_Dirty = dirty; }
 
     bool HasOneOrMoreKeyValuePairs() const;
 
     bool IsGlobalSection();
+    size_t GetSaveSize(char const assignOperator, TStrView paddingAfterOperator, TStrView lineEnd) const;
+    char* SaveTo(char* dest, char const assignOperator, TStrView paddingAfterOperator, TStrView lineEnd) const;
     EErrINI Save(FILE* fOut, char const assignOperator, std::string const& paddingAfterOperator = "");
 };
 
 
 /////////////////////////////////////////////////////////////////////////////
 // TBasicINI
+//
+// Remembers the size and last write time of the file it was last loaded from
+// or saved to. Loading that file again while nothing is dirty and the file is
+// unchanged keeps what is already parsed, and saving it skips the write.
 /////////////////////////////////////////////////////////////////////////////
 class TBasicINI
 {
@@ -138,9 +270,35 @@ public: // Static variables allowed in this public - see second public for regul
     static const size_t DefaultMaxLineLength = 8192;
     static const char DefaultAssignOperator = '=';
 
+private:
+    // The file the document matches, as it was when last loaded or saved
+    struct TDiskStamp
+    {
+        std::string FileName; // Empty if the document matches no file
+        uint64_t Size;
+        uint64_t LastWriteTime;
+        char AssignOperator;
+        std::string PaddingAfterOperator;
+        bool FromLoad; // False after a Save() - only another Save() may rely on it
+        size_t MaxLineLen;
+    };
+
+private:
+    std::list<std::vector<char> > m_LoadedText; // Whole file text from each Load(). Loaded TINIText views point into it.
+    mutable TNameIndex m_SectionIndex;
+    bool m_Dirty; // Sections added, inserted or deleted - see IsDirty() for the whole document
+    TDiskStamp m_DiskStamp;
+
 private:
     void Destroy_Private();
     bool Reset_Private();
+    void ParseText(char const* text, size_t textLen, char const assignOperator, size_t maxLineLen);
+    void IndexAddedSection();
+    bool UseSectionIndex() const;
+    void ClearDiskStamp();
+    void SetDiskStamp(std::string const& fileNameINI, uint64_t size, uint64_t lastWriteTime, char const assignOperator,
+        bool fromLoad, size_t maxLineLen);
+    bool IsDiskStampCurrent(std::string const& fileNameINI, char const assignOperator) const;
 
 public:
     TBasicINI();
@@ -161,14 +319,23 @@ public:
     virtual bool InsertSection(size_t index);
     virtual bool InsertSection(size_t index, TSection const& section);
     virtual bool DeleteSection(size_t index);
-    virtual size_t FindSection(std::string const& sectionName, bool ignoreCase) const;
+    virtual size_t FindSection(TStrView sectionName, bool ignoreCase) const;
     virtual size_t FindOrCreateSection(std::string const& sectionName, bool ignoreCase);
+    void InvalidateIndex();
+
+    virtual bool IsDirty() const;
+    void SetDirty(bool dirty = true);
+    bool IsLoadCurrent(std::string const& fileNameINI, char const assignOperator = DefaultAssignOperator,
+        size_t maxLineLen = DefaultMaxLineLength) const;
 
     virtual EErrINI Load(std::string const& fileNameINI, char const assignOperator = DefaultAssignOperator,
         size_t maxLineLen = DefaultMaxLineLength);
     virtual EErrINI Load(FILE* fIn, char const assignOperator = DefaultAssignOperator, size_t maxLineLen = DefaultMaxLineLength);
     virtual EErrINI Save(std::string const& fileNameINI, bool overWrite, char const assignOperator = DefaultAssignOperator);
     virtual EErrINI Save(FILE* fOut, char const assignOperator = DefaultAssignOperator);
+
+    size_t GetSaveSize(char const assignOperator, TStrView lineEnd) const;
+    void SaveTo(std::string* dest, char const assignOperator, TStrView lineEnd) const;
 };
 
 } // namespace BasicINI
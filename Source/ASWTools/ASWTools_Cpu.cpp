@@ -0,0 +1,138 @@
+/* **************************************************************************
+ASWTools_Cpu.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_Cpu.h"
+//---------------------------------------------------------------------------
+#include <stdint.h>
+//---------------------------------------------------------------------------
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASWTOOLS_CPU_X86 1
+#include <cpuid.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ASWTOOLS_CPU_X86 1
+#include <intrin.h>
+#endif
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+#if defined(ASWTOOLS_CPU_X86)
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void CpuId(int leaf, int subLeaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, subLeaf);
+    for (int i = 0; i < 4; i++)
+        regs[i] = static_cast<uint32_t>(info[i]);
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+//---------------------------------------------------------------------------
+// XCR0 - which register states the OS saves on a context switch
+uint64_t GetXCR0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo;
+    uint32_t hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+#endif // #if defined(ASWTOOLS_CPU_X86)
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TCpu
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+// -Static
+TCpu::TFeatures TCpu::Detect()
+{
+    TFeatures features;
+
+#if defined(ASWTOOLS_CPU_X86)
+    uint32_t regs[4];
+    CpuId(0, 0, regs);
+    uint32_t const maxLeaf = regs[0];
+
+    if (maxLeaf < 1)
+        return features;
+
+    CpuId(1, 0, regs);
+    features.SSSE3 = 0 != (regs[2] & (1u << 9));
+    features.SSE42 = 0 != (regs[2] & (1u << 20));
+    bool const osxsave = 0 != (regs[2] & (1u << 27));
+    bool const avx = 0 != (regs[2] & (1u << 28));
+
+    // The OS has to save the YMM registers too (XCR0 bits 1 and 2)
+    if (maxLeaf >= 7 && osxsave && avx && (GetXCR0() & 0x6) == 0x6)
+    {
+        CpuId(7, 0, regs);
+        features.AVX2 = 0 != (regs[1] & (1u << 5));
+    }
+#endif
+
+    return features;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Detected on first use. Initialization of a function local static is thread safe.
+TCpu::TFeatures const& TCpu::GetFeatures()
+{
+    static TFeatures const features = Detect();
+    return features;
+}
+//---------------------------------------------------------------------------
+// -Static
+bool TCpu::HasAVX2()
+{
+    return GetFeatures().AVX2;
+}
+//---------------------------------------------------------------------------
+// -Static
+bool TCpu::HasSSE42()
+{
+    return GetFeatures().SSE42;
+}
+//---------------------------------------------------------------------------
+// -Static
+bool TCpu::HasSSSE3()
+{
+    return GetFeatures().SSSE3;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWTools
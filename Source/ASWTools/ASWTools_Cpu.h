@@ -0,0 +1,65 @@
+/* **************************************************************************
+ASWTools_Cpu.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_CpuH
+#define ASWTools_CpuH
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TCpu
+//
+// x86 instruction set extensions that this CPU, and the OS, can run. They
+// are detected once, and every SIMD dispatcher asks here so that they can't
+// disagree. Everything reads false on other architectures.
+/////////////////////////////////////////////////////////////////////////////
+class TCpu
+{
+public:
+    struct TFeatures
+    {
+        bool SSSE3;
+        bool SSE42;
+        bool AVX2; // Only if the OS also saves the YMM registers
+
+        TFeatures()
+            : SSSE3(false),
+              SSE42(false),
+              AVX2(false)
+        {
+        }
+    };
+
+private:
+    static TFeatures Detect();
+
+public:
+    static TFeatures const& GetFeatures();
+    static bool HasAVX2();
+    static bool HasSSE42();
+    static bool HasSSSE3();
+};
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_CpuH
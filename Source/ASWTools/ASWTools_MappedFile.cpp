@@ -0,0 +1,121 @@
+/* **************************************************************************
+ASWTools_MappedFile.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_MappedFile.h"
+//---------------------------------------------------------------------------
+#include "ASWTools_String.h"
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TMappedFile
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TMappedFile::TMappedFile()
+    : m_File(INVALID_HANDLE_VALUE),
+      m_Mapping(nullptr),
+      m_Data(nullptr),
+      m_Size(0)
+{
+}
+//---------------------------------------------------------------------------
+TMappedFile::~TMappedFile()
+{
+    Close();
+}
+//---------------------------------------------------------------------------
+void TMappedFile::Close()
+{
+    if (nullptr != m_Data)
+        ::UnmapViewOfFile(m_Data);
+    if (nullptr != m_Mapping)
+        ::CloseHandle(m_Mapping);
+    if (INVALID_HANDLE_VALUE != m_File)
+        ::CloseHandle(m_File);
+
+    m_File = INVALID_HANDLE_VALUE;
+    m_Mapping = nullptr;
+    m_Data = nullptr;
+    m_Size = 0;
+}
+//---------------------------------------------------------------------------
+unsigned char const* TMappedFile::GetData() const
+{
+    return static_cast<unsigned char const*>(m_Data);
+}
+//---------------------------------------------------------------------------
+size_t TMappedFile::GetSize() const
+{
+    return m_Size;
+}
+//---------------------------------------------------------------------------
+bool TMappedFile::IsOpen() const
+{
+    return nullptr != m_Data;
+}
+//---------------------------------------------------------------------------
+bool TMappedFile::Open(std::string const& fileName)
+{
+    return Open(TStrTool::Utf8ToUnicodeStr(fileName));
+}
+//---------------------------------------------------------------------------
+// Returns false if the file can't be opened, or is empty (an empty file can't be mapped).
+bool TMappedFile::Open(std::wstring const& fileName)
+{
+    Close();
+
+    m_File = ::CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == m_File)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(m_File, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<size_t>(-1))
+    {
+        Close();
+        return false;
+    }
+
+    m_Mapping = ::CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == m_Mapping)
+    {
+        Close();
+        return false;
+    }
+
+    m_Data = ::MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (nullptr == m_Data)
+    {
+        Close();
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWTools
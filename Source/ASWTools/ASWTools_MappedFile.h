@@ -0,0 +1,66 @@
+/* **************************************************************************
+ASWTools_MappedFile.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_MappedFileH
+#define ASWTools_MappedFileH
+//---------------------------------------------------------------------------
+#include <windows.h>
+#include <stddef.h>
+#include <string>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TMappedFile
+//
+// Read-only view of a whole file, mapped into memory. The file can't be
+// replaced or deleted while it is open.
+/////////////////////////////////////////////////////////////////////////////
+class TMappedFile
+{
+private:
+    HANDLE m_File;
+    HANDLE m_Mapping;
+    void const* m_Data;
+    size_t m_Size;
+
+public: // Getters/Setters
+    unsigned char const* GetData() const;
+    size_t GetSize() const;
+    bool IsOpen() const;
+
+public:
+    TMappedFile();
+    ~TMappedFile();
+
+    TMappedFile(TMappedFile const&) = delete;
+    TMappedFile& operator=(TMappedFile const&) = delete;
+
+    void Close();
+    bool Open(std::string const& fileName); // UTF-8
+    bool Open(std::wstring const& fileName);
+};
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_MappedFileH
@@ -506,6 +506,39 @@ bool TPathTool::File_GetLastWriteTime(std::wstring const& fn, FILETIME& lastwrit
     return true;
 }
 //---------------------------------------------------------------------------
+// Reads the attributes without opening the file, so it is cheap enough to call for every file in a folder.
+bool TPathTool::File_GetSizeAndLastWriteTime(std::string const& fn, uint64_t& fileSize, FILETIME& lastwritetime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+
+    fileSize = 0;
+    lastwritetime.dwLowDateTime = 0;
+    lastwritetime.dwHighDateTime = 0;
+
+    if (!::GetFileAttributesExA(fn.c_str(), GetFileExInfoStandard, &data))
+        return false;
+
+    fileSize = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    lastwritetime = data.ftLastWriteTime;
+    return true;
+}
+//---------------------------------------------------------------------------
+bool TPathTool::File_GetSizeAndLastWriteTime(std::wstring const& fn, uint64_t& fileSize, FILETIME& lastwritetime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+
+    fileSize = 0;
+    lastwritetime.dwLowDateTime = 0;
+    lastwritetime.dwHighDateTime = 0;
+
+    if (!::GetFileAttributesExW(fn.c_str(), GetFileExInfoStandard, &data))
+        return false;
+
+    fileSize = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    lastwritetime = data.ftLastWriteTime;
+    return true;
+}
+//---------------------------------------------------------------------------
 bool TPathTool::File_Open(std::string const& fileName, FILE*& filePointer, char const* fileType, unsigned char openMode)
 {
     return File_Open(
@@ -676,6 +709,93 @@ bool TPathTool::File_Remove(std::wstring const& fileName, DWORD maxWaitMS)
 }
 //---------------------------------------------------------------------------
 // -Static
+bool TPathTool::File_WriteAtomic(std::string const& fileName, void const* data, size_t size)
+{
+    return File_WriteAtomic(TStrTool::Utf8ToUnicodeStr(fileName), data, size);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Replaces 'fileName' with 'data' so that it is never seen half written: the data goes to a new temporary file in
+//  the same folder, is flushed to disk, and the temporary file is then renamed over 'fileName'. A crash part way
+//  leaves either the old file or the new one, plus at worst a stray "*.tmp".
+// -On failure the temporary file is removed, 'fileName' is untouched, and GetLastError() tells why.
+bool TPathTool::File_WriteAtomic(std::wstring const& fileName, void const* data, size_t size)
+{
+    int const createMaxTries = 8;
+    int const renameFailWaitMS = 30;
+    int const renameMaxTries = 30;
+    DWORD const maxWriteSize = 0x40000000; //WriteFile() takes a DWORD - larger data goes in pieces
+    size_t const tempNameLen = 8;
+
+    if (fileName.empty() || (nullptr == data && size > 0))
+    {
+        ::SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    std::wstring const dir = ExtractDir(fileName);
+    if (!dir.empty() && !Dir_Exists_WinAPI(dir))
+        Dir_CreateDirWithSubs(dir);
+
+    //same folder as the target, so the rename never has to copy across volumes
+    std::wstring tempName;
+    HANDLE h = INVALID_HANDLE_VALUE;
+
+    for (int tries = 0; INVALID_HANDLE_VALUE == h && tries < createMaxTries; tries++)
+    {
+        tempName = fileName + L"." + GenerateRandomNameW(tempNameLen) + L".tmp";
+        h = ::CreateFileW(tempName.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (INVALID_HANDLE_VALUE == h && ERROR_FILE_EXISTS != ::GetLastError())
+            return false;
+    }
+
+    if (INVALID_HANDLE_VALUE == h)
+        return false;
+
+    unsigned char const* pos = static_cast<unsigned char const*>(data);
+    size_t remaining = size;
+    bool ok = true;
+
+    while (ok && remaining > 0)
+    {
+        DWORD const toWrite = remaining > maxWriteSize ? maxWriteSize : static_cast<DWORD>(remaining);
+        DWORD written = 0;
+
+        ok = ::WriteFile(h, pos, toWrite, &written, nullptr) && written == toWrite;
+        pos += written;
+        remaining -= written;
+    }
+
+    if (ok)
+        ok = FALSE != ::FlushFileBuffers(h);
+
+    DWORD lastError = ok ? ERROR_SUCCESS : ::GetLastError();
+    ::CloseHandle(h);
+
+    //the target may be held open briefly by another process (virus scanners, indexers), as in File_Open()
+    for (int tries = 0; ok; tries++)
+    {
+        if (::MoveFileExW(tempName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+            break;
+
+        lastError = ::GetLastError();
+        if ((ERROR_SHARING_VIOLATION != lastError && ERROR_ACCESS_DENIED != lastError) || tries >= renameMaxTries)
+            ok = false;
+        else
+            ::Sleep(renameFailWaitMS);
+    }
+
+    if (!ok)
+    {
+        ::DeleteFileW(tempName.c_str());
+        ::SetLastError(lastError);
+    }
+
+    return ok;
+}
+//---------------------------------------------------------------------------
+// -Static
 // -Removes the last extension (e.g. ".txt") from the path. If no extension
 //  found, returns entire contents of path.
 std::string TPathTool::RemoveExtension(std::string const& path)
@@ -31,6 +31,7 @@ limitations under the License.
 //---------------------------------------------------------------------------
 #include <windows.h>
 #include <share.h>
+#include <stdint.h>
 #include <string>
 //---------------------------------------------------------------------------
 #include "ASWTools_Common.h"
@@ -115,6 +116,8 @@ public: // Methods for file operations
     static bool File_Exists_WinAPI(std::wstring const& fileName);
     static bool File_GetLastWriteTime(std::string const& fn, FILETIME& lastwritetime);
     static bool File_GetLastWriteTime(std::wstring const& fn, FILETIME& lastwritetime);
+    static bool File_GetSizeAndLastWriteTime(std::string const& fn, uint64_t& fileSize, FILETIME& lastwritetime);
+    static bool File_GetSizeAndLastWriteTime(std::wstring const& fn, uint64_t& fileSize, FILETIME& lastwritetime);
     static bool File_Open(std::string const& fileName, FILE*& filePointer, char const* fileType,
         unsigned char openMode = SH_DENYNO); //default is share deny none
     static bool File_Open(std::wstring const& fileName, FILE*& filePointer, wchar_t const* fileType,
@@ -122,6 +125,8 @@ public: // Methods for file operations
     static bool File_Close(FILE*& file);
     static bool File_Remove(std::string const& fileName, DWORD maxWaitMS = 4000);
     static bool File_Remove(std::wstring const& fileName, DWORD maxWaitMS = 4000);
+    static bool File_WriteAtomic(std::string const& fileName, void const* data, size_t size);
+    static bool File_WriteAtomic(std::wstring const& fileName, void const* data, size_t size);
 };
 
 } // namespace ASWTools
@@ -30,21 +30,33 @@ limitations under the License.
 // 'Additional Options' because Microsoft likes to make things difficult. If using C++ 11 and up, add
 // this option to: Properties-> C/C++ -> All Options -> Additional Options
 
-#if __cplusplus >= 201103L
-#   include <codecvt>
-#else
+#if __cplusplus < 201103L
 #   include <functional>
 #   include <stdarg.h> // va_start
 #   include <wctype.h>
-#endif // #if __cplusplus >= 201103L
+#endif // #if __cplusplus < 201103L
 
 //#include <cstdarg> //va_start
 //#include <cctype>
+#include <cstdio> //vsnprintf
 #include <limits>
 #include <locale>
 #include <stdexcept>
 #include <cwctype>
 //---------------------------------------------------------------------------
+#include "ASWTools_Utf.h"
+//---------------------------------------------------------------------------
+
+// va_copy is C99 and C++11. Where it's missing, va_list is a plain pointer and assignment copies it.
+#ifndef va_copy
+#   define va_copy(dest, src) ((dest) = (src))
+#endif
+
+// SSE2 is part of every x64 target, and of 32 bit x86 targets built for it, so it needs no run time check
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ASWTOOLS_STRING_SSE2 1
+#   include <emmintrin.h>
+#endif
 
 #ifndef strcmpI
 #ifdef __BORLANDC__
@@ -80,6 +92,78 @@ limitations under the License.
 namespace ASWTools
 {
 
+/////////////////////////////////////////////////////////////////////////////
+// TStrView
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+size_t TStrView::find(char c, size_t pos) const
+{
+    if (pos >= m_Size)
+        return npos;
+
+    void const* found = memchr(m_Data + pos, c, m_Size - pos);
+    return nullptr == found ? npos : static_cast<size_t>(static_cast<char const*>(found) - m_Data);
+}
+//---------------------------------------------------------------------------
+// -'pos' past the end gives an empty view, rather than throwing as std::string_view does.
+TStrView TStrView::substr(size_t pos, size_t count) const
+{
+    if (pos > m_Size)
+        pos = m_Size;
+
+    if (count > m_Size - pos)
+        count = m_Size - pos;
+
+    return TStrView(m_Data + pos, count);
+}
+//---------------------------------------------------------------------------
+bool TStrView::operator==(TStrView const& rhs) const
+{
+    return m_Size == rhs.m_Size && (0 == m_Size || 0 == memcmp(m_Data, rhs.m_Data, m_Size));
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TStrSplitter
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TStrSplitter::TStrSplitter(TStrView str, char const sep)
+    : m_Remaining(str),
+      m_Sep(sep),
+      m_Done(false)
+{
+}
+//---------------------------------------------------------------------------
+// -Returns false once every field has been returned.
+bool TStrSplitter::Next(TStrView* field)
+{
+    if (m_Done)
+        return false;
+
+    size_t const pos = m_Remaining.find(m_Sep);
+
+    if (TStrView::npos == pos)
+    {
+        //last item
+        if (nullptr != field)
+            *field = m_Remaining;
+
+        m_Done = true;
+        return true;
+    }
+
+    if (nullptr != field)
+        *field = m_Remaining.substr(0, pos);
+
+    m_Remaining.remove_prefix(pos + 1);
+    return true;
+}
+//---------------------------------------------------------------------------
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TStrTool
 /////////////////////////////////////////////////////////////////////////////
@@ -124,93 +208,38 @@ bool TStrTool::Reset() //virtual
 }
 //---------------------------------------------------------------------------
 // - Static
+// -Invalid input (an unpaired surrogate) becomes U+FFFD.
 std::string TStrTool::UnicodeStrToUtf8(std::wstring const& str)
 {
     if (str.empty())
         return "";
 
-#if __cplusplus >= 201103L
-
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-#endif
-    std::wstring_convert<std::codecvt_utf8<wchar_t> > myconv;
-    return myconv.to_bytes(str);
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
-#else
-    int utf16Len = str.length();
-    int utf8Len = ::WideCharToMultiByte(CP_UTF8, 0, str.c_str(), utf16Len, nullptr, 0, nullptr, nullptr);
-    if (0 == utf8Len)
-        return "";
-
-    std::string utf8Str(utf8Len, '\0');
-    ::WideCharToMultiByte(CP_UTF8, 0, str.c_str(), utf16Len, &utf8Str[0], utf8Len, nullptr, nullptr);
+    std::string utf8Str(TUtf::GetMaxUtf8Len(str.length()), '\0');
+    TUtf::TResult const result = TUtf::WideToUtf8(str.data(), str.length(), &utf8Str[0], utf8Str.length(), true);
+    utf8Str.resize(result.Written);
 
     return utf8Str;
-#endif // #if __cplusplus >= 201103L
 }
 //---------------------------------------------------------------------------
 // -Static
 std::wstring TStrTool::Utf8ToUnicodeStr(const std::string& str)
 {
-    if (str.empty())
-        return L"";
-
-#if __cplusplus >= 201103L
-
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-#endif
-    std::wstring_convert<std::codecvt_utf8<wchar_t> > myconv;
-    return myconv.from_bytes(str);
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
-#else
-    int wideCharLen = ::MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
-    if (0 == wideCharLen)
-        return L"";
-
-    std::wstring strW(wideCharLen, L'\0');
-    ::MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &strW[0], wideCharLen);
-    return strW;
-//    std::vector<wchar_t> wideCharBuffer(wideCharLen);
-//    ::MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, wideCharBuffer.data(), wideCharLen);
-//    return std::wstring(wideCharBuffer.begin(), wideCharBuffer.end() - 1);
-#endif // #if __cplusplus >= 201103L
+    return Utf8ToUnicodeStr(str.data(), str.length());
 }
 //---------------------------------------------------------------------------
 // - Static
+// -Invalid input becomes U+FFFD, one per maximal invalid subpart.
 std::wstring TStrTool::Utf8ToUnicodeStr(char const* utf8Bytes, size_t length)
 {
     if (0 == length || nullptr == utf8Bytes)
         return L"";
 
-#if __cplusplus >= 201103L
+    // Never more wide chars than bytes, whatever the size of wchar_t
+    std::wstring strW(length, L'\0');
+    TUtf::TResult const result = TUtf::Utf8ToWide(utf8Bytes, length, &strW[0], strW.length(), true);
+    strW.resize(result.Written);
 
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-#endif
-    std::wstring_convert<std::codecvt_utf8<wchar_t> > myconv;
-    // Note that from_bytes does not include the character pointed to by "last", the 2nd parameter
-    return myconv.from_bytes(utf8Bytes, utf8Bytes + length);
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
-#else
-    int wideCharLen = ::MultiByteToWideChar(CP_UTF8, 0, utf8Bytes, length, nullptr, 0);
-    if (0 == wideCharLen)
-        return L"";
-
-    std::wstring strW(wideCharLen, L'\0');
-    ::MultiByteToWideChar(CP_UTF8, 0, utf8Bytes, length, &strW[0], wideCharLen);
     return strW;
-#endif // #if __cplusplus >= 201103L
 }
 //---------------------------------------------------------------------------
 // -Static
@@ -435,6 +464,235 @@ bool TStrTool::DateTime_Parse_ISO8601(std::string const& iso8601Str,
     return true;
 }
 //---------------------------------------------------------------------------
+
+namespace
+{
+
+int64_t const MilliSecsPerDay = 86400000LL;
+int64_t const SecsPerDay = 86400LL;
+
+//---------------------------------------------------------------------------
+// -Days from 1970-01-01 to 'y'-'m'-'d' in the proleptic Gregorian calendar. No tables and no time_t, so the full
+//  0001 - 9999 range works wherever int64_t does. (Howard Hinnant's days_from_civil.)
+int64_t DaysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2 ? 1 : 0;
+    int const era = (y >= 0 ? y : y - 399) / 400;
+    int const yearOfEra = y - era * 400;
+    int const dayOfYear = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int const dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return static_cast<int64_t>(era) * 146097 + dayOfEra - 719468;
+}
+//---------------------------------------------------------------------------
+// -The inverse of DaysFromCivil().
+void CivilFromDays(int64_t days, int* y, int* m, int* d)
+{
+    days += 719468;
+    int64_t const era = (days >= 0 ? days : days - 146096) / 146097;
+    int const dayOfEra = static_cast<int>(days - era * 146097);
+    int const yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int const dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int const mp = (5 * dayOfYear + 2) / 153;
+
+    *d = dayOfYear - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = static_cast<int>(yearOfEra + era * 400) + (*m <= 2 ? 1 : 0);
+}
+//---------------------------------------------------------------------------
+int DaysInMonth(int y, int m)
+{
+    static int const daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if (2 == m && 0 == y % 4 && (0 != y % 100 || 0 == y % 400))
+        return 29;
+
+    return daysInMonth[m - 1];
+}
+//---------------------------------------------------------------------------
+// -Writes exactly 'width' digits, zero padded.
+void PutFixedDigits(char* dest, int value, int width)
+{
+    for (int i = width - 1; i >= 0; i--)
+    {
+        dest[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+//---------------------------------------------------------------------------
+// -Reads exactly 'width' digits. Returns -1 if any of them isn't a digit.
+int GetFixedDigits(char const* src, int width)
+{
+    int value = 0;
+
+    for (int i = 0; i < width; i++)
+    {
+        unsigned int const digit = static_cast<unsigned int>(static_cast<unsigned char>(src[i])) - '0';
+        if (digit > 9)
+            return -1;
+
+        value = value * 10 + static_cast<int>(digit);
+    }
+
+    return value;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+// - Static
+// - Milliseconds since 1970-01-01T00:00:00Z.
+int64_t TStrTool::DateTime_GetUTCNow_EpochMs()
+{
+    FILETIME fileTime;
+    ::GetSystemTimeAsFileTime(&fileTime);
+
+    // FILETIME counts 100 nanosecond ticks from 1601-01-01
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = fileTime.dwLowDateTime;
+    ticks.HighPart = fileTime.dwHighDateTime;
+
+    return static_cast<int64_t>(ticks.QuadPart / 10000) - 11644473600000LL;
+}
+//---------------------------------------------------------------------------
+// - Static
+// - Writes 'epochMs' (milliseconds since 1970-01-01T00:00:00Z) to [first, last) as "YYYY-MM-DDTHH:MM:SSZ", or as
+//   "YYYY-MM-DDTHH:MM:SS.mmmZ" if 'withMilliSecs'. Without them the time is truncated to the second. No null.
+// - Returns the end of what was written, or null if it doesn't fit or 'epochMs' is outside
+//   DateTime_MinEpochMs - DateTime_MaxEpochMs. DateTime_ISO8601_MaxLen chars always fit.
+char* TStrTool::DateTime_EpochMsToChars_ISO8601(char* first, char* last, int64_t epochMs, bool withMilliSecs)
+{
+    size_t const len = withMilliSecs ? DateTime_ISO8601_MaxLen : DateTime_ISO8601_MaxLen - 4;
+
+    if (nullptr == first || last < first || static_cast<size_t>(last - first) < len)
+        return nullptr;
+
+    if (epochMs < DateTime_MinEpochMs || epochMs > DateTime_MaxEpochMs)
+        return nullptr;
+
+    int64_t days = epochMs / MilliSecsPerDay;
+    int64_t msOfDay = epochMs % MilliSecsPerDay;
+    if (msOfDay < 0)
+    {
+        msOfDay += MilliSecsPerDay;
+        days--;
+    }
+
+    int y = 0, m = 0, d = 0;
+    CivilFromDays(days, &y, &m, &d);
+
+    int const secOfDay = static_cast<int>(msOfDay / 1000);
+
+    PutFixedDigits(first, y, 4);
+    first[4] = '-';
+    PutFixedDigits(first + 5, m, 2);
+    first[7] = '-';
+    PutFixedDigits(first + 8, d, 2);
+    first[10] = 'T';
+    PutFixedDigits(first + 11, secOfDay / 3600, 2);
+    first[13] = ':';
+    PutFixedDigits(first + 14, secOfDay / 60 % 60, 2);
+    first[16] = ':';
+    PutFixedDigits(first + 17, secOfDay % 60, 2);
+
+    char* pos = first + 19;
+
+    if (withMilliSecs)
+    {
+        *pos++ = '.';
+        PutFixedDigits(pos, static_cast<int>(msOfDay % 1000), 3);
+        pos += 3;
+    }
+
+    *pos++ = 'Z';
+    return pos;
+}
+//---------------------------------------------------------------------------
+// - Static
+// - Parses all of [first, last) as "YYYY-MM-DDTHH:MM:SS", then optional fractional seconds (digits past the
+//   milliseconds are truncated), then "Z" or a "+HH:MM" / "-HH:MM" offset. Fields are fixed width.
+// - On success 'outEpochMs', if not null, is set to milliseconds since 1970-01-01T00:00:00Z. Otherwise it is left
+//   alone. Never throws or allocates.
+bool TStrTool::DateTime_CharsToEpochMs_ISO8601(char const* first, char const* last, int64_t* outEpochMs)
+{
+    static ptrdiff_t const minLen = 20; //"YYYY-MM-DDTHH:MM:SSZ"
+
+    if (nullptr == first || last - first < minLen)
+        return false;
+
+    if ('-' != first[4] || '-' != first[7] || 'T' != first[10] || ':' != first[13] || ':' != first[16])
+        return false;
+
+    int const y = GetFixedDigits(first, 4);
+    int const m = GetFixedDigits(first + 5, 2);
+    int const d = GetFixedDigits(first + 8, 2);
+    int const h = GetFixedDigits(first + 11, 2);
+    int const min = GetFixedDigits(first + 14, 2);
+    int const s = GetFixedDigits(first + 17, 2);
+
+    // GetFixedDigits() gives -1 for a non-digit, which every lower bound rejects
+    if (y < 1 || m < 1 || m > 12 || d < 1 || d > DaysInMonth(y, m) || h < 0 || h > 23 || min < 0 || min > 59 ||
+        s < 0 || s > 59)
+    {
+        return false;
+    }
+
+    char const* pos = first + 19;
+    int ms = 0;
+
+    if ('.' == *pos)
+    {
+        char const* const fractionP = ++pos;
+
+        for (int scale = 100; pos < last && *pos >= '0' && *pos <= '9'; pos++)
+        {
+            ms += (*pos - '0') * scale;
+            scale /= 10;
+        }
+
+        if (pos == fractionP)
+            return false;
+    }
+
+    int offsetMins = 0;
+
+    if (pos < last && 'Z' == *pos)
+    {
+        pos++;
+    }
+    else if (last - pos >= 6 && ('+' == *pos || '-' == *pos) && ':' == pos[3])
+    {
+        int const offsetH = GetFixedDigits(pos + 1, 2);
+        int const offsetM = GetFixedDigits(pos + 4, 2);
+
+        if (offsetH < 0 || offsetH > 23 || offsetM < 0 || offsetM > 59)
+            return false;
+
+        offsetMins = offsetH * 60 + offsetM;
+        if ('-' == *pos)
+            offsetMins = -offsetMins;
+
+        pos += 6;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (pos != last)
+        return false;
+
+    int64_t const secs = DaysFromCivil(y, m, d) * SecsPerDay + h * 3600 + min * 60 + s - offsetMins * 60;
+    int64_t const epochMs = secs * 1000 + ms;
+
+    if (epochMs < DateTime_MinEpochMs || epochMs > DateTime_MaxEpochMs)
+        return false; // An offset moved it outside what DateTime_EpochMsToChars_ISO8601() writes
+
+    if (nullptr != outEpochMs)
+        *outEpochMs = epochMs;
+
+    return true;
+}
+//---------------------------------------------------------------------------
 std::wstring TStrTool::GetDateTimeStr_LocalW(bool fileNameFriendly)
 {
     SYSTEMTIME time; //has milliseconds
@@ -950,6 +1208,84 @@ std::wstring TStrTool::Trim_Copy(std::wstring s, wchar_t const trimChar, bool tr
     return s;
 }
 //---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without leading spaces. Nothing is copied.
+TStrView TStrTool::TrimLeft_View(TStrView s)
+{
+    size_t count = 0;
+
+    while (count < s.size() && IsSpace(static_cast<unsigned char>(s[count])))
+        count++;
+
+    s.remove_prefix(count);
+    return s;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without leading 'trimChar', and spaces if 'trim_isspace'. Nothing is copied.
+TStrView TStrTool::TrimLeft_View(TStrView s, unsigned char const trimChar, bool trim_isspace)
+{
+    size_t count = 0;
+
+    while (count < s.size())
+    {
+        unsigned char const ch = static_cast<unsigned char>(s[count]);
+        if (trimChar != ch && !(trim_isspace && IsSpace(ch)))
+            break;
+
+        count++;
+    }
+
+    s.remove_prefix(count);
+    return s;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without trailing spaces. Nothing is copied.
+TStrView TStrTool::TrimRight_View(TStrView s)
+{
+    size_t count = 0;
+
+    while (count < s.size() && IsSpace(static_cast<unsigned char>(s[s.size() - 1 - count])))
+        count++;
+
+    s.remove_suffix(count);
+    return s;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without trailing 'trimChar', and spaces if 'trim_isspace'. Nothing is copied.
+TStrView TStrTool::TrimRight_View(TStrView s, unsigned char const trimChar, bool trim_isspace)
+{
+    size_t count = 0;
+
+    while (count < s.size())
+    {
+        unsigned char const ch = static_cast<unsigned char>(s[s.size() - 1 - count]);
+        if (trimChar != ch && !(trim_isspace && IsSpace(ch)))
+            break;
+
+        count++;
+    }
+
+    s.remove_suffix(count);
+    return s;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without leading or trailing spaces. Nothing is copied.
+TStrView TStrTool::Trim_View(TStrView s)
+{
+    return TrimRight_View(TrimLeft_View(s));
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Returns a view of 's' without leading or trailing 'trimChar', and spaces if 'trim_isspace'. Nothing is copied.
+TStrView TStrTool::Trim_View(TStrView s, unsigned char const trimChar, bool trim_isspace)
+{
+    return TrimRight_View(TrimLeft_View(s, trimChar, trim_isspace), trimChar, trim_isspace);
+}
+//---------------------------------------------------------------------------
 int TStrTool::Compare(std::string const& s1, std::string const& s2)
 {
     return s1.compare(s2);
@@ -960,22 +1296,112 @@ int TStrTool::Compare(std::wstring const& s1, std::wstring const& s2)
     return s1.compare(s2);
 }
 //---------------------------------------------------------------------------
-int TStrTool::CompareIC(std::string const& s1, std::string const& s2)
+namespace
 {
-    unsigned char const* us1 = reinterpret_cast<unsigned char const*> (s1.c_str());
-    unsigned char const* us2 = reinterpret_cast<unsigned char const*> (s2.c_str());
-    int c1, c2;
 
-    if (us1 == us2)
+// ASCII case conversion. Bytes from 0x80 up map to themselves here - they are left to the locale.
+struct TAsciiCaseTables
+{
+    unsigned char Lower[256];
+    unsigned char Upper[256];
+
+    TAsciiCaseTables()
+    {
+        for (int c = 0; c < 256; c++)
+        {
+            Lower[c] = static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            Upper[c] = static_cast<unsigned char>(c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+        }
+    }
+};
+//---------------------------------------------------------------------------
+TAsciiCaseTables const& GetAsciiCaseTables()
+{
+    static TAsciiCaseTables const tables;
+    return tables;
+}
+//---------------------------------------------------------------------------
+inline int FoldLower(unsigned char c, unsigned char const* lower)
+{
+    return c < 0x80 ? lower[c] : std::tolower(c);
+}
+//---------------------------------------------------------------------------
+// -Returns the difference of the first pair of bytes that differ once folded, or zero.
+int CompareFoldedBytes(unsigned char const* us1, unsigned char const* us2, size_t count, unsigned char const* lower)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int const c1 = FoldLower(us1[i], lower);
+        int const c2 = FoldLower(us2[i], lower);
+
+        if (c1 != c2)
+            return c1 - c2;
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+#if defined(ASWTOOLS_STRING_SSE2)
+// -Lower cases 16 ASCII bytes. Only valid when no byte has its high bit set, as the compares are signed.
+inline __m128i FoldLower_SSE2(__m128i bytes)
+{
+    __m128i const isUpper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+        _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(bytes, _mm_and_si128(isUpper, _mm_set1_epi8('a' - 'A')));
+}
+#endif // #if defined(ASWTOOLS_STRING_SSE2)
+
+} // namespace
+
+//---------------------------------------------------------------------------
+// -A shorter string that matches the start of a longer one compares as less, as with strcmp.
+// -ASCII is folded through a table, 16 bytes per step where SSE2 is available. Only bytes from 0x80 up go through
+//  the locale's std::tolower().
+int TStrTool::CompareIC(TStrView s1, TStrView s2)
+{
+    unsigned char const* us1 = reinterpret_cast<unsigned char const*> (s1.data());
+    unsigned char const* us2 = reinterpret_cast<unsigned char const*> (s2.data());
+    size_t const count = s1.size() < s2.size() ? s1.size() : s2.size();
+    unsigned char const* lower = GetAsciiCaseTables().Lower;
+    size_t i = 0;
+
+    if (us1 == us2 && s1.size() == s2.size())
         return 0;
 
-    do
+#if defined(ASWTOOLS_STRING_SSE2)
+    for (; i + 16 <= count; i += 16)
     {
-        c1 = std::tolower(*us1++);
-        c2 = std::tolower(*us2++);
-    } while (c1 && c1 == c2);
+        __m128i const block1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(us1 + i));
+        __m128i const block2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(us2 + i));
+
+        if (0 == _mm_movemask_epi8(_mm_or_si128(block1, block2)))
+        {
+            __m128i const equal = _mm_cmpeq_epi8(FoldLower_SSE2(block1), FoldLower_SSE2(block2));
+            if (0xFFFF == _mm_movemask_epi8(equal))
+                continue;
+        }
+
+        // A difference, or bytes for the locale - settle this block a byte at a time
+        int const diff = CompareFoldedBytes(us1 + i, us2 + i, 16, lower);
+        if (0 != diff)
+            return diff;
+    }
+#endif // #if defined(ASWTOOLS_STRING_SSE2)
+
+    int const diff = CompareFoldedBytes(us1 + i, us2 + i, count - i, lower);
+    if (0 != diff)
+        return diff;
+
+    if (s1.size() == s2.size())
+        return 0;
 
-    return c1 - c2;
+    return s1.size() < s2.size() ? -FoldLower(us2[count], lower) : FoldLower(us1[count], lower);
+}
+//---------------------------------------------------------------------------
+// -Same folding as CompareIC(), but strings of different lengths are rejected before any bytes are read.
+bool TStrTool::EqualsIC(TStrView s1, TStrView s2)
+{
+    return s1.size() == s2.size() && 0 == CompareIC(s1, s2);
 }
 //---------------------------------------------------------------------------
 int TStrTool::CompareIC(std::wstring const& s1, std::wstring const& s2)
@@ -995,122 +1421,252 @@ int TStrTool::CompareIC(std::wstring const& s1, std::wstring const& s2)
 
     return static_cast<int> (c1) - static_cast<int> (c2);
 }
-//---------------------------------------------------------------------------}
-int32_t TStrTool::StrToInt32(std::string const& str)
+//---------------------------------------------------------------------------
+namespace
 {
-    try
-    {
-#if __cplusplus >= 201103L
-        long val = std::stol(str);
-#else
-        long val = std::atol(str.c_str());
-#endif
 
-#if LONG_MAX > INT32_MAX
-        if (val > std::numeric_limits<int32_t>::max())
-            throw std::out_of_range("Value exceeds int32_t range");
-#endif
-        return static_cast<int32_t>(val);
-    }
-    catch (const std::invalid_argument& e)
+// -Reads the decimal digits at 'first' into 'magnitude', skipping leading zeros.
+// -Returns the end of the digits, which is 'first' if there are none. 'overflow' is set, and the digits are still
+//  consumed, if they don't fit in 64 bits.
+char const* ParseDecimalDigits(char const* first, char const* last, uint64_t* magnitude, bool* overflow)
+{
+    static ptrdiff_t const maxSafeDigits = 19; // 10^19 - 1 < 2^64, so this many digits can't overflow
+
+    char const* walker = first;
+    uint64_t val = 0;
+
+    while (walker < last && '0' == *walker)
+        walker++;
+
+    char const* const significant = walker;
+    char const* const safeEnd = last - walker > maxSafeDigits ? walker + maxSafeDigits : last;
+    unsigned digit = 0;
+
+    // Unsigned subtraction folds the below '0' and above '9' checks into one compare
+    while (walker < safeEnd && (digit = static_cast<unsigned char>(*walker) - '0') <= 9)
     {
-        throw std::invalid_argument("String is not a signed 32-bit int: " + std::string(e.what()));
+        val = val * 10 + digit;
+        walker++;
     }
-    catch (const std::out_of_range& e)
+
+    *overflow = false;
+
+    if (walker == safeEnd)
     {
-        throw std::out_of_range("Out of range: " + std::string(e.what()));
+        // Only a 20th digit can still fit, and only if it doesn't carry past 2^64 - 1
+        while (walker < last && (digit = static_cast<unsigned char>(*walker) - '0') <= 9)
+        {
+            if (walker - significant >= maxSafeDigits + 1 || val > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+                *overflow = true;
+            else
+                val = val * 10 + digit;
+
+            walker++;
+        }
     }
+
+    *magnitude = val;
+    return walker;
 }
-//---------------------------------------------------------------------------}
-int64_t TStrTool::StrToInt64(std::string const& str)
+//---------------------------------------------------------------------------
+template <typename T>
+TFromCharsResult FromCharsUnsigned(char const* first, char const* last, T* outVal)
 {
-    try
-    {
-#if __cplusplus >= 201103L
-        long long val = std::stoll(str);
-#else
-        long long val = std::atoll(str.c_str());
-#endif
+    TFromCharsResult result = { first, EFromCharsErr::InvalidArgument };
 
-#if LONGLONG_MAX > INT64_MAX
-        if (val > std::numeric_limits<int64_t>::max())
-            throw std::out_of_range("Value exceeds int64_t range");
-#endif
-        return static_cast<int64_t>(val);
-    }
-    catch (const std::invalid_argument& e)
+    if (nullptr == first || first >= last)
+        return result;
+
+    uint64_t magnitude = 0;
+    bool overflow = false;
+    char const* const end = ParseDecimalDigits(first, last, &magnitude, &overflow);
+
+    if (end == first)
+        return result;
+
+    result.Ptr = end;
+
+    if (overflow || magnitude > std::numeric_limits<T>::max())
     {
-        throw std::invalid_argument("String is not a signed 64-bit int: " + std::string(e.what()));
+        result.Err = EFromCharsErr::OutOfRange;
+        return result;
     }
-    catch (const std::out_of_range& e)
+
+    if (nullptr != outVal)
+        *outVal = static_cast<T>(magnitude);
+
+    result.Err = EFromCharsErr::None;
+    return result;
+}
+//---------------------------------------------------------------------------
+template <typename T>
+TFromCharsResult FromCharsSigned(char const* first, char const* last, T* outVal)
+{
+    TFromCharsResult result = { first, EFromCharsErr::InvalidArgument };
+
+    if (nullptr == first || first >= last)
+        return result;
+
+    bool const negative = '-' == *first;
+    char const* const digitsStart = negative ? first + 1 : first;
+    uint64_t magnitude = 0;
+    bool overflow = false;
+    char const* const end = ParseDecimalDigits(digitsStart, last, &magnitude, &overflow);
+
+    if (end == digitsStart)
+        return result;
+
+    result.Ptr = end;
+
+    // The negative range is one larger than the positive
+    uint64_t const limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+
+    if (overflow || magnitude > limit)
     {
-        throw std::out_of_range("Out of range: " + std::string(e.what()));
+        result.Err = EFromCharsErr::OutOfRange;
+        return result;
     }
+
+    if (nullptr != outVal)
+        *outVal = static_cast<T>(negative ? 0 - magnitude : magnitude);
+
+    result.Err = EFromCharsErr::None;
+    return result;
 }
-//---------------------------------------------------------------------------}
-uint32_t TStrTool::StrToUInt32(std::string const& str)
+//---------------------------------------------------------------------------
+// -Parses as the std::stol family does: leading white space and a '+' are allowed, and anything after the number
+//  is ignored. Unlike std::stoul, a '-' isn't accepted for an unsigned type.
+// -'outVal' is only written on success.
+template <typename T>
+EFromCharsErr StrToInteger(TStrView str, T* outVal)
 {
-    try
+    TStrView const trimmed = TStrTool::TrimLeft_View(str);
+    char const* first = trimmed.begin();
+    char const* const last = trimmed.end();
+
+    if (first < last && '+' == *first)
     {
-#if __cplusplus >= 201103L
-        unsigned long val = std::stoul(str);
-#else
-        char* endP = NULL;
-        unsigned long val = std::strtoul(str.c_str(), &endP, 10);
-#endif
+        first++;
 
-#if ULONG_MAX > UINT32_MAX
-        if (val > std::numeric_limits<uint32_t>::max())
-        {   // should not happen on Windows (unsigned long == uint32_t)
-            throw std::out_of_range("Value exceeds uint32_t range");
-        }
-#endif
-        return static_cast<uint32_t>(val);
+        if (first < last && '-' == *first)
+            return EFromCharsErr::InvalidArgument;
     }
-    catch (std::invalid_argument const& e)
+
+    return TStrTool::FromChars(first, last, outVal).Err;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+// -Static
+// -As std::from_chars, base 10: an optional '-', then digits. No white space or '+'. Never throws.
+// -On success 'outVal', if not null, is set. Otherwise it is left alone.
+TFromCharsResult TStrTool::FromChars(char const* first, char const* last, int32_t* outVal)
+{
+    return FromCharsSigned(first, last, outVal);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::from_chars, base 10: an optional '-', then digits. No white space or '+'. Never throws.
+// -On success 'outVal', if not null, is set. Otherwise it is left alone.
+TFromCharsResult TStrTool::FromChars(char const* first, char const* last, int64_t* outVal)
+{
+    return FromCharsSigned(first, last, outVal);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::from_chars, base 10: digits only. No sign or white space. Never throws.
+// -On success 'outVal', if not null, is set. Otherwise it is left alone.
+TFromCharsResult TStrTool::FromChars(char const* first, char const* last, uint32_t* outVal)
+{
+    return FromCharsUnsigned(first, last, outVal);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::from_chars, base 10: digits only. No sign or white space. Never throws.
+// -On success 'outVal', if not null, is set. Otherwise it is left alone.
+TFromCharsResult TStrTool::FromChars(char const* first, char const* last, uint64_t* outVal)
+{
+    return FromCharsUnsigned(first, last, outVal);
+}
+//---------------------------------------------------------------------------
+// -Throws std::invalid_argument or std::out_of_range. Use TryStrToInt32() where bad input is expected.
+int32_t TStrTool::StrToInt32(TStrView str)
+{
+    int32_t val = 0;
+
+    switch (StrToInteger(str, &val))
     {
-        throw std::invalid_argument("String is not an unsigned 32-bit int: " + std::string(e.what()));
+        case EFromCharsErr::InvalidArgument:
+            throw std::invalid_argument("String is not a signed 32-bit int");
+        case EFromCharsErr::OutOfRange:
+            throw std::out_of_range("Out of range: Value exceeds int32_t range");
+        default:
+            break;
     }
-    catch (std::out_of_range const& e)
+
+    return val;
+}
+//---------------------------------------------------------------------------
+// -Throws std::invalid_argument or std::out_of_range. Use TryStrToInt64() where bad input is expected.
+int64_t TStrTool::StrToInt64(TStrView str)
+{
+    int64_t val = 0;
+
+    switch (StrToInteger(str, &val))
     {
-        throw std::out_of_range("Out of range: " + std::string(e.what()));
+        case EFromCharsErr::InvalidArgument:
+            throw std::invalid_argument("String is not a signed 64-bit int");
+        case EFromCharsErr::OutOfRange:
+            throw std::out_of_range("Out of range: Value exceeds int64_t range");
+        default:
+            break;
     }
+
+    return val;
 }
-//---------------------------------------------------------------------------}
-uint64_t TStrTool::StrToUInt64(std::string const& str)
+//---------------------------------------------------------------------------
+// -Throws std::invalid_argument or std::out_of_range. Use TryStrToUInt32() where bad input is expected.
+uint32_t TStrTool::StrToUInt32(TStrView str)
 {
-    try
-    {
-#if __cplusplus >= 201103L
-        unsigned long long val = std::stoull(str);
-#else
-        char* endP = NULL;
-        unsigned long long val = std::strtoull(str.c_str(), &endP, 10);
-#endif
+    uint32_t val = 0;
 
-#if ULONGLONG_MAX > UINT64_MAX
-        if (val > std::numeric_limits<uint64_t>::max())
-        {   // should not happen on Windows (unsigned long == uint32_t)
-            throw std::out_of_range("Value exceeds uint64_t range");
-        }
-#endif
-        return static_cast<uint64_t>(val);
-    }
-    catch (std::invalid_argument const& e)
+    switch (StrToInteger(str, &val))
     {
-        throw std::invalid_argument("String is not an unsigned 64-bit int: " + std::string(e.what()));
+        case EFromCharsErr::InvalidArgument:
+            throw std::invalid_argument("String is not an unsigned 32-bit int");
+        case EFromCharsErr::OutOfRange:
+            throw std::out_of_range("Out of range: Value exceeds uint32_t range");
+        default:
+            break;
     }
-    catch (std::out_of_range const& e)
+
+    return val;
+}
+//---------------------------------------------------------------------------
+// -Throws std::invalid_argument or std::out_of_range. Use TryStrToUInt64() where bad input is expected.
+uint64_t TStrTool::StrToUInt64(TStrView str)
+{
+    uint64_t val = 0;
+
+    switch (StrToInteger(str, &val))
     {
-        throw std::out_of_range("Out of range: " + std::string(e.what()));
+        case EFromCharsErr::InvalidArgument:
+            throw std::invalid_argument("String is not an unsigned 64-bit int");
+        case EFromCharsErr::OutOfRange:
+            throw std::out_of_range("Out of range: Value exceeds uint64_t range");
+        default:
+            break;
     }
+
+    return val;
 }
 //---------------------------------------------------------------------------
-bool TStrTool::ToBool(std::string const& str)
+bool TStrTool::ToBool(TStrView str)
 {
-    std::string lowerStr = Trim_Copy(ToLower(str));
+    TStrView const trimmed = Trim_View(str);
 
-    if (lowerStr.length() == 0 || "false" == lowerStr || "no" == lowerStr || "0" == lowerStr)
+    if (trimmed.length() == 0 || EqualsIC(trimmed, "false") || EqualsIC(trimmed, "no") || trimmed == "0")
         return false;
 
     return true;
@@ -1126,136 +1682,268 @@ bool TStrTool::ToBool(std::wstring const& str)
     return true;
 }
 //---------------------------------------------------------------------------
-std::string TStrTool::ToLower(std::string const& str)
+namespace
 {
-    if (str.empty())
-        return "";
 
+// "00" to "99", so integers are written two digits, and one divide, at a time
+char const DigitPairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// -Writes 'value' so that it ends just before 'end', and returns where it starts.
+char* FormatDigitsBackwards(char* end, uint64_t value)
+{
+    while (value >= 100)
+    {
+        size_t const pairIdx = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = DigitPairs[pairIdx + 1];
+        *--end = DigitPairs[pairIdx];
+    }
+
+    if (value >= 10)
+    {
+        size_t const pairIdx = static_cast<size_t>(value) * 2;
+        *--end = DigitPairs[pairIdx + 1];
+        *--end = DigitPairs[pairIdx];
+    }
+    else
+    {
+        *--end = static_cast<char>('0' + value);
+    }
+
+    return end;
+}
+//---------------------------------------------------------------------------
+// -Copies [start, end) to 'first'. Returns the end of the copy, or null if [first, last) is too small.
+char* CopyFormatted(char* first, char* last, char const* start, char const* end)
+{
+    size_t const len = static_cast<size_t>(end - start);
+
+    if (nullptr == first || last < first || static_cast<size_t>(last - first) < len)
+        return nullptr;
+
+    memcpy(first, start, len);
+    return first + len;
+}
+//---------------------------------------------------------------------------
+template <typename T>
+char* ToCharsInteger(char* first, char* last, T value)
+{
+    char buffer[TStrTool::ToChars_MaxIntLen];
+    char* const end = buffer + sizeof(buffer);
+    bool const negative = value < 0;
+
+    // Negate as unsigned, so the most negative value doesn't overflow
+    uint64_t const magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char* start = FormatDigitsBackwards(end, magnitude);
+
+    if (negative)
+        *--start = '-';
+
+    return CopyFormatted(first, last, start, end);
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+// -Static
+// -As std::to_chars: writes 'value' in base 10 to [first, last), without a null terminator.
+// -Returns the end of what was written, or null if it doesn't fit. ToChars_MaxIntLen chars always fit.
+char* TStrTool::ToChars(char* first, char* last, int32_t value)
+{
+    return ToCharsInteger(first, last, value);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::to_chars: writes 'value' in base 10 to [first, last), without a null terminator.
+// -Returns the end of what was written, or null if it doesn't fit. ToChars_MaxIntLen chars always fit.
+char* TStrTool::ToChars(char* first, char* last, int64_t value)
+{
+    return ToCharsInteger(first, last, value);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::to_chars: writes 'value' in base 10 to [first, last), without a null terminator.
+// -Returns the end of what was written, or null if it doesn't fit. ToChars_MaxIntLen chars always fit.
+char* TStrTool::ToChars(char* first, char* last, uint32_t value)
+{
+    return ToCharsInteger(first, last, value);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -As std::to_chars: writes 'value' in base 10 to [first, last), without a null terminator.
+// -Returns the end of what was written, or null if it doesn't fit. ToChars_MaxIntLen chars always fit.
+char* TStrTool::ToChars(char* first, char* last, uint64_t value)
+{
+    return ToCharsInteger(first, last, value);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Writes 'value' as printf's "%.*g" does, which is also what a default std::stringstream gives for a precision of
+//  6. 'precision' is clamped to 1 - 17, where 17 always round trips.
+// -Returns the end of what was written, or null if it doesn't fit. ToChars_MaxDoubleLen chars always fit.
+char* TStrTool::ToChars(char* first, char* last, double value, int precision)
+{
+    static int const maxPrecision = std::numeric_limits<double>::max_digits10;
+
+    char buffer[ToChars_MaxDoubleLen + sizeof('\0')];
+    int const len = snprintf(buffer, sizeof(buffer), "%.*g",
+        precision < 1 ? 1 : (precision > maxPrecision ? maxPrecision : precision), value);
+
+    if (len < 0 || static_cast<size_t>(len) >= sizeof(buffer))
+        return nullptr;
+
+    return CopyFormatted(first, last, buffer, buffer + len);
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToStringA(int32_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::string(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToStringA(int64_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::string(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToStringA(uint32_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::string(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToStringA(uint64_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::string(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToStringA(double value)
+{
+    char buffer[ToChars_MaxDoubleLen];
+    return std::string(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::wstring TStrTool::ToStringW(int32_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::wstring(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::wstring TStrTool::ToStringW(int64_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::wstring(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::wstring TStrTool::ToStringW(uint32_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::wstring(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::wstring TStrTool::ToStringW(uint64_t value)
+{
+    char buffer[ToChars_MaxIntLen];
+    return std::wstring(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::wstring TStrTool::ToStringW(double value)
+{
+    char buffer[ToChars_MaxDoubleLen];
+    return std::wstring(buffer, ToChars(buffer, buffer + sizeof(buffer), value));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToLower(std::string const& str)
+{
     std::string result = str;
-    result.resize(str.size());
-#if __cplusplus >= 201103L
-    std::transform(str.begin(), str.end(), result.begin(), [](unsigned char c){
-            return std::tolower(c);
-        });
-#else
-    std::transform(str.begin(), str.end(), result.begin(), (int (*)(int)) std::tolower);
-#endif
+    ToLower_InPlace(result);
     return result;
 }
 //---------------------------------------------------------------------------
 std::wstring TStrTool::ToLower(std::wstring const& str)
 {
-    if (str.empty())
-        return L"";
-
     std::wstring result = str;
-    result.resize(str.size());
-#if __cplusplus >= 201103L
-    std::transform(str.begin(), str.end(), result.begin(), [](wchar_t c){
-            return std::towlower(c);
-        });
-#else
-    std::transform(str.begin(), str.end(), result.begin(), (int (*)(wchar_t)) std::towlower);
-#endif
+    ToLower_InPlace(result);
     return result;
 }
 //---------------------------------------------------------------------------
-std::string TStrTool::ToUpper(std::string const& str)
+// -ASCII goes through a table. Only bytes from 0x80 up go through the locale's std::tolower().
+void TStrTool::ToLower_InPlace(std::string& str)
 {
-    if (str.empty())
-        return "";
+    unsigned char const* lower = GetAsciiCaseTables().Lower;
 
+    for (size_t i = 0, count = str.size(); i < count; i++)
+        str[i] = static_cast<char>(FoldLower(static_cast<unsigned char>(str[i]), lower));
+}
+//---------------------------------------------------------------------------
+void TStrTool::ToLower_InPlace(std::wstring& str)
+{
+    for (size_t i = 0, count = str.size(); i < count; i++)
+        str[i] = static_cast<wchar_t>(std::towlower(str[i]));
+}
+//---------------------------------------------------------------------------
+std::string TStrTool::ToUpper(std::string const& str)
+{
     std::string result = str;
-    result.resize(str.size());
-#if __cplusplus >= 201103L
-    std::transform(str.begin(), str.end(), result.begin(), [](unsigned char c){
-            return std::toupper(c);
-        });
-#else
-    std::transform(str.begin(), str.end(), result.begin(), (int (*)(int)) std::toupper);
-#endif
+    ToUpper_InPlace(result);
     return result;
 }
 //---------------------------------------------------------------------------
 std::wstring TStrTool::ToUpper(std::wstring const& str)
 {
-    if (str.empty())
-        return L"";
-
     std::wstring result = str;
-    result.resize(str.size());
-#if __cplusplus >= 201103L
-    std::transform(str.begin(), str.end(), result.begin(), [](wchar_t c){
-            return std::towupper(c);
-        });
-#else
-    std::transform(str.begin(), str.end(), result.begin(), (int (*)(wchar_t)) std::towupper);
-#endif
+    ToUpper_InPlace(result);
     return result;
 }
 //---------------------------------------------------------------------------
-// On success, 'outVal', if not null, will be set to the converted value.
-bool TStrTool::TryStrToInt32(std::string const& str, int32_t* outVal)
+// -ASCII goes through a table. Only bytes from 0x80 up go through the locale's std::toupper().
+void TStrTool::ToUpper_InPlace(std::string& str)
 {
-    try
-    {
-        int32_t val = StrToInt32(str);
-        if (nullptr != outVal)
-            *outVal = val;
-        return true;
-    }
-    catch (...)
+    unsigned char const* upper = GetAsciiCaseTables().Upper;
+
+    for (size_t i = 0, count = str.size(); i < count; i++)
     {
-        return false;
+        unsigned char const c = static_cast<unsigned char>(str[i]);
+        str[i] = static_cast<char>(c < 0x80 ? upper[c] : std::toupper(c));
     }
 }
 //---------------------------------------------------------------------------
+void TStrTool::ToUpper_InPlace(std::wstring& str)
+{
+    for (size_t i = 0, count = str.size(); i < count; i++)
+        str[i] = static_cast<wchar_t>(std::towupper(str[i]));
+}
+//---------------------------------------------------------------------------
+// On success, 'outVal', if not null, will be set to the converted value.
+// Never throws.
+bool TStrTool::TryStrToInt32(TStrView str, int32_t* outVal)
+{
+    return EFromCharsErr::None == StrToInteger(str, outVal);
+}
+//---------------------------------------------------------------------------
 // On success, 'outVal', if not null, will be set to the converted value.
-bool TStrTool::TryStrToInt64(std::string const& str, int64_t* outVal)
+// Never throws.
+bool TStrTool::TryStrToInt64(TStrView str, int64_t* outVal)
 {
-    try
-    {
-        int64_t val = StrToInt64(str);
-        if (nullptr != outVal)
-            *outVal = val;
-        return true;
-    }
-    catch (...)
-    {
-        return false;
-    }
+    return EFromCharsErr::None == StrToInteger(str, outVal);
 }
 //---------------------------------------------------------------------------
 // On success, 'outVal', if not null, will be set to the converted value.
-bool TStrTool::TryStrToUInt32(std::string const& str, uint32_t* outVal)
+// Never throws.
+bool TStrTool::TryStrToUInt32(TStrView str, uint32_t* outVal)
 {
-    try
-    {
-        uint32_t val = StrToUInt32(str);
-        if (nullptr != outVal)
-            *outVal = val;
-        return true;
-    }
-    catch (...)
-    {
-        return false;
-    }
+    return EFromCharsErr::None == StrToInteger(str, outVal);
 }
 //---------------------------------------------------------------------------
 // On success, 'outVal', if not null, will be set to the converted value.
-bool TStrTool::TryStrToUInt64(std::string const& str, uint64_t* outVal)
+// Never throws.
+bool TStrTool::TryStrToUInt64(TStrView str, uint64_t* outVal)
 {
-    try
-    {
-        uint64_t val = StrToUInt64(str);
-        if (nullptr != outVal)
-            *outVal = val;
-        return true;
-    }
-    catch (...)
-    {
-        return false;
-    }
+    return EFromCharsErr::None == StrToInteger(str, outVal);
 }
 //---------------------------------------------------------------------------
 // -Static
@@ -1279,15 +1967,13 @@ bool TStrTool::IsSpace(int c)
 }
 //---------------------------------------------------------------------------
 // -Static
-bool TStrTool::IsEmptyOrWhiteSpace(std::string const& s)
+bool TStrTool::IsEmptyOrWhiteSpace(TStrView s)
 {
-    if (s.length() == 0)
-        return true;
-
-    if (TStrTool::Trim_Copy(s).length() == 0)
-        return true;
+    for (size_t i = 0; i < s.size(); i++)
+        if (!IsSpace(static_cast<unsigned char>(s[i])))
+            return false;
 
-    return false;
+    return true;
 }
 //---------------------------------------------------------------------------
 // -Static
@@ -1371,6 +2057,26 @@ std::vector<std::wstring> TStrTool::Split(std::wstring const& str, wchar_t const
 }
 //---------------------------------------------------------------------------
 // -Static
+// -Fills 'fields' with views into 'str', the same fields that the copying overload returns. 'fields' is cleared
+//  first, so reusing one vector across calls stops allocating once it has grown to the largest field count.
+// -Returns the number of fields.
+size_t TStrTool::Split(TStrView str, char const sep, std::vector<TStrView>* fields)
+{
+    if (nullptr == fields)
+        return 0;
+
+    fields->clear();
+
+    TStrSplitter splitter(str, sep);
+    TStrView field;
+
+    while (splitter.Next(&field))
+        fields->push_back(field);
+
+    return fields->size();
+}
+//---------------------------------------------------------------------------
+// -Static
 // -Inserts a delim character wherever there is a delim character found.
 std::string TStrTool::DelimStr_Escape(std::string const& strIn, char const delim)
 {
@@ -1948,36 +2654,84 @@ int64_t TStrTool::DecodeBase16HexToBytes(std::string const& inHex, BYTE* outBuff
 
     return filledCount;
 }
+//---------------------------------------------------------------------------
+namespace
+{
+
+char const Base64_AlphabetStd[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+char const Base64_AlphabetUrl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Lookup tables for the Base64 routines, built once at first use
+struct TBase64Tables
+{
+    static uint32_t const Bad = 0x01FFFFFF; // Any bit above the low 24 marks a character that isn't Base64
+    static uint8_t const Class_Std = 0x01; // "A-Za-z0-9+/"
+    static uint8_t const Class_Url = 0x02; // "A-Za-z0-9-_"
+
+    // Decode[i][c] is the 6 bits of 'c', already shifted into place in the 24 bit group for position 'i' of a
+    // quad (first output byte in bits 0-7), so a quad decodes with four lookups OR'd together.
+    uint32_t Decode[4][256];
+    uint8_t Class[256];
+
+    TBase64Tables()
+    {
+        for (int i = 0; i < 4; i++)
+            for (int c = 0; c < 256; c++)
+                Decode[i][c] = Bad;
+
+        for (int c = 0; c < 256; c++)
+            Class[c] = 0;
+
+        for (uint32_t v = 0; v < 64; v++)
+        {
+            unsigned char const chars[2] =
+            {
+                static_cast<unsigned char>(Base64_AlphabetStd[v]), static_cast<unsigned char>(Base64_AlphabetUrl[v])
+            };
+
+            Class[chars[0]] |= Class_Std;
+            Class[chars[1]] |= Class_Url;
+
+            // Both alphabets decode, so web friendly output reads back without being told which it is
+            for (int k = 0; k < 2; k++)
+            {
+                unsigned char const c = chars[k];
+                Decode[0][c] = v << 2;
+                Decode[1][c] = (v >> 4) | ((v & 0x0F) << 12);
+                Decode[2][c] = ((v >> 2) << 8) | ((v & 0x03) << 22);
+                Decode[3][c] = v << 16;
+            }
+        }
+    }
+};
+//---------------------------------------------------------------------------
+// Initialization of a function local static is thread safe.
+TBase64Tables const& GetBase64Tables()
+{
+    static TBase64Tables const tables;
+    return tables;
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
 //---------------------------------------------------------------------------
 // - Static
 bool TStrTool::IsValidBase64(char const* str, bool isUrlSafe)
 {
-    bool foundEqual = false;
-    char const* b64Chars = isUrlSafe ? "-_" : "+/";
-    char const* walker = str;
-
     if (nullptr == str || *str == '\0')
         return false;
 
-    while(*walker)
+    TBase64Tables const& tables = GetBase64Tables();
+    uint8_t const classMask = isUrlSafe ? TBase64Tables::Class_Url : TBase64Tables::Class_Std;
+    bool foundEqual = false;
+
+    for (unsigned char const* walker = reinterpret_cast<unsigned char const*>(str); *walker; walker++)
     {
-        if(*walker == '=')
-        {
+        if (*walker == '=')
             foundEqual = true;
-        }
-        else if(isdigit(*walker) ||
-                isalpha(*walker) ||
-                (strchr(b64Chars, *walker) != nullptr))
-        {
-            if(foundEqual)
-                return false;
-        }
-        else
-        {
-            return false;
-        }
-
-        walker++;
+        else if (foundEqual || 0 == (tables.Class[*walker] & classMask))
+            return false; // Not in the alphabet, or data after padding
     }
 
     return true;
@@ -2044,219 +2798,194 @@ std::string TStrTool::EncodeStrToBase64Str(std::wstring const& strW, size_t leng
     return EncodeToBase64Str_Native(reinterpret_cast<BYTE const*>(strW.c_str()), length * sizeof(wchar_t), makeWebFriendly);
 }
 //---------------------------------------------------------------------------
-//-Static
-//-See: http://www.zedwood.com/article/cpp-convert-to-base64-function
-//-Better optimized than other routines that use Windows function
-std::string TStrTool::EncodeToBase64Str_Native(BYTE const* bytes, size_t bytesLen, bool makeWebFriendly)
+// -Static
+// -Writes the padded Base64 for 'bytes' into 'dest' (no null terminator). 'destSize' must be at least
+//  GetBase64EncodedSize(bytesLen). On success, 'destLen' (optional) is set to the characters written.
+bool TStrTool::EncodeToBase64(BYTE const* bytes, size_t bytesLen, char* dest, size_t destSize, size_t* destLen,
+    bool makeWebFriendly)
 {
-    static unsigned char const* base64_chars_std =
-        reinterpret_cast<unsigned char const*>("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
-    static unsigned char const* base64_chars_web =
-        reinterpret_cast<unsigned char const*>("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
-    unsigned char const* base64_chars = makeWebFriendly ? base64_chars_web : base64_chars_std;
-    size_t i = 0, ix = 0, leng = bytesLen;
-//  std::stringstream q;
-//
-//  for(i=0,ix=leng - leng%3; i<ix; i+=3)
-//  {
-//      q<< base64_chars[ (bytes[i] & 0xfc) >> 2 ];
-//      q<< base64_chars[ ((bytes[i] & 0x03) << 4) + ((bytes[i+1] & 0xf0) >> 4)  ];
-//      q<< base64_chars[ ((bytes[i+1] & 0x0f) << 2) + ((bytes[i+2] & 0xc0) >> 6)  ];
-//      q<< base64_chars[ bytes[i+2] & 0x3f ];
-//  }
-//
-//  if (ix<leng)
-//  {
-//      q<< base64_chars[ (bytes[ix] & 0xfc) >> 2 ];
-//      q<< base64_chars[ ((bytes[ix] & 0x03) << 4) + (ix+1<leng ? (bytes[ix+1] & 0xf0) >> 4 : 0)];
-//      q<< (ix+1<leng ? base64_chars[ ((bytes[ix+1] & 0x0f) << 2) ] : '=');
-//      q<< '=';
-//  }
-//  return q.str().c_str();
-
-    //ASW - no longer using a stream - optimized for speed
-
-    //get needed buffer size
-//  size_t bufferSize = 0;
-//
-//  for(i=0,ix=leng - leng%3; i<ix; i+=3)
-//      bufferSize+=4;
-//
-//  if (ix<leng)
-//      bufferSize+=4;
+    char const* const alphabet = makeWebFriendly ? Base64_AlphabetUrl : Base64_AlphabetStd;
+    size_t const requiredSize = GetBase64EncodedSize(bytesLen);
 
-    size_t bufferSize = (((4ULL * leng / 3ULL) + 3ULL) & ~3ULL) + sizeof('\0');
-    //bufferSize += sizeof('\0');
+    if (nullptr != destLen)
+        *destLen = 0;
 
-    //allocate exact size of buffer and populate with base 64
-    unsigned char* buffer = new unsigned char[bufferSize];
-    std::unique_ptr<unsigned char[]> auto_buffer(buffer);
-    unsigned char* walker = buffer;
+    if (destSize < requiredSize || (bytesLen > 0 && (nullptr == bytes || nullptr == dest)))
+        return false;
+
+    size_t const wholeLen = bytesLen - bytesLen % 3;
+    char* walker = dest;
 
-    for(i = 0, ix = leng - leng % 3; i<ix; i += 3)
+    for (size_t i = 0; i < wholeLen; i += 3)
     {
-        *walker++ = base64_chars[ (bytes[i] & 0xfc) >> 2 ];
-        *walker++ = base64_chars[ ((bytes[i] & 0x03) << 4) + ((bytes[i + 1] & 0xf0) >> 4)  ];
-        *walker++ = base64_chars[ ((bytes[i + 1] & 0x0f) << 2) + ((bytes[i + 2] & 0xc0) >> 6)  ];
-        *walker++ = base64_chars[ bytes[i + 2] & 0x3f ];
+        uint32_t const group = (static_cast<uint32_t>(bytes[i]) << 16) | (static_cast<uint32_t>(bytes[i + 1]) << 8) |
+            bytes[i + 2];
+
+        walker[0] = alphabet[group >> 18];
+        walker[1] = alphabet[(group >> 12) & 0x3F];
+        walker[2] = alphabet[(group >> 6) & 0x3F];
+        walker[3] = alphabet[group & 0x3F];
+        walker += 4;
     }
 
-    if (ix<leng)
+    if (wholeLen < bytesLen)
     {
-        *walker++ = base64_chars[ (bytes[ix] & 0xfc) >> 2 ];
-        *walker++ = base64_chars[ ((bytes[ix] & 0x03) << 4) + (ix + 1<leng ? (bytes[ix + 1] & 0xf0) >> 4 : 0)];
-        *walker++ = (ix + 1<leng ? base64_chars[ ((bytes[ix + 1] & 0x0f) << 2) ] : '=');
-        *walker++ = '=';
+        bool const hasSecond = wholeLen + 1 < bytesLen;
+        uint32_t const group = (static_cast<uint32_t>(bytes[wholeLen]) << 16) |
+            (hasSecond ? static_cast<uint32_t>(bytes[wholeLen + 1]) << 8 : 0);
+
+        walker[0] = alphabet[group >> 18];
+        walker[1] = alphabet[(group >> 12) & 0x3F];
+        walker[2] = hasSecond ? alphabet[(group >> 6) & 0x3F] : '=';
+        walker[3] = '=';
+        walker += 4;
     }
 
-    *walker = '\0';
+    if (nullptr != destLen)
+        *destLen = static_cast<size_t>(walker - dest);
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Encodes into a string sized up front, in one pass.
+std::string TStrTool::EncodeToBase64Str_Native(BYTE const* bytes, size_t bytesLen, bool makeWebFriendly)
+{
+    std::string result(GetBase64EncodedSize(bytesLen), '\0');
+
+    if (!result.empty())
+        EncodeToBase64(bytes, bytesLen, &result[0], result.size(), nullptr, makeWebFriendly);
 
-    std::string result = reinterpret_cast<char*>(buffer);
     return result;
 }
 //---------------------------------------------------------------------------
 // -Static
 // -Assumes that 'inB64' contains utf8 text data.
+// -Returns an empty string if 'inB64' isn't valid Base64: a character outside both alphabets, padding that
+//  doesn't end a whole quad, or a length leaving one character over.
+// -Padding is optional. Unpadded input decodes to exactly the bytes it encodes.
 std::string TStrTool::DecodeBase64ToStrA(std::string const& inB64)
 {
-    if (inB64.length() == 0)
+    size_t const size = GetBase64DecodedSize(inB64.c_str(), inB64.length());
+    if (0 == size || Base64_InvalidSize == size)
         return "";
 
-    //get the size of the buffer needed to stor the decoded data
-    size_t buffSize = 0;
-    int decodeRes = DecodeBase64ToBytes_Native(inB64.c_str(), nullptr, &buffSize);
+    std::string result(size, '\0');
 
-    if (decodeRes < 0)
+    if (!DecodeBase64ToBytes(inB64.c_str(), inB64.length(), reinterpret_cast<BYTE*>(&result[0]), size, nullptr))
         return "";
 
-    //now that we know the buffer size, allocate and decode
-    BYTE* buff = new BYTE[buffSize + sizeof('\0')];
-    std::unique_ptr<BYTE[]> auto_buff(buff);
-
-    buff[buffSize] = '\0'; //safety - not needed, but can help with debugging
+    return result;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Assumes that 'inB64' contains wide char text data.
+// -Returns an empty string if 'inB64' isn't valid Base64: a character outside both alphabets, padding that
+//  doesn't end a whole quad, or a length leaving one character over.
+// -Padding is optional. Unpadded input decodes to exactly the bytes it encodes.
+std::wstring TStrTool::DecodeBase64ToStrW(std::string const& inB64)
+{
+    size_t const size = GetBase64DecodedSize(inB64.c_str(), inB64.length());
+    if (0 == size || Base64_InvalidSize == size)
+        return L"";
 
-    int bytesWritten = DecodeBase64ToBytes_Native(inB64.c_str(), buff, &buffSize);
+    // Room for a trailing partial character, which is dropped
+    std::wstring result((size + sizeof(wchar_t) - 1) / sizeof(wchar_t), L'\0');
 
-    if (bytesWritten <= 0)
+    if (!DecodeBase64ToBytes(inB64.c_str(), inB64.length(), reinterpret_cast<BYTE*>(&result[0]),
+        result.size() * sizeof(wchar_t), nullptr))
     {
-        return "";
+        return L"";
     }
 
-    std::string resultStr(reinterpret_cast<char*>(buff), static_cast<size_t>(bytesWritten));
-    return resultStr;
+    result.resize(size / sizeof(wchar_t));
+    return result;
 }
 //---------------------------------------------------------------------------
 // -Static
-// -Assumes that 'inB64' contains wide char text data.
-std::wstring TStrTool::DecodeBase64ToStrW(std::string const& inB64)
+// -Validates and decodes in one pass. Padding is optional, and both the standard and web friendly alphabets are
+//  accepted. 'destSize' must be at least GetBase64DecodedSize(src, srcLen).
+// -On success, 'destLen' (optional) is set to the bytes written. Returns false, having possibly written to
+//  'dest', if 'src' isn't valid Base64.
+bool TStrTool::DecodeBase64ToBytes(char const* src, size_t srcLen, BYTE* dest, size_t destSize, size_t* destLen)
 {
-    if (inB64.length() == 0)
-        return L"";
+    if (nullptr != destLen)
+        *destLen = 0;
 
-    //get the size of the buffer needed to stor the decoded data
-    size_t buffSize = 0;
-    int decodeRes = DecodeBase64ToBytes_Native(inB64.c_str(), nullptr, &buffSize);
+    size_t const requiredSize = GetBase64DecodedSize(src, srcLen);
+    if (Base64_InvalidSize == requiredSize || destSize < requiredSize || (requiredSize > 0 && nullptr == dest))
+        return false;
 
-    if (decodeRes < 0)
-        return L"";
+    if (0 == requiredSize)
+        return true;
 
-    //now that we know the buffer size, allocate and decode
-    BYTE* buff = new BYTE[buffSize + sizeof('\0')];
-    std::unique_ptr<BYTE[]> auto_buff(buff);
+    TBase64Tables const& tables = GetBase64Tables();
+    uint32_t const (*d)[256] = tables.Decode;
+    unsigned char const* walker = reinterpret_cast<unsigned char const*>(src);
+    BYTE* out = dest;
 
-    buff[buffSize] = '\0'; //safety - not needed, but can help with debugging
+    // Padding is already accounted for in requiredSize, so only data characters are read below
+    size_t const wholeQuads = requiredSize / 3;
+    size_t const tailBytes = requiredSize % 3;
 
-    int bytesWritten = DecodeBase64ToBytes_Native(inB64.c_str(), buff, &buffSize);
+    // Invalid characters set high bits, collected here and checked once at the end rather than per quad
+    uint32_t bad = 0;
 
-    if (bytesWritten <= 0)
+    for (size_t i = 0; i < wholeQuads; i++)
     {
-        return L"";
+        uint32_t const group = d[0][walker[0]] | d[1][walker[1]] | d[2][walker[2]] | d[3][walker[3]];
+        bad |= group;
+
+        out[0] = static_cast<BYTE>(group);
+        out[1] = static_cast<BYTE>(group >> 8);
+        out[2] = static_cast<BYTE>(group >> 16);
+
+        walker += 4;
+        out += 3;
     }
 
-    std::wstring resultStr(reinterpret_cast<wchar_t*>(buff), static_cast<size_t>(bytesWritten) / sizeof(wchar_t));
-    return resultStr;
+    if (2 == tailBytes)
+    {
+        uint32_t const group = d[0][walker[0]] | d[1][walker[1]] | d[2][walker[2]];
+        bad |= group;
+        out[0] = static_cast<BYTE>(group);
+        out[1] = static_cast<BYTE>(group >> 8);
+    }
+    else if (1 == tailBytes)
+    {
+        uint32_t const group = d[0][walker[0]] | d[1][walker[1]];
+        bad |= group;
+        out[0] = static_cast<BYTE>(group);
+    }
+
+    if (bad > 0x00FFFFFF)
+        return false;
+
+    if (nullptr != destLen)
+        *destLen = requiredSize;
+
+    return true;
 }
 //---------------------------------------------------------------------------
 // -Pass null for "destBytes" to calculate the needed buffer size, which, on success, will be
 //	written to "destBytesSize" and zero will be returned.
 // -If "destBytes" is not null, on success, returns the number of bytes written. If "destBytes" is
 //	not big enough, then only what can fit will be written.
-// -Returns less than zero for failure.
+// -Returns less than zero for failure, which includes input DecodeBase64ToStrA() rejects.
 int TStrTool::DecodeBase64ToBytes_Native(char const* src, BYTE* destBytes, size_t* destBytesSize)
 {
-// #pragma warning(push , 0)
-#if __cplusplus >= 201103L
-    constexpr BYTE n1 = static_cast<BYTE>(-1);
-#else
-    static const BYTE n1 = static_cast<BYTE>(-1);
-#endif
-    static BYTE const base64_reverse[] = {
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, 62, n1, n1, n1, 63, 52, 53,
-        54, 55, 56, 57, 58, 59, 60, 61, n1, n1,
-        n1, n1, n1, n1, n1,  0,  1,  2,  3,  4,
-        5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
-        15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
-        25, n1, n1, n1, n1, n1, n1, 26, 27, 28,
-        29, 30, 31, 32, 33, 34, 35, 36, 37, 38,
-        39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
-        49, 50, 51, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1, n1, n1, n1, n1,
-        n1, n1, n1, n1, n1, n1 };
-// #pragma warning(pop)
-    size_t srcLen = (nullptr == src ? 0 : strlen(src));
-
-//  std::stringstream q;
-//  if ((leng%4)==0)
-//  {
-//      leng = s[leng-1]=='=' ? leng-1 : leng;
-//      leng = s[leng-1]=='=' ? leng-1 : leng;
-//
-//      for(i=0,ix=leng-(leng%4); i<ix; i+=4)
-//      {
-//          q<< (char)((base64_reverse[ s[i] ] << 2)           + ((base64_reverse[ s[i+1] ] & 0x30) >> 4));
-//          q<< (char)(((base64_reverse[ s[i+1] ] & 0xf) << 4) + ((base64_reverse[ s[i+2] ] & 0x3c) >> 2));
-//          q<< (char)(((base64_reverse[ s[i+2] ] & 0x3) << 6) + base64_reverse[ s[i+3] ]);
-//      }
-//      if (ix<leng)
-//      {
-//          q<< (char)( (base64_reverse[ s[ix] ] << 2)          + (ix+1<leng ? (base64_reverse[ s[ix+1] ] & 0x30) >> 4 : 0)   );
-//          q<< (char)( ix+1<leng ? ((base64_reverse[ s[ix+1] ] & 0xf) << 4) + (ix+2<leng ? (base64_reverse[ s[ix+2] ] & 0x3c) >> 2 :0 ) : '\0' );
-//          q<< (char)( ix+2<leng ? (base64_reverse[ s[ix+2] ] & 0x3) << 6  : '\0' );
-//      }
-//  }
-//    return q.str();
-
-    //ASW - removed stream - optimized for speed
-
     if (nullptr == destBytesSize)
-    {
-        //ELog.fwprintf(ELogMsgLevel::LML_Light, L"%s: Error: destBytesSize is null.\n", codeSectionStr);
         return -1;
-    }
 
     if (nullptr == src)
     {
         if (nullptr == destBytes)
             *destBytesSize = 0;
-        //ELog.fwprintf(ELogMsgLevel::LML_Light, L"%s: Error: src is null.\n", codeSectionStr);
         return -2;
     }
 
+    size_t const srcLen = strlen(src);
+
     if (0 == srcLen)
     {
         if (nullptr == destBytes)
@@ -2264,29 +2993,15 @@ int TStrTool::DecodeBase64ToBytes_Native(char const* src, BYTE* destBytes, size_
         return 0; //nothing to do
     }
 
-    if (srcLen < 2)
+    size_t const requiredSize = GetBase64DecodedSize(src, srcLen);
+
+    if (srcLen < 2 || Base64_InvalidSize == requiredSize)
     {
         if (nullptr == destBytes)
             *destBytesSize = 0;
-        //ELog.fwprintf(ELogMsgLevel::LML_Light, L"%s: Error: src is invalid.\n", codeSectionStr);
         return -3;
     }
 
-    size_t pad1 = srcLen % 4 || src[srcLen - 1] == '=';
-    size_t pad2 = pad1 && (srcLen % 4 > 2 || src[srcLen - 2] != '=');
-    size_t const last = (srcLen - pad1) / 4 << 2;
-    size_t requiredSize = (last / 4 * 3) + pad1 + pad2;
-
-//      for(i=0,ix=leng-(leng%4); i<ix; i+=4)
-//          requiredSize += 3;
-//
-//      if (ix<leng)
-//      {
-//          requiredSize++;
-//          requiredSize += (ix+1 < leng ? 1 : 0);
-//          requiredSize += (ix+2 < leng ? 1 : 0);
-//      }
-
     //if destBytes is NULL, set the size that it needs to be and we are done
     if (nullptr == destBytes)
     {
@@ -2294,76 +3009,74 @@ int TStrTool::DecodeBase64ToBytes_Native(char const* src, BYTE* destBytes, size_
         return 0;
     }
 
+    size_t written = 0;
+
+    if (*destBytesSize >= requiredSize)
+    {
+        if (!DecodeBase64ToBytes(src, srcLen, destBytes, *destBytesSize, &written))
+            return -4;
+
+        return static_cast<int>(written);
+    }
+
     //Don't overrun output buffer. Don't error if buffer is insufficient size because the caller
     //may just need the header, for example, when the data is binary.
-    size_t maxFill = *destBytesSize < requiredSize ? *destBytesSize : requiredSize;
-
-    size_t i = 0, ix = 0, leng = srcLen;
-    BYTE* walker = destBytes;
-    size_t filledCount = 0;
+    size_t const wholeQuads = *destBytesSize / 3;
+    size_t const extraBytes = *destBytesSize % 3;
 
-    leng = src[leng - 1] == '=' ? leng - 1 : leng;
-    leng = src[leng - 1] == '=' ? leng - 1 : leng;
+    if (!DecodeBase64ToBytes(src, wholeQuads * 4, destBytes, *destBytesSize, &written))
+        return -4;
 
-    for (i = 0, ix = leng - (leng % 4); i < ix; i += 4)
+    if (extraBytes > 0)
     {
-        //if there is room for the next triple, get at once, for speed
-        if (filledCount + 3 <= maxFill)
-        {
-            *walker++ = static_cast<BYTE>((base64_reverse[static_cast<size_t>(src[i])] << 2) +
-                ((base64_reverse[static_cast<size_t>(src[i + 1])] & 0x30) >> 4));
-            *walker++ = static_cast<BYTE>(((base64_reverse[static_cast<size_t>(src[i + 1])] & 0xf) << 4) +
-                ((base64_reverse[static_cast<size_t>(src[i + 2])] & 0x3c) >> 2));
-            *walker++ = static_cast<BYTE>(((base64_reverse[static_cast<size_t>(src[i + 2])] & 0x3) << 6) +
-                base64_reverse[static_cast<size_t>(src[i + 3])]);
-            filledCount += 3;
-        }
-        else
-        {
-            //destination buffer is insufficient size for a triple - top off
-            if (filledCount < maxFill)
-            {
-                *walker++ = static_cast<BYTE>((base64_reverse[static_cast<size_t>(src[i])] << 2) +
-                    ((base64_reverse[static_cast<size_t>(src[i + 1])] & 0x30) >> 4));
-                filledCount++;
-            }
+        BYTE quad[3];
+        size_t const quadStart = wholeQuads * 4;
+        size_t const quadLen = srcLen - quadStart < 4 ? srcLen - quadStart : 4;
 
-            if (filledCount < maxFill)
-            {
-                *walker++ = static_cast<BYTE>(((base64_reverse[static_cast<size_t>(src[i + 1])] & 0xf) << 4) +
-                    ((base64_reverse[static_cast<size_t>(src[i + 2])] & 0x3c) >> 2));
-                filledCount++;
-            }
+        if (!DecodeBase64ToBytes(src + quadStart, quadLen, quad, sizeof(quad), nullptr))
+            return -4;
 
-            break; //destination buffer full, stop reading
-        }
+        for (size_t i = 0; i < extraBytes; i++)
+            destBytes[written++] = quad[i];
     }
 
-    //get remainder, if any, and if destination buffer is big enough
-    if (ix < leng && filledCount < maxFill)
-    {
-        *walker++ = static_cast<BYTE>((base64_reverse[static_cast<size_t>(src[ix])] << 2) +
-            (ix + 1 < leng ? (base64_reverse[static_cast<size_t>(src[ix + 1])] & 0x30) >> 4 : 0));
-        filledCount++;
+    return static_cast<int>(written);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Exact number of bytes 'src' decodes to, from its length and padding alone, or Base64_InvalidSize if the
+//  length can't be Base64. The characters themselves are checked when decoding.
+size_t TStrTool::GetBase64DecodedSize(char const* src, size_t srcLen)
+{
+    if (0 == srcLen)
+        return 0;
 
-        if(filledCount < maxFill)
-        {
-            *walker++ = static_cast<BYTE>(ix + 1 < leng ?
-                    ((base64_reverse[static_cast<size_t>(src[ix + 1])] & 0xf) << 4) +
-                    (ix + 2 < leng ? (base64_reverse[static_cast<size_t>(src[ix + 2])] & 0x3c) >> 2 :0 ) :
-                    '\0' );
-            filledCount++;
-        }
+    if (nullptr == src)
+        return Base64_InvalidSize;
 
-        if(filledCount < maxFill)
-        {
-            *walker++ =
-                static_cast<BYTE>(ix + 2 < leng ? (base64_reverse[static_cast<size_t>(src[ix + 2])] & 0x3) << 6 : '\0');
-            filledCount++;
-        }
-    }
+    size_t padding = 0;
+    while (padding < 2 && padding < srcLen && src[srcLen - 1 - padding] == '=')
+        padding++;
+
+    // Padded input comes in whole quads
+    if (padding > 0 && 0 != srcLen % 4)
+        return Base64_InvalidSize;
+
+    size_t const dataLen = srcLen - padding;
+    size_t const remainder = dataLen % 4;
+
+    // One character on its own is only 6 bits
+    if (1 == remainder)
+        return Base64_InvalidSize;
 
-    return static_cast<int>(filledCount);
+    return dataLen / 4 * 3 + (remainder > 0 ? remainder - 1 : 0);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Characters of padded Base64 for 'bytesLen' bytes.
+size_t TStrTool::GetBase64EncodedSize(size_t bytesLen)
+{
+    return (bytesLen + 2) / 3 * 4;
 }
 //---------------------------------------------------------------------------
 // -Static
@@ -2519,84 +3232,149 @@ std::string TStrTool::URL_DecodeUtf8(std::string const& encodedStr, bool* invali
     return valUtf8Str;
 }
 //---------------------------------------------------------------------------
-std::string TStrTool::Fmt_printf(char const* format, ...)
+namespace
 {
-    size_t const initialBufferSize = 1024;
-    size_t bufferSize = initialBufferSize;
-    int len;
-    va_list args;
 
-    //create a decent size buffer that may need to be reallocated later
-    char* text = new char[bufferSize];
-    std::unique_ptr<char[]> auto_text(text);
+size_t const Fmt_StackBufferLen = 1024; // Most messages fit, so they never allocate a scratch buffer
+size_t const Fmt_MaxBufferLen = 16 * 1024 * 1024; // Stop retrying when the format can't be satisfied at all
 
-    va_start(args, format);
+// -Same contract for both char widths: the formatted length, or less than zero if it didn't fit or the format
+//  failed. Some runtimes return the needed length when it didn't fit, which is also handled.
+int VFormat(char* buffer, size_t bufferLen, char const* format, va_list args)
+{
+    return vsnprintf(buffer, bufferLen, format, args);
+}
+//---------------------------------------------------------------------------
+int VFormat(wchar_t* buffer, size_t bufferLen, wchar_t const* format, va_list args)
+{
+#ifdef __BORLANDC__
+    return vsnwprintf(buffer, bufferLen, format, args);
+#else
+    #ifdef USE_SAFESTR_FUNCS
+    return _vsnwprintf_s(buffer, bufferLen, _TRUNCATE, format, args);
+    #else
+    return _vsnwprintf(buffer, bufferLen, format, args);
+    #endif
+#endif
+}
+//---------------------------------------------------------------------------
+// -Formats into a stack buffer first, then, only if that is too small, straight into 'dest', growing it until the
+//  text fits. 'dest' keeps its capacity, so a string reused across calls stops allocating.
+// -Each attempt consumes its own va_copy of 'args' - a va_list can't be read twice.
+template <typename TChar, typename TString>
+bool VFormatToString(TString* dest, TChar const* format, va_list args)
+{
+    if (nullptr == dest)
+        return false;
+
+    if (nullptr == format)
+    {
+        dest->clear();
+        return false;
+    }
 
-    //Get the needed length of the format string - if allocated size is enough,
-    //then were done because the printf worked.
-    len = vsnprintf(text, bufferSize, format, args) + 1; //add 1 for null char
+    TChar stackBuffer[Fmt_StackBufferLen];
+    TChar* buffer = stackBuffer;
+    size_t bufferLen = Fmt_StackBufferLen;
 
-    if (len > static_cast<int>(bufferSize))
+    for (;;)
     {
-        bufferSize = static_cast<size_t>(len);
-        auto_text.reset(new char[bufferSize]);
-        text = auto_text.get();
-        //get the string again now that there is enough room for it
-        vsnprintf(text, bufferSize, format, args);
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        int const len = VFormat(buffer, bufferLen, format, argsCopy);
+        va_end(argsCopy);
+
+        //the length excludes the null, which must also have fit
+        if (len >= 0 && static_cast<size_t>(len) < bufferLen)
+        {
+            if (buffer == stackBuffer)
+                dest->assign(stackBuffer, static_cast<size_t>(len));
+            else
+                dest->resize(static_cast<size_t>(len));
+
+            return true;
+        }
+
+        if (bufferLen >= Fmt_MaxBufferLen)
+        {
+            dest->clear();
+            return false;
+        }
+
+        //use the needed length when the runtime reports it, otherwise keep doubling
+        bufferLen = len >= 0 ? static_cast<size_t>(len) + 1 : bufferLen * 2;
+        dest->resize(bufferLen);
+        buffer = &(*dest)[0];
     }
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+std::string TStrTool::Fmt_printf(char const* format, ...)
+{
+    std::string result;
+    va_list args;
 
+    va_start(args, format);
+    Fmt_vprintf(&result, format, args);
     va_end(args);
-    std::string result = text;
+
     return result;
 }
 //---------------------------------------------------------------------------
 std::wstring TStrTool::Fmt_printf(wchar_t const* format, ...)
 {
-    size_t const initialBufferSize = 1024;
-    size_t bufferSize = initialBufferSize;
-    int len;
+    std::wstring result;
     va_list args;
 
-    //create a decent size buffer that may need to be reallocated later
-    wchar_t* text = new wchar_t[bufferSize];
-    std::unique_ptr<wchar_t[]> auto_text(text);
-
     va_start(args, format);
+    Fmt_vprintf(&result, format, args);
+    va_end(args);
 
-    //Get the needed length of the format string - if allocated size is enough,
-    //then were done because the printf worked.
-#ifdef __BORLANDC__
-    len = vsnwprintf(text, bufferSize, format, args) + 1; //add 1 for null char
-#else
-    #ifdef USE_SAFESTR_FUNCS
-    len = _vsnwprintf_s(text, bufferSize, _TRUNCATE, format, args) + 1; //add 1 for null char
-    #else
-    len = _vsnwprintf(text, bufferSize, format, args) + 1; //add 1 for null char
-    #endif
-#endif
+    return result;
+}
+//---------------------------------------------------------------------------
+// -Formats into 'dest', replacing its contents and reusing its capacity. Returns false, with 'dest' empty, on a
+//  format error.
+bool TStrTool::Fmt_printf(std::string* dest, char const* format, ...)
+{
+    va_list args;
 
-    if (len > static_cast<int>(bufferSize))
-    {
-        bufferSize = static_cast<size_t>(len);
-        auto_text.reset(new wchar_t[bufferSize]);
-        text = auto_text.get();
-        //get the string again now that there is enough room for it
-#ifdef __BORLANDC__
-        vsnwprintf(text, bufferSize, format, args);
-#else
-    #ifdef USE_SAFESTR_FUNCS
-        _vsnwprintf_s(text, bufferSize, _TRUNCATE, format, args);
-    #else
-        _vsnwprintf(text, bufferSize, format, args);
-    #endif
-#endif
-    }
+    va_start(args, format);
+    bool const result = Fmt_vprintf(dest, format, args);
+    va_end(args);
+
+    return result;
+}
+//---------------------------------------------------------------------------
+// -Formats into 'dest', replacing its contents and reusing its capacity. Returns false, with 'dest' empty, on a
+//  format error.
+bool TStrTool::Fmt_printf(std::wstring* dest, wchar_t const* format, ...)
+{
+    va_list args;
 
+    va_start(args, format);
+    bool const result = Fmt_vprintf(dest, format, args);
     va_end(args);
-    std::wstring result = text;
+
     return result;
 }
 //---------------------------------------------------------------------------
+// -As Fmt_printf(), for callers with their own variable arguments. 'args' is copied, not consumed, so the caller
+//  may use it again.
+bool TStrTool::Fmt_vprintf(std::string* dest, char const* format, va_list args)
+{
+    return VFormatToString(dest, format, args);
+}
+//---------------------------------------------------------------------------
+// -As Fmt_printf(), for callers with their own variable arguments. 'args' is copied, not consumed, so the caller
+//  may use it again.
+bool TStrTool::Fmt_vprintf(std::wstring* dest, wchar_t const* format, va_list args)
+{
+    return VFormatToString(dest, format, args);
+}
+//---------------------------------------------------------------------------
 // -Static
 // -If idStr is empty or null, guid is set to zeros
 bool TStrTool::StrToGUID(char const* idStr, GUID& guid)
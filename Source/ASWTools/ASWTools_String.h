@@ -25,7 +25,9 @@ limitations under the License.
 #ifndef ASWTools_StringH
 #define ASWTools_StringH
 //---------------------------------------------------------------------------
+#include <cstdarg> //va_list
 #include <cstdint> //int64_t
+#include <cstring> //memchr
 #include <iomanip>  //for GUID stuff
 #include <sstream>
 #include <string>
@@ -38,6 +40,83 @@ limitations under the License.
 namespace ASWTools
 {
 
+/////////////////////////////////////////////////////////////////////////////
+// TStrView
+//
+// Non-owning view of a run of chars. The part of std::string_view that the
+// tokenizing and trimming functions need, available before C++17. The viewed
+// chars must outlive the view.
+/////////////////////////////////////////////////////////////////////////////
+class TStrView
+{
+public: // Static vars
+    static size_t const npos = static_cast<size_t>(-1);
+
+private:
+    char const* m_Data;
+    size_t m_Size;
+
+public:
+    TStrView() : m_Data(""), m_Size(0) {}
+    TStrView(char const* str) : m_Data(nullptr == str ? "" : str), m_Size(nullptr == str ? 0 : strlen(str)) {}
+    TStrView(char const* data, size_t size) : m_Data(data), m_Size(size) {}
+    TStrView(std::string const& str) : m_Data(str.data()), m_Size(str.size()) {}
+
+    char const* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+    size_t length() const { return m_Size; }
+    bool empty() const { return 0 == m_Size; }
+    char const* begin() const { return m_Data; }
+    char const* end() const { return m_Data + m_Size; }
+    char operator[](size_t idx) const { return m_Data[idx]; }
+
+    size_t find(char c, size_t pos = 0) const;
+    TStrView substr(size_t pos, size_t count = npos) const;
+    void remove_prefix(size_t count) { m_Data += count; m_Size -= count; }
+    void remove_suffix(size_t count) { m_Size -= count; }
+
+    bool operator==(TStrView const& rhs) const;
+    bool operator!=(TStrView const& rhs) const { return !(*this == rhs); }
+
+    std::string ToString() const { return std::string(m_Data, m_Size); }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TStrSplitter
+//
+// Lazily walks the fields of a delimited string, as TStrTool::Split() would
+// return them, without copying. An empty string is one empty field.
+/////////////////////////////////////////////////////////////////////////////
+class TStrSplitter
+{
+private:
+    TStrView m_Remaining;
+    char m_Sep;
+    bool m_Done;
+
+public:
+    TStrSplitter(TStrView str, char const sep);
+
+    bool Next(TStrView* field);
+};
+
+
+enum class EFromCharsErr
+{
+    None,
+    InvalidArgument, // No number at the start of the text
+    OutOfRange // A number, but too big for the type
+};
+
+// As std::from_chars_result - 'Ptr' is just past the parsed text, or the start of the text on InvalidArgument.
+struct TFromCharsResult
+{
+    char const* Ptr;
+    EFromCharsErr Err;
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TStrTool
 /////////////////////////////////////////////////////////////////////////////
@@ -53,6 +132,14 @@ public: // const static variables
     static char const Base64_Plus = '+'; //base64 can contain '+' - use this to replace if in a URL
     static char const Base64_URLSafe_Slash = '_'; //base64 can contain '/' - use this to replace if in a URL
     static char const Base64_URLSafe_Plus = '-'; //base64 can contain '+' - use this to replace if in a URL
+    static size_t const Base64_InvalidSize = static_cast<size_t>(-1); //GetBase64DecodedSize() for a bad length
+
+    static size_t const ToChars_MaxIntLen = 20; //"-9223372036854775808" and "18446744073709551615", no null
+    static size_t const ToChars_MaxDoubleLen = 32; //enough for any precision ToChars() allows, no null
+
+    static size_t const DateTime_ISO8601_MaxLen = 24; //"9999-12-31T23:59:59.999Z", no null
+    static int64_t const DateTime_MinEpochMs = -62135596800000LL; //0001-01-01T00:00:00.000Z
+    static int64_t const DateTime_MaxEpochMs = 253402300799999LL; //9999-12-31T23:59:59.999Z
 
 protected:
     static void DateTime_SetComponents(int y, int month, int d, int h, int min, int s, int ms, int tzH, int tzM,
@@ -84,6 +171,9 @@ public:
     static bool DateTime_Parse_ISO8601(std::string const& iso8601Str,
         int* outYear, int* outMonth, int* outDay, int* outHour, int* outMin, int* outSec, int* outMS,
         int* outTZOffsetH, int* outTZOffsetM);
+    static int64_t DateTime_GetUTCNow_EpochMs();
+    static char* DateTime_EpochMsToChars_ISO8601(char* first, char* last, int64_t epochMs, bool withMilliSecs);
+    static bool DateTime_CharsToEpochMs_ISO8601(char const* first, char const* last, int64_t* outEpochMs);
 
     static std::wstring GetDateTimeStr_LocalW(bool fileNameFriendly = false);
     static std::string GetDateTimeStr_LocalA(bool fileNameFriendly = false);
@@ -96,9 +186,27 @@ public:
     static bool StrNCpy_safeA(char* dest, size_t destSize_bytes, char const* src, size_t maxCount);
     static bool StrNCpy_safeT(TCHAR* dest, size_t destArrayLen, TCHAR const* src, size_t maxCount);
 
-    static bool ToBool(std::string const& str);
+    static bool ToBool(TStrView str);
     static bool ToBool(std::wstring const& str);
 
+    static char* ToChars(char* first, char* last, int32_t value);
+    static char* ToChars(char* first, char* last, int64_t value);
+    static char* ToChars(char* first, char* last, uint32_t value);
+    static char* ToChars(char* first, char* last, uint64_t value);
+    static char* ToChars(char* first, char* last, double value, int precision = 6);
+
+    // Non-template overloads for the common numeric types skip the stream. Anything else uses the templates.
+    static std::string ToStringA(int32_t value);
+    static std::string ToStringA(int64_t value);
+    static std::string ToStringA(uint32_t value);
+    static std::string ToStringA(uint64_t value);
+    static std::string ToStringA(double value);
+    static std::wstring ToStringW(int32_t value);
+    static std::wstring ToStringW(int64_t value);
+    static std::wstring ToStringW(uint32_t value);
+    static std::wstring ToStringW(uint64_t value);
+    static std::wstring ToStringW(double value);
+
     template <typename T>
     static std::string ToStringA(T const& value)
     {
@@ -116,8 +224,12 @@ public:
 
     static std::string ToLower(std::string const& str);
     static std::wstring ToLower(std::wstring const& str);
+    static void ToLower_InPlace(std::string& str);
+    static void ToLower_InPlace(std::wstring& str);
     static std::string ToUpper(std::string const& str);
     static std::wstring ToUpper(std::wstring const& str);
+    static void ToUpper_InPlace(std::string& str);
+    static void ToUpper_InPlace(std::wstring& str);
 
     //For trim functions, see: https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
     static void TrimLeft(std::string& s);
@@ -136,33 +248,45 @@ public:
     static std::string TrimLeft_Copy(std::string s, unsigned char const trimChar, bool trim_isspace);
     static std::wstring TrimLeft_Copy(std::wstring s);
     static std::wstring TrimLeft_Copy(std::wstring s, wchar_t const trimChar, bool trim_iswspace);
+    static TStrView TrimLeft_View(TStrView s);
+    static TStrView TrimLeft_View(TStrView s, unsigned char const trimChar, bool trim_isspace);
     static std::string TrimRight_Copy(std::string s);
     static std::string TrimRight_Copy(std::string s, unsigned char const trimChar, bool trim_isspace);
     static std::wstring TrimRight_Copy(std::wstring s);
     static std::wstring TrimRight_Copy(std::wstring s, wchar_t const trimChar, bool trim_iswspace);
+    static TStrView TrimRight_View(TStrView s);
+    static TStrView TrimRight_View(TStrView s, unsigned char const trimChar, bool trim_isspace);
     static std::string Trim_Copy(std::string s);
     static std::string Trim_Copy(std::string s, unsigned char const trimChar, bool trim_isspace);
     static std::wstring Trim_Copy(std::wstring s);
     static std::wstring Trim_Copy(std::wstring s, wchar_t const trimChar, bool trim_iswspace);
+    static TStrView Trim_View(TStrView s);
+    static TStrView Trim_View(TStrView s, unsigned char const trimChar, bool trim_isspace);
 
     static int Compare(std::string const& s1, std::string const& s2);
     static int Compare(std::wstring const& s1, std::wstring const& s2);
-    static int CompareIC(std::string const& s1, std::string const& s2);
+    static int CompareIC(TStrView s1, TStrView s2);
+    static bool EqualsIC(TStrView s1, TStrView s2);
     static int CompareIC(std::wstring const& s1, std::wstring const& s2);
 
-    static int32_t StrToInt32(std::string const& str);
-    static int64_t StrToInt64(std::string const& str);
-    static uint32_t StrToUInt32(std::string const& str);
-    static uint64_t StrToUInt64(std::string const& str);
+    static TFromCharsResult FromChars(char const* first, char const* last, int32_t* outVal);
+    static TFromCharsResult FromChars(char const* first, char const* last, int64_t* outVal);
+    static TFromCharsResult FromChars(char const* first, char const* last, uint32_t* outVal);
+    static TFromCharsResult FromChars(char const* first, char const* last, uint64_t* outVal);
+
+    static int32_t StrToInt32(TStrView str);
+    static int64_t StrToInt64(TStrView str);
+    static uint32_t StrToUInt32(TStrView str);
+    static uint64_t StrToUInt64(TStrView str);
 
-    static bool TryStrToInt32(std::string const& str, int32_t* outVal);
-    static bool TryStrToInt64(std::string const& str, int64_t* outVal);
-    static bool TryStrToUInt32(std::string const& str, uint32_t* outVal);
-    static bool TryStrToUInt64(std::string const& str, uint64_t* outVal);
+    static bool TryStrToInt32(TStrView str, int32_t* outVal);
+    static bool TryStrToInt64(TStrView str, int64_t* outVal);
+    static bool TryStrToUInt32(TStrView str, uint32_t* outVal);
+    static bool TryStrToUInt64(TStrView str, uint64_t* outVal);
 
     static bool IsSpace(int c);
 
-    static bool IsEmptyOrWhiteSpace(std::string const& s);
+    static bool IsEmptyOrWhiteSpace(TStrView s);
     static bool IsEmptyOrWhiteSpace(std::wstring const& s);
 
     static std::string CombinePathAndArgs(std::string const& path, std::string const& args);
@@ -170,6 +294,7 @@ public:
 
     static std::vector<std::string> Split(std::string const& str, const char sep);
     static std::vector<std::wstring> Split(std::wstring const& str, const wchar_t sep);
+    static size_t Split(TStrView str, const char sep, std::vector<TStrView>* fields);
 
     static std::string DelimStr_Escape(std::string const& strIn, const char delim);
     static std::wstring DelimStr_Escape(std::wstring const& strIn, const wchar_t delim);
@@ -204,10 +329,15 @@ public:
     static std::string EncodeStrToBase64Str(std::string const& strUtf8, size_t length, bool makeWebFriendly);
     static std::string EncodeStrToBase64Str(std::wstring const& strW, bool makeWebFriendly);
     static std::string EncodeStrToBase64Str(std::wstring const& strW, size_t length, bool makeWebFriendly);
+    static bool EncodeToBase64(BYTE const* bytes, size_t bytesLen, char* dest, size_t destSize, size_t* destLen,
+        bool makeWebFriendly);
     static std::string EncodeToBase64Str_Native(BYTE const* bytes, size_t bytesLen, bool makeWebFriendly);
     static std::string DecodeBase64ToStrA(std::string const& inB64);
     static std::wstring DecodeBase64ToStrW(std::string const& inB64);
+    static bool DecodeBase64ToBytes(char const* src, size_t srcLen, BYTE* dest, size_t destSize, size_t* destLen);
     static int DecodeBase64ToBytes_Native(char const* src, BYTE* destBytes, size_t* destBytesSize);
+    static size_t GetBase64DecodedSize(char const* src, size_t srcLen);
+    static size_t GetBase64EncodedSize(size_t bytesLen);
 
     static bool URL_Split(std::string const& url, std::string* hostUtf8, std::string* pathUtf8);
     static std::string URL_EncodeUtf8(std::string const& valueUtf8, bool useUpperCaseHex = true);
@@ -215,6 +345,10 @@ public:
 
     static std::string Fmt_printf(char const* format, ...);
     static std::wstring Fmt_printf(wchar_t const* format, ...);
+    static bool Fmt_printf(std::string* dest, char const* format, ...);
+    static bool Fmt_printf(std::wstring* dest, wchar_t const* format, ...);
+    static bool Fmt_vprintf(std::string* dest, char const* format, va_list args);
+    static bool Fmt_vprintf(std::wstring* dest, wchar_t const* format, va_list args);
 
     static bool StrToGUID(char const* idStr, GUID& guid);
     static bool StrToGUID(wchar_t const* idStr, GUID& guid);
@@ -0,0 +1,170 @@
+/* **************************************************************************
+ASWTools_ThreadPool.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_ThreadPool.h"
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TThreadPool
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+// 'numThreads' includes the thread that calls ParallelFor(). 0 uses one per hardware thread.
+TThreadPool::TThreadPool(size_t numThreads)
+    : m_Stop(false),
+      m_Generation(0),
+      m_Func(nullptr),
+      m_Count(0),
+      m_ChunkSize(1),
+      m_NextIdx(0),
+      m_ActiveWorkers(0)
+{
+    if (0 == numThreads)
+        numThreads = GetHardwareThreadCount();
+
+    m_Workers.reserve(numThreads - 1);
+    for (size_t i = 1; i < numThreads; i++)
+        m_Workers.push_back(std::thread(&TThreadPool::WorkerMain, this));
+}
+//---------------------------------------------------------------------------
+TThreadPool::~TThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WakeCond.notify_all();
+
+    for (size_t i = 0; i < m_Workers.size(); i++)
+        m_Workers[i].join();
+}
+//---------------------------------------------------------------------------
+size_t TThreadPool::GetHardwareThreadCount()
+{
+    unsigned int const count = std::thread::hardware_concurrency();
+    return (0 == count) ? 1 : static_cast<size_t>(count);
+}
+//---------------------------------------------------------------------------
+size_t TThreadPool::GetThreadCount() const
+{
+    return m_Workers.size() + 1;
+}
+//---------------------------------------------------------------------------
+// Calls func(begin, end) for consecutive ranges of at most 'chunkSize' covering [0, count), spread over the pool.
+// Blocks until all ranges are done. The first exception thrown by 'func' is rethrown here once the loop finishes.
+void TThreadPool::ParallelFor(size_t count, size_t chunkSize, TRangeFunc const& func)
+{
+    if (0 == count)
+        return;
+    if (0 == chunkSize)
+        chunkSize = 1;
+
+    // Not worth waking anybody up
+    if (m_Workers.empty() || count <= chunkSize)
+    {
+        func(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(m_RunMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Func = &func;
+        m_Count = count;
+        m_ChunkSize = chunkSize;
+        m_NextIdx = 0;
+        m_ActiveWorkers = m_Workers.size();
+        m_Error = nullptr;
+        m_Generation++;
+    }
+    m_WakeCond.notify_all();
+
+    RunChunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCond.wait(lock, [this] { return 0 == m_ActiveWorkers; });
+        m_Func = nullptr;
+        error = m_Error;
+        m_Error = nullptr;
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+//---------------------------------------------------------------------------
+void TThreadPool::RunChunks()
+{
+    for (;;)
+    {
+        size_t const begin = m_NextIdx.fetch_add(m_ChunkSize);
+        if (begin >= m_Count)
+            break;
+
+        size_t const end = (m_Count - begin > m_ChunkSize) ? begin + m_ChunkSize : m_Count;
+
+        try
+        {
+            (*m_Func)(begin, end);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Error)
+                m_Error = std::current_exception();
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void TThreadPool::WorkerMain()
+{
+    uint64_t seenGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeCond.wait(lock, [this, seenGeneration] { return m_Stop || m_Generation != seenGeneration; });
+            if (m_Stop)
+                return;
+            seenGeneration = m_Generation;
+        }
+
+        RunChunks();
+
+        bool lastOut;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            lastOut = (0 == --m_ActiveWorkers);
+        }
+        if (lastOut)
+            m_DoneCond.notify_one();
+    }
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWTools
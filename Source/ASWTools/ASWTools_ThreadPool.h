@@ -0,0 +1,91 @@
+/* **************************************************************************
+ASWTools_ThreadPool.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_ThreadPoolH
+#define ASWTools_ThreadPoolH
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TThreadPool
+//
+// Fixed set of worker threads for data parallel loops. ParallelFor() splits
+// [0, count) into chunks that the workers and the calling thread take in
+// turn, and returns once every chunk is done. Only one loop runs at a time;
+// concurrent callers are serialized.
+/////////////////////////////////////////////////////////////////////////////
+class TThreadPool
+{
+public:
+    typedef std::function<void(size_t begin, size_t end)> TRangeFunc;
+
+private:
+    std::vector<std::thread> m_Workers;
+    std::mutex m_RunMutex; // Serializes ParallelFor() callers
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCond;
+    std::condition_variable m_DoneCond;
+    bool m_Stop;
+    uint64_t m_Generation; // Bumped for every loop, so workers know there is new work
+
+    // Current loop
+    TRangeFunc const* m_Func;
+    size_t m_Count;
+    size_t m_ChunkSize;
+    std::atomic<size_t> m_NextIdx;
+    size_t m_ActiveWorkers;
+    std::exception_ptr m_Error;
+
+private:
+    void RunChunks();
+    void WorkerMain();
+
+public:
+    static size_t GetHardwareThreadCount();
+
+public: // Getters/Setters
+    size_t GetThreadCount() const;
+
+public:
+    explicit TThreadPool(size_t numThreads = 0);
+    ~TThreadPool();
+
+    TThreadPool(TThreadPool const&) = delete;
+    TThreadPool& operator=(TThreadPool const&) = delete;
+
+    void ParallelFor(size_t count, size_t chunkSize, TRangeFunc const& func);
+};
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_ThreadPoolH
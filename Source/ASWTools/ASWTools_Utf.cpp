@@ -0,0 +1,510 @@
+/* **************************************************************************
+ASWTools_Utf.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_Utf.h"
+//---------------------------------------------------------------------------
+// SSE2 is part of every x64 target, and of 32 bit x86 targets built for it, so it needs no run time check
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASWTOOLS_UTF_SSE2 1
+#include <emmintrin.h>
+#endif
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+// -Decodes the UTF-8 sequence at 'src', which has 'srcLen' > 0 bytes left.
+// -Returns the sequence length, with 'codePoint' set. Returns 0 for an invalid sequence, with 'invalidLen' set to
+//  the bytes to replace with one U+FFFD - the lead byte and any continuation bytes that were still acceptable.
+size_t DecodeUtf8(unsigned char const* src, size_t srcLen, uint32_t* codePoint, size_t* invalidLen)
+{
+    unsigned char const lead = src[0];
+
+    if (lead < 0x80)
+    {
+        *codePoint = lead;
+        return 1;
+    }
+
+    // The lead byte fixes the length, and narrows the first continuation byte's range to rule out overlong forms
+    // (E0, F0), surrogates (ED) and code points past U+10FFFF (F4)
+    size_t needed = 0;
+    uint32_t cp = 0;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+
+    if (lead < 0xC2)
+    {
+        *invalidLen = 1; // A stray continuation byte, or an overlong 2 byte form
+        return 0;
+    }
+    else if (lead < 0xE0)
+    {
+        needed = 1;
+        cp = lead & 0x1F;
+    }
+    else if (lead < 0xF0)
+    {
+        needed = 2;
+        cp = lead & 0x0F;
+        if (0xE0 == lead)
+            low = 0xA0;
+        else if (0xED == lead)
+            high = 0x9F;
+    }
+    else if (lead < 0xF5)
+    {
+        needed = 3;
+        cp = lead & 0x07;
+        if (0xF0 == lead)
+            low = 0x90;
+        else if (0xF4 == lead)
+            high = 0x8F;
+    }
+    else
+    {
+        *invalidLen = 1;
+        return 0;
+    }
+
+    for (size_t i = 1; i <= needed; i++)
+    {
+        if (i >= srcLen || src[i] < low || src[i] > high)
+        {
+            *invalidLen = i;
+            return 0;
+        }
+
+        cp = (cp << 6) | (src[i] & 0x3F);
+        low = 0x80;
+        high = 0xBF;
+    }
+
+    *codePoint = cp;
+    return needed + 1;
+}
+//---------------------------------------------------------------------------
+size_t GetUtf8Len(uint32_t codePoint)
+{
+    return codePoint < 0x80 ? 1 : (codePoint < 0x800 ? 2 : (codePoint < 0x10000 ? 3 : 4));
+}
+//---------------------------------------------------------------------------
+// -'dest' must have room for GetUtf8Len(codePoint) bytes.
+void EncodeUtf8(uint32_t codePoint, size_t len, unsigned char* dest)
+{
+    switch (len)
+    {
+        case 1:
+            dest[0] = static_cast<unsigned char>(codePoint);
+            break;
+        case 2:
+            dest[0] = static_cast<unsigned char>(0xC0 | (codePoint >> 6));
+            dest[1] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+            break;
+        case 3:
+            dest[0] = static_cast<unsigned char>(0xE0 | (codePoint >> 12));
+            dest[1] = static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F));
+            dest[2] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+            break;
+        default:
+            dest[0] = static_cast<unsigned char>(0xF0 | (codePoint >> 18));
+            dest[1] = static_cast<unsigned char>(0x80 | ((codePoint >> 12) & 0x3F));
+            dest[2] = static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F));
+            dest[3] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+            break;
+    }
+}
+//---------------------------------------------------------------------------
+// -Copies leading ASCII from 'src' to 'dest', widening each byte to a unit. Returns the bytes copied, which stops
+//  short of 'count' at the block holding the first non-ASCII byte. The scalar loop that follows finishes the run.
+template <typename TUnit>
+size_t WidenAscii(unsigned char const* src, size_t count, TUnit* dest)
+{
+    size_t done = 0;
+
+#if defined(ASWTOOLS_UTF_SSE2)
+    __m128i const zero = _mm_setzero_si128();
+
+    for (; done + 16 <= count; done += 16)
+    {
+        __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + done));
+        if (0 != _mm_movemask_epi8(bytes))
+            break;
+
+        __m128i const low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i const high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i* out = reinterpret_cast<__m128i*>(dest + done);
+
+        if (2 == sizeof(TUnit))
+        {
+            _mm_storeu_si128(out, low);
+            _mm_storeu_si128(out + 1, high);
+        }
+        else
+        {
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+        }
+    }
+#endif // #if defined(ASWTOOLS_UTF_SSE2)
+
+    while (done < count && src[done] < 0x80)
+    {
+        dest[done] = static_cast<TUnit>(src[done]);
+        done++;
+    }
+
+    return done;
+}
+//---------------------------------------------------------------------------
+// -Copies leading ASCII units from 'src' to 'dest' as bytes. Returns the units copied.
+template <typename TUnit>
+size_t NarrowAscii(TUnit const* src, size_t count, unsigned char* dest)
+{
+    size_t done = 0;
+
+#if defined(ASWTOOLS_UTF_SSE2)
+    if (2 == sizeof(TUnit))
+    {
+        __m128i const nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+
+        for (; done + 16 <= count; done += 16)
+        {
+            __m128i const* in = reinterpret_cast<__m128i const*>(src + done);
+            __m128i const units0 = _mm_loadu_si128(in);
+            __m128i const units1 = _mm_loadu_si128(in + 1);
+            __m128i const high = _mm_and_si128(_mm_or_si128(units0, units1), nonAsciiBits);
+
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())))
+                break;
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + done), _mm_packus_epi16(units0, units1));
+        }
+    }
+    else
+    {
+        __m128i const nonAsciiBits = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+
+        for (; done + 16 <= count; done += 16)
+        {
+            __m128i const* in = reinterpret_cast<__m128i const*>(src + done);
+            __m128i const units0 = _mm_loadu_si128(in);
+            __m128i const units1 = _mm_loadu_si128(in + 1);
+            __m128i const units2 = _mm_loadu_si128(in + 2);
+            __m128i const units3 = _mm_loadu_si128(in + 3);
+            __m128i const all = _mm_or_si128(_mm_or_si128(units0, units1), _mm_or_si128(units2, units3));
+
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonAsciiBits), _mm_setzero_si128())))
+                break;
+
+            // Every unit is below 0x80, so neither pack saturates
+            __m128i const words0 = _mm_packs_epi32(units0, units1);
+            __m128i const words1 = _mm_packs_epi32(units2, units3);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + done), _mm_packus_epi16(words0, words1));
+        }
+    }
+#endif // #if defined(ASWTOOLS_UTF_SSE2)
+
+    while (done < count && static_cast<uint32_t>(src[done]) < 0x80)
+    {
+        dest[done] = static_cast<unsigned char>(src[done]);
+        done++;
+    }
+
+    return done;
+}
+//---------------------------------------------------------------------------
+// -UTF-8 to UTF-16 for 2 byte units, UTF-32 for 4 byte units.
+template <typename TUnit>
+TUtf::TResult Utf8ToUnits(char const* src, size_t srcLen, TUnit* dest, size_t destLen, bool replaceInvalid)
+{
+    TUtf::TResult result = { TUtf::EResult::Ok, 0, 0 };
+
+    if (0 == srcLen)
+        return result;
+
+    if (nullptr == src)
+    {
+        result.Err = TUtf::EResult::InvalidInput;
+        return result;
+    }
+
+    if (nullptr == dest)
+        destLen = 0;
+
+    unsigned char const* in = reinterpret_cast<unsigned char const*>(src);
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < srcLen)
+    {
+        size_t const asciiRoom = srcLen - read < destLen - written ? srcLen - read : destLen - written;
+        size_t const asciiLen = WidenAscii(in + read, asciiRoom, dest + written);
+        read += asciiLen;
+        written += asciiLen;
+
+        if (read == srcLen)
+            break;
+
+        uint32_t codePoint = 0;
+        size_t invalidLen = 0;
+        size_t seqLen = DecodeUtf8(in + read, srcLen - read, &codePoint, &invalidLen);
+
+        if (0 == seqLen)
+        {
+            if (!replaceInvalid)
+            {
+                result.Err = TUtf::EResult::InvalidInput;
+                break;
+            }
+
+            codePoint = TUtf::ReplacementChar;
+            seqLen = invalidLen;
+        }
+
+        size_t const unitsNeeded = (2 == sizeof(TUnit) && codePoint >= 0x10000) ? 2 : 1;
+
+        if (destLen - written < unitsNeeded)
+        {
+            result.Err = TUtf::EResult::DestTooSmall;
+            break;
+        }
+
+        if (2 == unitsNeeded)
+        {
+            uint32_t const offset = codePoint - 0x10000;
+            dest[written++] = static_cast<TUnit>(0xD800 + (offset >> 10));
+            dest[written++] = static_cast<TUnit>(0xDC00 + (offset & 0x3FF));
+        }
+        else
+        {
+            dest[written++] = static_cast<TUnit>(codePoint);
+        }
+
+        read += seqLen;
+    }
+
+    result.Read = read;
+    result.Written = written;
+    return result;
+}
+//---------------------------------------------------------------------------
+// -UTF-16 from 2 byte units, UTF-32 from 4 byte units, to UTF-8.
+template <typename TUnit>
+TUtf::TResult UnitsToUtf8(TUnit const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid)
+{
+    TUtf::TResult result = { TUtf::EResult::Ok, 0, 0 };
+
+    if (0 == srcLen)
+        return result;
+
+    if (nullptr == src)
+    {
+        result.Err = TUtf::EResult::InvalidInput;
+        return result;
+    }
+
+    if (nullptr == dest)
+        destLen = 0;
+
+    unsigned char* out = reinterpret_cast<unsigned char*>(dest);
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < srcLen)
+    {
+        size_t const asciiRoom = srcLen - read < destLen - written ? srcLen - read : destLen - written;
+        size_t const asciiLen = NarrowAscii(src + read, asciiRoom, out + written);
+        read += asciiLen;
+        written += asciiLen;
+
+        if (read == srcLen)
+            break;
+
+        // wchar_t may be signed, so go through the unsigned type of the same width
+        uint32_t codePoint = 2 == sizeof(TUnit) ? static_cast<uint16_t>(src[read]) : static_cast<uint32_t>(src[read]);
+        size_t seqLen = 1;
+        bool valid = true;
+
+        if (2 == sizeof(TUnit))
+        {
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+            {
+                uint32_t const trail = read + 1 < srcLen ? static_cast<uint16_t>(src[read + 1]) : 0;
+
+                if (trail >= 0xDC00 && trail <= 0xDFFF)
+                {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (trail - 0xDC00);
+                    seqLen = 2;
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+            else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+            {
+                valid = false;
+            }
+        }
+        else if (codePoint > TUtf::MaxCodePoint || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            if (!replaceInvalid)
+            {
+                result.Err = TUtf::EResult::InvalidInput;
+                break;
+            }
+
+            codePoint = TUtf::ReplacementChar;
+        }
+
+        size_t const bytesNeeded = GetUtf8Len(codePoint);
+
+        if (destLen - written < bytesNeeded)
+        {
+            result.Err = TUtf::EResult::DestTooSmall;
+            break;
+        }
+
+        EncodeUtf8(codePoint, bytesNeeded, out + written);
+        written += bytesNeeded;
+        read += seqLen;
+    }
+
+    result.Read = read;
+    result.Written = written;
+    return result;
+}
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TUtf
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TUtf::TUtf()
+{
+}
+//---------------------------------------------------------------------------
+TUtf::~TUtf()
+{
+}
+//---------------------------------------------------------------------------
+// -Static
+// -Worst case UTF-8 bytes for 'wideLen' wchar_t units.
+size_t TUtf::GetMaxUtf8Len(size_t wideLen)
+{
+    return wideLen * (2 == sizeof(wchar_t) ? MaxUtf8PerUtf16 : MaxUtf8PerUtf32);
+}
+//---------------------------------------------------------------------------
+// -Static
+bool TUtf::IsValidUtf8(char const* src, size_t srcLen)
+{
+    if (0 == srcLen)
+        return true;
+
+    if (nullptr == src)
+        return false;
+
+    unsigned char const* in = reinterpret_cast<unsigned char const*>(src);
+    size_t read = 0;
+
+    while (read < srcLen)
+    {
+#if defined(ASWTOOLS_UTF_SSE2)
+        while (read + 16 <= srcLen && 0 == _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + read))))
+            read += 16;
+
+        if (read == srcLen)
+            break;
+#endif // #if defined(ASWTOOLS_UTF_SSE2)
+
+        uint32_t codePoint = 0;
+        size_t invalidLen = 0;
+        size_t const seqLen = DecodeUtf8(in + read, srcLen - read, &codePoint, &invalidLen);
+
+        if (0 == seqLen)
+            return false;
+
+        read += seqLen;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of srcLen * MaxUtf16PerUtf8 units is always enough.
+TUtf::TResult TUtf::Utf8ToUtf16(char const* src, size_t srcLen, uint16_t* dest, size_t destLen, bool replaceInvalid)
+{
+    return Utf8ToUnits(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of srcLen * MaxUtf32PerUtf8 units is always enough.
+TUtf::TResult TUtf::Utf8ToUtf32(char const* src, size_t srcLen, uint32_t* dest, size_t destLen, bool replaceInvalid)
+{
+    return Utf8ToUnits(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of srcLen units is always enough, whatever the size of wchar_t.
+TUtf::TResult TUtf::Utf8ToWide(char const* src, size_t srcLen, wchar_t* dest, size_t destLen, bool replaceInvalid)
+{
+    return Utf8ToUnits(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of srcLen * MaxUtf8PerUtf16 bytes is always enough.
+TUtf::TResult TUtf::Utf16ToUtf8(uint16_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid)
+{
+    return UnitsToUtf8(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of srcLen * MaxUtf8PerUtf32 bytes is always enough.
+TUtf::TResult TUtf::Utf32ToUtf8(uint32_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid)
+{
+    return UnitsToUtf8(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+// -Static
+// -'destLen' of GetMaxUtf8Len(srcLen) bytes is always enough.
+TUtf::TResult TUtf::WideToUtf8(wchar_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid)
+{
+    return UnitsToUtf8(src, srcLen, dest, destLen, replaceInvalid);
+}
+//---------------------------------------------------------------------------
+
+} // namespace ASWTools
@@ -0,0 +1,93 @@
+/* **************************************************************************
+ASWTools_Utf.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_UtfH
+#define ASWTools_UtfH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TUtf
+//
+// UTF-8 to and from UTF-16 and UTF-32, into caller buffers. Input is fully
+// validated: overlong forms, surrogates in UTF-8 or UTF-32, unpaired UTF-16
+// surrogates and code points past U+10FFFF are all invalid. Invalid input
+// either stops the conversion or becomes U+FFFD, one per maximal invalid
+// subpart as the Unicode standard recommends.
+//
+// Runs of ASCII are converted 16 bytes per step with SSE2 where available.
+//
+// The wide functions follow the size of wchar_t - UTF-16 where it is 2 bytes
+// (Windows), UTF-32 where it is 4.
+/////////////////////////////////////////////////////////////////////////////
+class TUtf
+{
+public: // Static const vars
+    static uint32_t const ReplacementChar = 0xFFFD;
+    static uint32_t const MaxCodePoint = 0x10FFFF;
+
+    // Worst case output lengths, in output units, for 'n' input units
+    static size_t const MaxUtf16PerUtf8 = 1; // A 4 byte sequence is 2 units, everything else 1 or fewer
+    static size_t const MaxUtf32PerUtf8 = 1;
+    static size_t const MaxUtf8PerUtf16 = 3; // A surrogate pair is 4 bytes for 2 units
+    static size_t const MaxUtf8PerUtf32 = 4;
+
+public:
+    enum class EResult
+    {
+        Ok,
+        InvalidInput, // Only when not replacing invalid input
+        DestTooSmall,
+    };
+
+    // 'Read' is in source units and 'Written' in destination units. On failure they tell how far the conversion
+    // got - 'Read' is the start of the invalid sequence, or of the first character that didn't fit.
+    struct TResult
+    {
+        EResult Err;
+        size_t Read;
+        size_t Written;
+    };
+
+private:
+    TUtf();
+    ~TUtf();
+
+public:
+    static TResult Utf8ToUtf16(char const* src, size_t srcLen, uint16_t* dest, size_t destLen, bool replaceInvalid);
+    static TResult Utf8ToUtf32(char const* src, size_t srcLen, uint32_t* dest, size_t destLen, bool replaceInvalid);
+    static TResult Utf8ToWide(char const* src, size_t srcLen, wchar_t* dest, size_t destLen, bool replaceInvalid);
+    static TResult Utf16ToUtf8(uint16_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid);
+    static TResult Utf32ToUtf8(uint32_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid);
+    static TResult WideToUtf8(wchar_t const* src, size_t srcLen, char* dest, size_t destLen, bool replaceInvalid);
+
+    static bool IsValidUtf8(char const* src, size_t srcLen);
+    static size_t GetMaxUtf8Len(size_t wideLen);
+};
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_UtfH
@@ -24,6 +24,19 @@ limitations under the License.
 // Module header
 #include "ASWTools_Adler.h"
 //---------------------------------------------------------------------------
+// SSSE3/AVX2 kernels are compiled where the compiler has the intrinsics and can target them per function
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASWTOOLS_ADLER_X86_SIMD 1
+#define ASWTOOLS_ADLER_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ASWTOOLS_ADLER_X86_SIMD 1
+#define ASWTOOLS_ADLER_TARGET(isa)
+#include <immintrin.h>
+#endif
+//---------------------------------------------------------------------------
+#include "ASWTools_Cpu.h"
+//---------------------------------------------------------------------------
 
 namespace ASWTools
 {
@@ -31,24 +44,251 @@ namespace ASWTools
 namespace Crypt
 {
 
-/////////////////////////////////////////////////////////////////////////////
-// TAdler
-/////////////////////////////////////////////////////////////////////////////
+namespace
+{
 
-uint32_t TAdler::Adler32(unsigned char const* data, size_t const dataLenInBytes)
+typedef uint32_t (*TUpdateFunc)(uint32_t adler, unsigned char const* data, size_t dataLenInBytes);
+
+// Bytes per SIMD step. NMAX rounded down to whole blocks keeps each run below the overflow limit.
+size_t const BlockSize = 32;
+size_t const BlocksPerRun = TAdler::NMAX / BlockSize;
+
+//---------------------------------------------------------------------------
+// Sums without taking the modulo per byte. 'a' and 'b' must be reduced before this and are reduced after, and
+// 'dataLenInBytes' must not be more than NMAX.
+inline void SumRun(uint32_t& a, uint32_t& b, unsigned char const* data, size_t dataLenInBytes)
 {
-    unsigned char const* dataP = data;
-    uint32_t sumA = 1; // Sum of all bytes in the stream, plus 1
-    uint32_t sumB = 0; // Sum of the individual values of sumA from each loop pass
+    // 16 at a time, so the compiler can unroll the fixed count loop
+    while (dataLenInBytes >= 16)
+    {
+        for (size_t i = 0; i < 16; i++)
+        {
+            a += data[i];
+            b += a;
+        }
+
+        data += 16;
+        dataLenInBytes -= 16;
+    }
 
-    // Process each byte of data in order
-    for (size_t i = 0; i < dataLenInBytes; i++)
+    while (dataLenInBytes--)
     {
-        sumA = (sumA + *dataP++) % MOD_ADLER;
-        sumB = (sumB + sumA) % MOD_ADLER;
+        a += *data++;
+        b += a;
     }
+}
+//---------------------------------------------------------------------------
+uint32_t UpdateScalar(uint32_t adler, unsigned char const* data, size_t dataLenInBytes)
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
 
-    return (sumB << 16) | sumA;
+    while (dataLenInBytes > 0)
+    {
+        size_t const n = dataLenInBytes < TAdler::NMAX ? dataLenInBytes : TAdler::NMAX;
+        SumRun(a, b, data, n);
+        a %= TAdler::MOD_ADLER;
+        b %= TAdler::MOD_ADLER;
+
+        data += n;
+        dataLenInBytes -= n;
+    }
+
+    return (b << 16) | a;
+}
+//---------------------------------------------------------------------------
+
+#if defined(ASWTOOLS_ADLER_X86_SIMD)
+
+//---------------------------------------------------------------------------
+// Each 32 byte block adds its byte sum to 'a', and to 'b' adds 32 * the 'a' from before the block plus each byte
+// weighted by how many of the block's bytes it precedes (32 down to 1). The 32 * 'a' part is collected in 'prevA'
+// and scaled once per run.
+ASWTOOLS_ADLER_TARGET("ssse3")
+uint32_t UpdateSSSE3(uint32_t adler, unsigned char const* data, size_t dataLenInBytes)
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    size_t blocks = dataLenInBytes / BlockSize;
+
+    __m128i const weightsLo = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    __m128i const weightsHi = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    __m128i const ones = _mm_set1_epi16(1);
+    __m128i const zero = _mm_setzero_si128();
+
+    while (blocks > 0)
+    {
+        size_t n = blocks < BlocksPerRun ? blocks : BlocksPerRun;
+        blocks -= n;
+
+        __m128i vPrevA = _mm_cvtsi32_si128(static_cast<int>(a * n));
+        __m128i vA = zero;
+        __m128i vB = _mm_cvtsi32_si128(static_cast<int>(b));
+
+        do
+        {
+            __m128i const bytesLo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+            __m128i const bytesHi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16));
+
+            vPrevA = _mm_add_epi32(vPrevA, vA);
+            vA = _mm_add_epi32(vA, _mm_sad_epu8(bytesLo, zero));
+            vA = _mm_add_epi32(vA, _mm_sad_epu8(bytesHi, zero));
+            vB = _mm_add_epi32(vB, _mm_madd_epi16(_mm_maddubs_epi16(bytesLo, weightsLo), ones));
+            vB = _mm_add_epi32(vB, _mm_madd_epi16(_mm_maddubs_epi16(bytesHi, weightsHi), ones));
+
+            data += BlockSize;
+        } while (--n);
+
+        vB = _mm_add_epi32(vB, _mm_slli_epi32(vPrevA, 5));
+
+        // Horizontal sums
+        vA = _mm_add_epi32(vA, _mm_shuffle_epi32(vA, _MM_SHUFFLE(2, 3, 0, 1)));
+        vA = _mm_add_epi32(vA, _mm_shuffle_epi32(vA, _MM_SHUFFLE(1, 0, 3, 2)));
+        vB = _mm_add_epi32(vB, _mm_shuffle_epi32(vB, _MM_SHUFFLE(2, 3, 0, 1)));
+        vB = _mm_add_epi32(vB, _mm_shuffle_epi32(vB, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        a = (a + static_cast<uint32_t>(_mm_cvtsi128_si32(vA))) % TAdler::MOD_ADLER;
+        b = static_cast<uint32_t>(_mm_cvtsi128_si32(vB)) % TAdler::MOD_ADLER;
+    }
+
+    // Fewer than 32 bytes left
+    SumRun(a, b, data, dataLenInBytes % BlockSize);
+    a %= TAdler::MOD_ADLER;
+    b %= TAdler::MOD_ADLER;
+
+    return (b << 16) | a;
+}
+//---------------------------------------------------------------------------
+// As UpdateSSSE3(), with each 32 byte block in one register.
+ASWTOOLS_ADLER_TARGET("avx2")
+uint32_t UpdateAVX2(uint32_t adler, unsigned char const* data, size_t dataLenInBytes)
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    size_t blocks = dataLenInBytes / BlockSize;
+
+    __m256i const weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    __m256i const ones = _mm256_set1_epi16(1);
+    __m256i const zero = _mm256_setzero_si256();
+
+    while (blocks > 0)
+    {
+        size_t n = blocks < BlocksPerRun ? blocks : BlocksPerRun;
+        blocks -= n;
+
+        __m256i vPrevA = _mm256_setr_epi32(static_cast<int>(a * n), 0, 0, 0, 0, 0, 0, 0);
+        __m256i vA = zero;
+        __m256i vB = _mm256_setr_epi32(static_cast<int>(b), 0, 0, 0, 0, 0, 0, 0);
+
+        do
+        {
+            __m256i const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data));
+
+            vPrevA = _mm256_add_epi32(vPrevA, vA);
+            vA = _mm256_add_epi32(vA, _mm256_sad_epu8(bytes, zero));
+            vB = _mm256_add_epi32(vB, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+
+            data += BlockSize;
+        } while (--n);
+
+        vB = _mm256_add_epi32(vB, _mm256_slli_epi32(vPrevA, 5));
+
+        // Horizontal sums: fold the halves together, then as for SSSE3
+        __m128i sumA = _mm_add_epi32(_mm256_castsi256_si128(vA), _mm256_extracti128_si256(vA, 1));
+        __m128i sumB = _mm_add_epi32(_mm256_castsi256_si128(vB), _mm256_extracti128_si256(vB, 1));
+        sumA = _mm_add_epi32(sumA, _mm_shuffle_epi32(sumA, _MM_SHUFFLE(2, 3, 0, 1)));
+        sumA = _mm_add_epi32(sumA, _mm_shuffle_epi32(sumA, _MM_SHUFFLE(1, 0, 3, 2)));
+        sumB = _mm_add_epi32(sumB, _mm_shuffle_epi32(sumB, _MM_SHUFFLE(2, 3, 0, 1)));
+        sumB = _mm_add_epi32(sumB, _mm_shuffle_epi32(sumB, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        a = (a + static_cast<uint32_t>(_mm_cvtsi128_si32(sumA))) % TAdler::MOD_ADLER;
+        b = static_cast<uint32_t>(_mm_cvtsi128_si32(sumB)) % TAdler::MOD_ADLER;
+    }
+
+    // Fewer than 32 bytes left
+    SumRun(a, b, data, dataLenInBytes % BlockSize);
+    a %= TAdler::MOD_ADLER;
+    b %= TAdler::MOD_ADLER;
+
+    return (b << 16) | a;
+}
+//---------------------------------------------------------------------------
+
+#endif // #if defined(ASWTOOLS_ADLER_X86_SIMD)
+
+//---------------------------------------------------------------------------
+TUpdateFunc GetUpdateFunc(TAdler::EKernel kernel)
+{
+    switch (kernel)
+    {
+#if defined(ASWTOOLS_ADLER_X86_SIMD)
+        case TAdler::EKernel::AVX2:
+            return UpdateAVX2;
+        case TAdler::EKernel::SSSE3:
+            return UpdateSSSE3;
+#endif
+        default:
+            return UpdateScalar;
+    }
+}
+//---------------------------------------------------------------------------
+// Detected once. Initialization of a function local static is thread safe.
+TUpdateFunc GetBestUpdateFunc()
+{
+    static TUpdateFunc const func = GetUpdateFunc(TAdler::GetKernel());
+    return func;
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TAdler::TState
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TAdler::TState::TState()
+    : m_Adler(InitialValue)
+{
+}
+//---------------------------------------------------------------------------
+// The checksum of everything passed to Update() since construction or Reset(). The state can keep being updated.
+uint32_t TAdler::TState::Final() const
+{
+    return m_Adler;
+}
+//---------------------------------------------------------------------------
+void TAdler::TState::Reset()
+{
+    m_Adler = InitialValue;
+}
+//---------------------------------------------------------------------------
+void TAdler::TState::Update(unsigned char const* data, size_t dataLenInBytes)
+{
+    m_Adler = TAdler::Update(m_Adler, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+void TAdler::TState::Update(char const* data, size_t dataLenInBytes)
+{
+    m_Adler = TAdler::Update(m_Adler, reinterpret_cast<unsigned char const*>(data), dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+void TAdler::TState::Update(std::string const& data)
+{
+    m_Adler = TAdler::Update(m_Adler, reinterpret_cast<unsigned char const*>(data.c_str()), data.length());
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TAdler
+/////////////////////////////////////////////////////////////////////////////
+
+uint32_t TAdler::Adler32(unsigned char const* data, size_t const dataLenInBytes)
+{
+    return GetBestUpdateFunc()(InitialValue, data, dataLenInBytes);
 }
 //---------------------------------------------------------------------------
 uint32_t TAdler::Adler32(char const* data, size_t const dataLenInBytes)
@@ -61,6 +301,66 @@ uint32_t TAdler::Adler32(std::string const& data)
     return Adler32(reinterpret_cast<unsigned char const*>(data.c_str()), data.length());
 }
 //---------------------------------------------------------------------------
+// The checksum of two pieces of data joined together, from the checksum of each and the length of the second.
+uint32_t TAdler::Adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t len2)
+{
+    uint32_t const rem = static_cast<uint32_t>(len2 % MOD_ADLER);
+    uint32_t const a1 = adler1 & 0xFFFF;
+    uint32_t const b1 = adler1 >> 16;
+    uint32_t const a2 = adler2 & 0xFFFF;
+    uint32_t const b2 = adler2 >> 16;
+
+    // Every byte of the second piece also counted the first piece's sumA (less the initial 1) into sumB
+    uint32_t a = a1 + a2 + MOD_ADLER - 1;
+    uint32_t b = static_cast<uint32_t>((static_cast<uint64_t>(rem) * a1) % MOD_ADLER) + b1 + b2 + MOD_ADLER - rem;
+
+    a %= MOD_ADLER;
+    b %= MOD_ADLER;
+
+    return (b << 16) | a;
+}
+//---------------------------------------------------------------------------
+// The kernel used by Adler32() and Update() on this CPU.
+TAdler::EKernel TAdler::GetKernel()
+{
+    static EKernel const kernel =
+        IsKernelSupported(EKernel::AVX2) ? EKernel::AVX2 :
+        IsKernelSupported(EKernel::SSSE3) ? EKernel::SSSE3 : EKernel::Scalar;
+    return kernel;
+}
+//---------------------------------------------------------------------------
+// True if 'kernel' was compiled in and this CPU can run it.
+bool TAdler::IsKernelSupported(EKernel kernel)
+{
+    if (EKernel::Scalar == kernel)
+        return true;
+
+#if defined(ASWTOOLS_ADLER_X86_SIMD)
+    if (EKernel::AVX2 == kernel)
+        return TCpu::HasAVX2();
+    if (EKernel::SSSE3 == kernel)
+        return TCpu::HasSSSE3();
+    return false;
+#else
+    return false;
+#endif
+}
+//---------------------------------------------------------------------------
+// Continues 'adler' (InitialValue to start) with more data.
+uint32_t TAdler::Update(uint32_t adler, unsigned char const* data, size_t dataLenInBytes)
+{
+    return GetBestUpdateFunc()(adler, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+// As above, with a specific kernel, for comparing kernels. Falls back to Scalar if 'kernel' isn't supported.
+uint32_t TAdler::Update(uint32_t adler, unsigned char const* data, size_t dataLenInBytes, EKernel kernel)
+{
+    if (!IsKernelSupported(kernel))
+        kernel = EKernel::Scalar;
+
+    return GetUpdateFunc(kernel)(adler, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
 
 } // namespace Crypt
 
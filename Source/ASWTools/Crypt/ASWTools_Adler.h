@@ -23,6 +23,7 @@ limitations under the License.
 #ifndef ASWTools_AdlerH
 #define ASWTools_AdlerH
 //---------------------------------------------------------------------------
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 //---------------------------------------------------------------------------
@@ -35,11 +36,45 @@ namespace Crypt
 
 /////////////////////////////////////////////////////////////////////////////
 // TAdler
+//
+// The modulo is only taken once every NMAX bytes, and the bytes in between
+// are summed 32 at a time with SSSE3 or AVX2 when the CPU has them (picked
+// once, at first use). Results are the same whichever kernel runs.
+//
+// Data can be checksummed in pieces with TState, or with Update() starting
+// from InitialValue. Pieces checksummed separately (such as on different
+// threads) can be joined with Adler32Combine().
 /////////////////////////////////////////////////////////////////////////////
 class TAdler
 {
 public: // Static const vars
     static uint32_t const MOD_ADLER = 65521;
+    static size_t const NMAX = 5552; // Most bytes that can be summed before sumB could overflow 32 bits
+    static uint32_t const InitialValue = 1; // Adler-32 of no data
+
+public:
+    enum class EKernel
+    {
+        Scalar,
+        SSSE3,
+        AVX2,
+    };
+
+    // Incremental checksum: Update() with each piece in order, then Final()
+    class TState
+    {
+    private:
+        uint32_t m_Adler;
+
+    public:
+        TState();
+
+        uint32_t Final() const;
+        void Reset();
+        void Update(unsigned char const* data, size_t dataLenInBytes);
+        void Update(char const* data, size_t dataLenInBytes);
+        void Update(std::string const& data);
+    };
 
 private:
     TAdler();
@@ -49,6 +84,11 @@ public:
     static uint32_t Adler32(unsigned char const* data, size_t const dataLenInBytes);
     static uint32_t Adler32(char const* data, size_t const dataLenInBytes);
     static uint32_t Adler32(std::string const& data);
+    static uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t len2);
+    static EKernel GetKernel();
+    static bool IsKernelSupported(EKernel kernel);
+    static uint32_t Update(uint32_t adler, unsigned char const* data, size_t dataLenInBytes);
+    static uint32_t Update(uint32_t adler, unsigned char const* data, size_t dataLenInBytes, EKernel kernel);
 };
 
 } // namespace Crypt
@@ -0,0 +1,374 @@
+/* **************************************************************************
+ASWTools_Crc32c.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+See header for notes
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_Crc32c.h"
+//---------------------------------------------------------------------------
+#include <cstring>
+//---------------------------------------------------------------------------
+// The SSE4.2 kernel is compiled where the compiler has the intrinsics and can target them per function
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASWTOOLS_CRC32C_X86_SIMD 1
+#define ASWTOOLS_CRC32C_TARGET(isa) __attribute__((target(isa)))
+#include <nmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ASWTOOLS_CRC32C_X86_SIMD 1
+#define ASWTOOLS_CRC32C_TARGET(isa)
+#include <nmmintrin.h>
+#endif
+//---------------------------------------------------------------------------
+#include "ASWTools_Cpu.h"
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+namespace Crypt
+{
+
+namespace
+{
+
+typedef uint32_t (*TUpdateFunc)(uint32_t crc, unsigned char const* data, size_t dataLenInBytes);
+
+//---------------------------------------------------------------------------
+// Slicing-by-8: Table[0] is the classic byte table, Table[k] advances a byte k more positions
+struct TSliceTables
+{
+    uint32_t Table[8][256];
+
+    TSliceTables()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 1) ? (crc >> 1) ^ TCrc32c::Polynomial : crc >> 1;
+            Table[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (int k = 1; k < 8; k++)
+                Table[k][i] = (Table[k - 1][i] >> 8) ^ Table[0][Table[k - 1][i] & 0xFF];
+        }
+    }
+};
+//---------------------------------------------------------------------------
+// Built at first use. Initialization of a function local static is thread safe.
+TSliceTables const& GetSliceTables()
+{
+    static TSliceTables const tables;
+    return tables;
+}
+//---------------------------------------------------------------------------
+// Little endian load; x86 and ARM Windows both are
+inline uint32_t Load32(unsigned char const* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+//---------------------------------------------------------------------------
+// Works on the CRC register (inverted), not the finished CRC.
+uint32_t UpdateScalar(uint32_t crc, unsigned char const* data, size_t dataLenInBytes)
+{
+    TSliceTables const& tables = GetSliceTables();
+    uint32_t const (*t)[256] = tables.Table;
+
+    crc = ~crc;
+
+    while (dataLenInBytes >= 8)
+    {
+        uint32_t const lo = Load32(data) ^ crc;
+        uint32_t const hi = Load32(data + 4);
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+        data += 8;
+        dataLenInBytes -= 8;
+    }
+
+    while (dataLenInBytes--)
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+
+    return ~crc;
+}
+//---------------------------------------------------------------------------
+// a * b modulo the polynomial, for polynomials stored bit reversed (x^0 in bit 31)
+uint32_t MultModP(uint32_t a, uint32_t b)
+{
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if (0 == (a & (m - 1)))
+                break;
+        }
+
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ TCrc32c::Polynomial : b >> 1;
+    }
+
+    return p;
+}
+//---------------------------------------------------------------------------
+// x^(8 * numBytes) modulo the polynomial: what appending 'numBytes' zero bytes multiplies a CRC register by.
+uint32_t ShiftForBytes(uint64_t numBytes)
+{
+    // x^(2^k) for k = 3 (one byte) upwards, squared each step
+    uint32_t power = 1u << 23; // x^8
+    uint32_t result = 1u << 31; // x^0
+
+    while (numBytes)
+    {
+        if (numBytes & 1)
+            result = MultModP(power, result);
+
+        power = MultModP(power, power);
+        numBytes >>= 1;
+    }
+
+    return result;
+}
+//---------------------------------------------------------------------------
+
+#if defined(ASWTOOLS_CRC32C_X86_SIMD)
+
+// Bytes per stream when running three at once. Long enough that joining the streams costs little.
+size_t const StreamBytes = 8192;
+
+//---------------------------------------------------------------------------
+ASWTOOLS_CRC32C_TARGET("sse4.2")
+inline uint32_t CrcWords(uint32_t crc, unsigned char const* data, size_t numWords)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    for (size_t i = 0; i < numWords; i++)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i * 8, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    return static_cast<uint32_t>(crc64);
+#else
+    for (size_t i = 0; i < numWords * 2; i++)
+        crc = _mm_crc32_u32(crc, Load32(data + i * 4));
+    return crc;
+#endif
+}
+//---------------------------------------------------------------------------
+// The crc32 instruction has a latency of three cycles but can start one every cycle, so long runs are split into
+// three streams advanced together. The second and third start from zero, and are joined on afterwards by
+// shifting the earlier streams past them.
+ASWTOOLS_CRC32C_TARGET("sse4.2")
+uint32_t UpdateSSE42(uint32_t crc, unsigned char const* data, size_t dataLenInBytes)
+{
+    crc = ~crc;
+
+    if (dataLenInBytes >= StreamBytes * 3)
+    {
+        static uint32_t const shift1 = ShiftForBytes(StreamBytes);
+        static uint32_t const shift2 = ShiftForBytes(StreamBytes * 2);
+
+        while (dataLenInBytes >= StreamBytes * 3)
+        {
+            uint64_t crc0 = crc;
+            uint64_t crc1 = 0;
+            uint64_t crc2 = 0;
+            unsigned char const* data1 = data + StreamBytes;
+            unsigned char const* data2 = data + StreamBytes * 2;
+
+            for (size_t i = 0; i < StreamBytes; i += 8)
+            {
+#if defined(__x86_64__) || defined(_M_X64)
+                uint64_t w0;
+                uint64_t w1;
+                uint64_t w2;
+                std::memcpy(&w0, data + i, 8);
+                std::memcpy(&w1, data1 + i, 8);
+                std::memcpy(&w2, data2 + i, 8);
+                crc0 = _mm_crc32_u64(crc0, w0);
+                crc1 = _mm_crc32_u64(crc1, w1);
+                crc2 = _mm_crc32_u64(crc2, w2);
+#else
+                crc0 = _mm_crc32_u32(_mm_crc32_u32(static_cast<uint32_t>(crc0), Load32(data + i)),
+                    Load32(data + i + 4));
+                crc1 = _mm_crc32_u32(_mm_crc32_u32(static_cast<uint32_t>(crc1), Load32(data1 + i)),
+                    Load32(data1 + i + 4));
+                crc2 = _mm_crc32_u32(_mm_crc32_u32(static_cast<uint32_t>(crc2), Load32(data2 + i)),
+                    Load32(data2 + i + 4));
+#endif
+            }
+
+            crc = MultModP(shift2, static_cast<uint32_t>(crc0)) ^ MultModP(shift1, static_cast<uint32_t>(crc1)) ^
+                static_cast<uint32_t>(crc2);
+
+            data += StreamBytes * 3;
+            dataLenInBytes -= StreamBytes * 3;
+        }
+    }
+
+    size_t const numWords = dataLenInBytes / 8;
+    crc = CrcWords(crc, data, numWords);
+    data += numWords * 8;
+    dataLenInBytes -= numWords * 8;
+
+    while (dataLenInBytes--)
+        crc = _mm_crc32_u8(crc, *data++);
+
+    return ~crc;
+}
+//---------------------------------------------------------------------------
+
+#endif // #if defined(ASWTOOLS_CRC32C_X86_SIMD)
+
+//---------------------------------------------------------------------------
+TUpdateFunc GetUpdateFunc(TCrc32c::EKernel kernel)
+{
+#if defined(ASWTOOLS_CRC32C_X86_SIMD)
+    if (TCrc32c::EKernel::SSE42 == kernel)
+        return UpdateSSE42;
+#endif
+
+    return UpdateScalar;
+}
+//---------------------------------------------------------------------------
+// Detected once. Initialization of a function local static is thread safe.
+TUpdateFunc GetBestUpdateFunc()
+{
+    static TUpdateFunc const func = GetUpdateFunc(TCrc32c::GetKernel());
+    return func;
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TCrc32c::TState
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TCrc32c::TState::TState()
+    : m_Crc(InitialValue)
+{
+}
+//---------------------------------------------------------------------------
+// The CRC of everything passed to Update() since construction or Reset(). The state can keep being updated.
+uint32_t TCrc32c::TState::Final() const
+{
+    return m_Crc;
+}
+//---------------------------------------------------------------------------
+void TCrc32c::TState::Reset()
+{
+    m_Crc = InitialValue;
+}
+//---------------------------------------------------------------------------
+void TCrc32c::TState::Update(unsigned char const* data, size_t dataLenInBytes)
+{
+    m_Crc = TCrc32c::Update(m_Crc, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+void TCrc32c::TState::Update(char const* data, size_t dataLenInBytes)
+{
+    m_Crc = TCrc32c::Update(m_Crc, reinterpret_cast<unsigned char const*>(data), dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+void TCrc32c::TState::Update(std::string const& data)
+{
+    m_Crc = TCrc32c::Update(m_Crc, reinterpret_cast<unsigned char const*>(data.c_str()), data.length());
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TCrc32c
+/////////////////////////////////////////////////////////////////////////////
+
+uint32_t TCrc32c::Crc32c(unsigned char const* data, size_t const dataLenInBytes)
+{
+    return GetBestUpdateFunc()(InitialValue, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+uint32_t TCrc32c::Crc32c(char const* data, size_t const dataLenInBytes)
+{
+    return Crc32c(reinterpret_cast<unsigned char const*>(data), dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+uint32_t TCrc32c::Crc32c(std::string const& data)
+{
+    return Crc32c(reinterpret_cast<unsigned char const*>(data.c_str()), data.length());
+}
+//---------------------------------------------------------------------------
+// The CRC of two pieces of data joined together, from the CRC of each and the length of the second.
+uint32_t TCrc32c::Crc32cCombine(uint32_t crc1, uint32_t crc2, uint64_t len2)
+{
+    return MultModP(ShiftForBytes(len2), crc1) ^ crc2;
+}
+//---------------------------------------------------------------------------
+// The kernel used by Crc32c() and Update() on this CPU.
+TCrc32c::EKernel TCrc32c::GetKernel()
+{
+    static EKernel const kernel = IsKernelSupported(EKernel::SSE42) ? EKernel::SSE42 : EKernel::Scalar;
+    return kernel;
+}
+//---------------------------------------------------------------------------
+// True if 'kernel' was compiled in and this CPU can run it.
+bool TCrc32c::IsKernelSupported(EKernel kernel)
+{
+    if (EKernel::Scalar == kernel)
+        return true;
+
+#if defined(ASWTOOLS_CRC32C_X86_SIMD)
+    return TCpu::HasSSE42();
+#else
+    return false;
+#endif
+}
+//---------------------------------------------------------------------------
+// Continues 'crc' (InitialValue to start) with more data.
+uint32_t TCrc32c::Update(uint32_t crc, unsigned char const* data, size_t dataLenInBytes)
+{
+    return GetBestUpdateFunc()(crc, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+// As above, with a specific kernel, for comparing kernels. Falls back to Scalar if 'kernel' isn't supported.
+uint32_t TCrc32c::Update(uint32_t crc, unsigned char const* data, size_t dataLenInBytes, EKernel kernel)
+{
+    if (!IsKernelSupported(kernel))
+        kernel = EKernel::Scalar;
+
+    return GetUpdateFunc(kernel)(crc, data, dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+
+} // namespace Crypt
+
+} // namespace ASWTools
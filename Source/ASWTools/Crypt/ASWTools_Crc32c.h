@@ -0,0 +1,99 @@
+/* **************************************************************************
+ASWTools_Crc32c.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+See: https://en.wikipedia.org/wiki/Cyclic_redundancy_check (CRC-32C, Castagnoli)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_Crc32cH
+#define ASWTools_Crc32cH
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+namespace Crypt
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TCrc32c
+//
+// CRC-32C (Castagnoli, as used by iSCSI, ext4 and SSE4.2). Catches every
+// burst error up to 32 bits, which Adler-32 can't promise for short inputs.
+//
+// Uses the SSE4.2 crc32 instruction, on three streams at once to hide its
+// latency, when the CPU has it (picked once, at first use). Otherwise
+// slicing-by-8 tables. Results are the same whichever kernel runs.
+//
+// Same shape as TAdler: one-shot Crc32c(), TState or Update() from
+// InitialValue for data in pieces, and Crc32cCombine() to join pieces.
+/////////////////////////////////////////////////////////////////////////////
+class TCrc32c
+{
+public: // Static const vars
+    static uint32_t const Polynomial = 0x82F63B78; // Reversed (bit 0 first)
+    static uint32_t const InitialValue = 0; // CRC-32C of no data
+
+public:
+    enum class EKernel
+    {
+        Scalar, // Slicing-by-8
+        SSE42,
+    };
+
+    // Incremental checksum: Update() with each piece in order, then Final()
+    class TState
+    {
+    private:
+        uint32_t m_Crc;
+
+    public:
+        TState();
+
+        uint32_t Final() const;
+        void Reset();
+        void Update(unsigned char const* data, size_t dataLenInBytes);
+        void Update(char const* data, size_t dataLenInBytes);
+        void Update(std::string const& data);
+    };
+
+private:
+    TCrc32c();
+    ~TCrc32c();
+
+public:
+    static uint32_t Crc32c(unsigned char const* data, size_t const dataLenInBytes);
+    static uint32_t Crc32c(char const* data, size_t const dataLenInBytes);
+    static uint32_t Crc32c(std::string const& data);
+    static uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, uint64_t len2);
+    static EKernel GetKernel();
+    static bool IsKernelSupported(EKernel kernel);
+    static uint32_t Update(uint32_t crc, unsigned char const* data, size_t dataLenInBytes);
+    static uint32_t Update(uint32_t crc, unsigned char const* data, size_t dataLenInBytes, EKernel kernel);
+};
+
+} // namespace Crypt
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_Crc32cH
@@ -0,0 +1,261 @@
+/* **************************************************************************
+ASWTools_XXHash64.cpp
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+See header for notes
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+//---------------------------------------------------------------------------
+// Module header
+#include "ASWTools_XXHash64.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+namespace Crypt
+{
+
+namespace
+{
+
+uint64_t const Prime1 = 0x9E3779B185EBCA87ULL;
+uint64_t const Prime2 = 0xC2B2AE3D27D4EB4FULL;
+uint64_t const Prime3 = 0x165667B19E3779F9ULL;
+uint64_t const Prime4 = 0x85EBCA77C2B2AE63ULL;
+uint64_t const Prime5 = 0x27D4EB2F165667C5ULL;
+
+//---------------------------------------------------------------------------
+inline uint64_t RotL(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+//---------------------------------------------------------------------------
+// Little endian loads; x86 and ARM Windows both are
+inline uint64_t Load64(unsigned char const* data)
+{
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+//---------------------------------------------------------------------------
+inline uint32_t Load32(unsigned char const* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+//---------------------------------------------------------------------------
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+    acc += input * Prime2;
+    acc = RotL(acc, 31);
+    return acc * Prime1;
+}
+//---------------------------------------------------------------------------
+inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+{
+    acc ^= Round(0, value);
+    return acc * Prime1 + Prime4;
+}
+//---------------------------------------------------------------------------
+void InitAccumulators(uint64_t acc[4], uint64_t seed)
+{
+    acc[0] = seed + Prime1 + Prime2;
+    acc[1] = seed + Prime2;
+    acc[2] = seed;
+    acc[3] = seed - Prime1;
+}
+//---------------------------------------------------------------------------
+// Runs whole stripes through the four accumulators. Returns the bytes consumed.
+size_t ConsumeStripes(uint64_t acc[4], unsigned char const* data, size_t dataLenInBytes)
+{
+    uint64_t a0 = acc[0];
+    uint64_t a1 = acc[1];
+    uint64_t a2 = acc[2];
+    uint64_t a3 = acc[3];
+    size_t const numBytes = dataLenInBytes - dataLenInBytes % TXXHash64::StripeSize;
+
+    for (size_t i = 0; i < numBytes; i += TXXHash64::StripeSize)
+    {
+        a0 = Round(a0, Load64(data + i));
+        a1 = Round(a1, Load64(data + i + 8));
+        a2 = Round(a2, Load64(data + i + 16));
+        a3 = Round(a3, Load64(data + i + 24));
+    }
+
+    acc[0] = a0;
+    acc[1] = a1;
+    acc[2] = a2;
+    acc[3] = a3;
+    return numBytes;
+}
+//---------------------------------------------------------------------------
+// Mixes in the last (less than a stripe) bytes and the length, then avalanches.
+uint64_t Finish(uint64_t const acc[4], uint64_t seed, uint64_t totalLen, unsigned char const* tail, size_t tailLen)
+{
+    uint64_t h;
+
+    if (totalLen >= TXXHash64::StripeSize)
+    {
+        h = RotL(acc[0], 1) + RotL(acc[1], 7) + RotL(acc[2], 12) + RotL(acc[3], 18);
+        h = MergeRound(h, acc[0]);
+        h = MergeRound(h, acc[1]);
+        h = MergeRound(h, acc[2]);
+        h = MergeRound(h, acc[3]);
+    }
+    else
+    {
+        h = seed + Prime5;
+    }
+
+    h += totalLen;
+
+    while (tailLen >= 8)
+    {
+        h ^= Round(0, Load64(tail));
+        h = RotL(h, 27) * Prime1 + Prime4;
+        tail += 8;
+        tailLen -= 8;
+    }
+
+    if (tailLen >= 4)
+    {
+        h ^= static_cast<uint64_t>(Load32(tail)) * Prime1;
+        h = RotL(h, 23) * Prime2 + Prime3;
+        tail += 4;
+        tailLen -= 4;
+    }
+
+    while (tailLen--)
+    {
+        h ^= *tail++ * Prime5;
+        h = RotL(h, 11) * Prime1;
+    }
+
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+    return h;
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TXXHash64::TState
+/////////////////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------------------------
+TXXHash64::TState::TState(uint64_t seed)
+{
+    Reset(seed);
+}
+//---------------------------------------------------------------------------
+// The hash of everything passed to Update() since construction or Reset(). The state can keep being updated.
+uint64_t TXXHash64::TState::Final() const
+{
+    return Finish(m_Acc, m_Seed, m_TotalLen, m_Buffer, m_BufferLen);
+}
+//---------------------------------------------------------------------------
+// Starts again with the same seed.
+void TXXHash64::TState::Reset()
+{
+    Reset(m_Seed);
+}
+//---------------------------------------------------------------------------
+void TXXHash64::TState::Reset(uint64_t seed)
+{
+    m_Seed = seed;
+    InitAccumulators(m_Acc, seed);
+    m_TotalLen = 0;
+    m_BufferLen = 0;
+}
+//---------------------------------------------------------------------------
+void TXXHash64::TState::Update(unsigned char const* data, size_t dataLenInBytes)
+{
+    m_TotalLen += dataLenInBytes;
+
+    // Top up a partial stripe from last time first
+    if (m_BufferLen > 0)
+    {
+        size_t const take = std::min(StripeSize - m_BufferLen, dataLenInBytes);
+        std::memcpy(m_Buffer + m_BufferLen, data, take);
+        m_BufferLen += take;
+        data += take;
+        dataLenInBytes -= take;
+
+        if (m_BufferLen < StripeSize)
+            return;
+
+        ConsumeStripes(m_Acc, m_Buffer, StripeSize);
+        m_BufferLen = 0;
+    }
+
+    size_t const consumed = ConsumeStripes(m_Acc, data, dataLenInBytes);
+
+    m_BufferLen = dataLenInBytes - consumed;
+    if (m_BufferLen > 0)
+        std::memcpy(m_Buffer, data + consumed, m_BufferLen);
+}
+//---------------------------------------------------------------------------
+void TXXHash64::TState::Update(char const* data, size_t dataLenInBytes)
+{
+    Update(reinterpret_cast<unsigned char const*>(data), dataLenInBytes);
+}
+//---------------------------------------------------------------------------
+void TXXHash64::TState::Update(std::string const& data)
+{
+    Update(reinterpret_cast<unsigned char const*>(data.c_str()), data.length());
+}
+//---------------------------------------------------------------------------
+
+
+/////////////////////////////////////////////////////////////////////////////
+// TXXHash64
+/////////////////////////////////////////////////////////////////////////////
+
+uint64_t TXXHash64::Hash64(unsigned char const* data, size_t const dataLenInBytes, uint64_t seed)
+{
+    uint64_t acc[4];
+    InitAccumulators(acc, seed);
+
+    size_t const consumed = ConsumeStripes(acc, data, dataLenInBytes);
+    return Finish(acc, seed, dataLenInBytes, data + consumed, dataLenInBytes - consumed);
+}
+//---------------------------------------------------------------------------
+uint64_t TXXHash64::Hash64(char const* data, size_t const dataLenInBytes, uint64_t seed)
+{
+    return Hash64(reinterpret_cast<unsigned char const*>(data), dataLenInBytes, seed);
+}
+//---------------------------------------------------------------------------
+uint64_t TXXHash64::Hash64(std::string const& data, uint64_t seed)
+{
+    return Hash64(reinterpret_cast<unsigned char const*>(data.c_str()), data.length(), seed);
+}
+//---------------------------------------------------------------------------
+
+} // namespace Crypt
+
+} // namespace ASWTools
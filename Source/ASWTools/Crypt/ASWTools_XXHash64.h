@@ -0,0 +1,89 @@
+/* **************************************************************************
+ASWTools_XXHash64.h
+Author: Anthony S. West - ASW Software
+
+Copyright 2025 Anthony S. West
+
+See: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************** */
+
+#ifndef ASWTools_XXHash64H
+#define ASWTools_XXHash64H
+//---------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+//---------------------------------------------------------------------------
+
+namespace ASWTools
+{
+
+namespace Crypt
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// TXXHash64
+//
+// XXH64: fast 64 bit non-cryptographic hash with good distribution, for
+// cache keys and integrity checks where a collision only costs a redo. Not
+// for anything that has to stand up to deliberate tampering. Output matches
+// the reference implementation for the same seed.
+//
+// Same shape as TAdler: one-shot Hash64(), or TState for data in pieces.
+/////////////////////////////////////////////////////////////////////////////
+class TXXHash64
+{
+public: // Static const vars
+    static size_t const StripeSize = 32; // Bytes consumed per step
+
+public:
+    // Incremental hash: Update() with each piece in order, then Final()
+    class TState
+    {
+    private:
+        uint64_t m_Seed;
+        uint64_t m_Acc[4];
+        uint64_t m_TotalLen;
+        unsigned char m_Buffer[StripeSize]; // Partial stripe carried between Update() calls
+        size_t m_BufferLen;
+
+    public:
+        explicit TState(uint64_t seed = 0);
+
+        uint64_t Final() const;
+        void Reset();
+        void Reset(uint64_t seed);
+        void Update(unsigned char const* data, size_t dataLenInBytes);
+        void Update(char const* data, size_t dataLenInBytes);
+        void Update(std::string const& data);
+    };
+
+private:
+    TXXHash64();
+    ~TXXHash64();
+
+public:
+    static uint64_t Hash64(unsigned char const* data, size_t const dataLenInBytes, uint64_t seed = 0);
+    static uint64_t Hash64(char const* data, size_t const dataLenInBytes, uint64_t seed = 0);
+    static uint64_t Hash64(std::string const& data, uint64_t seed = 0);
+};
+
+} // namespace Crypt
+
+} // namespace ASWTools
+
+//---------------------------------------------------------------------------
+#endif // #ifndef ASWTools_XXHash64H
@@ -31,31 +31,203 @@ using namespace ASWTools::BasicINI;
 namespace SweepThemMines
 {
 
+namespace
+{
+
+char const DefaultDirLogs[] = "%localAppData%\\ASWSoftware\\SweepThemMines\\Logs\\";
+char const DefaultLogPrefix[] = "GeneralSTM_";
+
+enum class ESettingType
+{
+    String,
+    Bool,
+    UInt
+};
+
+// Setting flags
+unsigned int const SF_None = 0;
+unsigned int const SF_Hidden = 1; // Saved only if it was in the file, and not missed if it isn't
+unsigned int const SF_NotEmpty = 2; // An empty value is invalid - the default is kept
+
+// One setting of the [General] section. Only the member for 'Type' is set.
+struct TSettingDesc
+{
+    char const* Name;
+    ESettingType Type;
+    char const* DefaultStr;
+    DWORD DefaultNum;
+    unsigned int Flags;
+    char const* Comment; // Written on the line before the key, or nullptr
+    std::string TAppSettings::*StrMember;
+    bool TAppSettings::*BoolMember;
+    DWORD TAppSettings::*UIntMember;
+};
+
+//---------------------------------------------------------------------------
+constexpr TSettingDesc StrSetting(char const* name, char const* defaultVal, unsigned int flags,
+    std::string TAppSettings::*member, char const* comment = nullptr)
+{
+    return TSettingDesc{ name, ESettingType::String, defaultVal, 0, flags, comment, member, nullptr, nullptr };
+}
+//---------------------------------------------------------------------------
+constexpr TSettingDesc BoolSetting(char const* name, bool defaultVal, unsigned int flags,
+    bool TAppSettings::*member, char const* comment = nullptr)
+{
+    return TSettingDesc{ name, ESettingType::Bool, "", defaultVal ? 1u : 0u, flags, comment, nullptr, member, nullptr };
+}
+//---------------------------------------------------------------------------
+constexpr TSettingDesc UIntSetting(char const* name, DWORD defaultVal, unsigned int flags,
+    DWORD TAppSettings::*member, char const* comment = nullptr)
+{
+    return TSettingDesc{ name, ESettingType::UInt, "", defaultVal, flags, comment, nullptr, nullptr, member };
+}
+//---------------------------------------------------------------------------
+
+// The [General] settings, in the order they are written to a new file
+constexpr TSettingDesc SettingDescs[] =
+{
+    StrSetting("ImagesPath", "", SF_None, &TAppSettings::Gen_ImagesPath,
+        ";Leave blank for default (exe directory)."),
+    BoolSetting("EnableCheats", false, SF_Hidden, &TAppSettings::Gen_EnableCheats),
+    BoolSetting("UseQuestionMarksInit", true, SF_None, &TAppSettings::Gen_UseQuestionMarksInit),
+    StrSetting("DirLogs", DefaultDirLogs, SF_NotEmpty, &TAppSettings::Gen_DirLogs),
+    StrSetting("LogPrefix", DefaultLogPrefix, SF_NotEmpty, &TAppSettings::Gen_LogPrefix),
+    UIntSetting("LogLevel", 0, SF_None, &TAppSettings::Gen_LogLevel,
+        ";Valid range for LogLevel: 0-4. 0=System/forced logs only, 1=errors/warnings, 2=medium, 3=heavy, "
+        "4=debug/verbose"),
+    UIntSetting("NDaysRetainLogs", 30, SF_None, &TAppSettings::Gen_NDaysRetainLogs,
+        ";Valid value for NDaysRetainLogs: 0 to N days. 0=retain forever."),
+};
+
+size_t const SettingCount = sizeof(SettingDescs) / sizeof(SettingDescs[0]);
+size_t const SettingNotFound = static_cast<size_t>(-1);
+
+static_assert(SettingCount <= 32, "TAppSettings::m_SettingsInFile has a bit per setting");
+
+// Perfect hash of the key names, case-insensitive. The seed is searched for at compile time - adding a setting that
+// none of the first MaxSeedTries seeds can place fails the static_assert below, and wants more slots.
+unsigned int const SlotBits = 4;
+size_t const SlotCount = static_cast<size_t>(1) << SlotBits;
+unsigned char const NoSetting = 0xFF;
+uint32_t const MaxSeedTries = 256;
+
+static_assert(SettingCount * 2 <= SlotCount, "Too few hash slots for the settings");
+
+//---------------------------------------------------------------------------
+constexpr uint32_t FoldChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint32_t>(c - 'A' + 'a')
+        : static_cast<uint32_t>(static_cast<unsigned char>(c));
+}
+//---------------------------------------------------------------------------
+// FNV-1a over the ASCII case-folded name. Used both at compile time and on each key read.
+constexpr uint32_t HashName(char const* first, char const* last, uint32_t hash)
+{
+    return first == last ? hash : HashName(first + 1, last, (hash ^ FoldChar(*first)) * 16777619u);
+}
+//---------------------------------------------------------------------------
+constexpr char const* NameEnd(char const* name)
+{
+    return '\0' == *name ? name : NameEnd(name + 1);
+}
+//---------------------------------------------------------------------------
+constexpr uint32_t SeedBasis(uint32_t seed)
+{
+    return 2166136261u ^ (seed * 0x9E3779B9u);
+}
+//---------------------------------------------------------------------------
+// The top bits - FNV's low bits only depend on the low bits of each char
+constexpr size_t SlotOf(uint32_t hash)
+{
+    return static_cast<size_t>(hash >> (32 - SlotBits));
+}
+//---------------------------------------------------------------------------
+constexpr size_t SettingSlot(size_t settingIdx, uint32_t seed)
+{
+    return SlotOf(HashName(SettingDescs[settingIdx].Name, NameEnd(SettingDescs[settingIdx].Name), SeedBasis(seed)));
+}
+//---------------------------------------------------------------------------
+// -True if no two settings from 'i' on share a slot, starting with the pair 'i', 'j'.
+constexpr bool IsPerfectSeed(uint32_t seed, size_t i, size_t j)
+{
+    return i >= SettingCount ? true
+        : j >= SettingCount ? IsPerfectSeed(seed, i + 1, i + 2)
+        : SettingSlot(i, seed) != SettingSlot(j, seed) && IsPerfectSeed(seed, i, j + 1);
+}
+//---------------------------------------------------------------------------
+constexpr uint32_t FindPerfectSeed(uint32_t seed, uint32_t triesLeft)
+{
+    return (0 == triesLeft || IsPerfectSeed(seed, 0, 1)) ? seed : FindPerfectSeed(seed + 1, triesLeft - 1);
+}
+//---------------------------------------------------------------------------
+
+constexpr uint32_t HashSeed = FindPerfectSeed(0, MaxSeedTries);
+static_assert(IsPerfectSeed(HashSeed, 0, 1), "No perfect hash seed for the settings - raise SlotBits");
+
+//---------------------------------------------------------------------------
+constexpr unsigned char SettingForSlot(size_t slot, size_t settingIdx)
+{
+    return settingIdx >= SettingCount ? NoSetting
+        : SettingSlot(settingIdx, HashSeed) == slot ? static_cast<unsigned char>(settingIdx)
+        : SettingForSlot(slot, settingIdx + 1);
+}
+//---------------------------------------------------------------------------
+
+constexpr unsigned char SlotSettings[] =
+{
+    SettingForSlot(0, 0), SettingForSlot(1, 0), SettingForSlot(2, 0), SettingForSlot(3, 0),
+    SettingForSlot(4, 0), SettingForSlot(5, 0), SettingForSlot(6, 0), SettingForSlot(7, 0),
+    SettingForSlot(8, 0), SettingForSlot(9, 0), SettingForSlot(10, 0), SettingForSlot(11, 0),
+    SettingForSlot(12, 0), SettingForSlot(13, 0), SettingForSlot(14, 0), SettingForSlot(15, 0),
+};
+
+static_assert(sizeof(SlotSettings) == SlotCount, "SlotSettings needs one entry per slot");
+
+//---------------------------------------------------------------------------
+// -Returns the index in SettingDescs of the setting named 'key', ignoring case, or SettingNotFound.
+size_t FindSetting(TStrView key)
+{
+    size_t const settingIdx = SlotSettings[SlotOf(HashName(key.begin(), key.end(), SeedBasis(HashSeed)))];
+
+    if (NoSetting == settingIdx || !TStrTool::EqualsIC(SettingDescs[settingIdx].Name, key))
+        return SettingNotFound;
+
+    return settingIdx;
+}
+//---------------------------------------------------------------------------
+// -One pass over the section. 'keyIdx' gets, per setting, the index in KeyVals of its first key, or
+//  TSection::NotFound.
+void FindSettingKeys(TSection const& section, size_t (&keyIdx)[SettingCount])
+{
+    for (size_t i = 0; i < SettingCount; i++)
+        keyIdx[i] = TSection::NotFound;
+
+    for (size_t i = 0; i < section.KeyVals.size(); i++)
+    {
+        TKeyVal const& keyVal = section.KeyVals[i];
+        if (keyVal.Key.empty())
+            continue; // Comment, or value only
+
+        size_t const settingIdx = FindSetting(keyVal.Key);
+
+        if (SettingNotFound != settingIdx && TSection::NotFound == keyIdx[settingIdx])
+            keyIdx[settingIdx] = i;
+    }
+}
+//---------------------------------------------------------------------------
+
+} // namespace
+
+
 /////////////////////////////////////////////////////////////////////////////
 // TAppSettings
 /////////////////////////////////////////////////////////////////////////////
 
-char const* const TAppSettings::Default_DirLogs = "%localAppData%\\ASWSoftware\\SweepThemMines\\Logs\\";
-char const* const TAppSettings::Default_LogPrefix = "GeneralSTM_";
+char const* const TAppSettings::Default_DirLogs = DefaultDirLogs;
+char const* const TAppSettings::Default_LogPrefix = DefaultLogPrefix;
 
 char const* TAppSettings::SectionName_General = "[General]";
 
-// Key names - General
-char const* const TAppSettings::KeyName_Gen_ImagesPath = "ImagesPath";
-char const* const TAppSettings::KeyName_Gen_EnableCheats = "EnableCheats";
-char const* const TAppSettings::KeyName_Gen_UseQuestionMarksInit = "UseQuestionMarksInit";
-char const* const TAppSettings::KeyName_Gen_DirLogs = "DirLogs";
-char const* const TAppSettings::KeyName_Gen_LogPrefix = "LogPrefix";
-char const* const TAppSettings::KeyName_Gen_LogLevel = "LogLevel";
-char const* const TAppSettings::KeyName_Gen_NDaysRetainLogs = "NDaysRetainLogs";
-
-// Comments
-char const* const TAppSettings::KeyName_Gen_ImagesPath_Comment = ";Leave blank for default (exe directory).";
-char const* const TAppSettings::KeyName_Gen_LogLevel_Comment =
-    ";Valid range for LogLevel: 0-4. 0=System/forced logs only, 1=errors/warnings, 2=medium, 3=heavy, 4=debug/verbose";
-char const* const TAppSettings::KeyName_Gen_NDaysRetainLogs_Comment =
-    ";Valid value for NDaysRetainLogs: 0 to N days. 0=retain forever.";
-
 //---------------------------------------------------------------------------
 TAppSettings::TAppSettings()
 {
@@ -84,16 +256,11 @@ bool TAppSettings::Reset_Private()
     Destroy_Private();
 
     // Reset class vars here
-    m_EnableCheatsWasPresent = false;
+    m_SettingsInFile = 0;
     NeedsResaved = false;
 
-    Gen_ImagesPath = "";
-    Gen_EnableCheats = false;
-    Gen_UseQuestionMarksInit = true;
-    Gen_DirLogs = Default_DirLogs;
-    Gen_LogPrefix = Default_LogPrefix;
-    Gen_LogLevel = 0;//ELogMsgLevel::LML_Medium;
-    Gen_NDaysRetainLogs = 30;
+    for (size_t i = 0; i < SettingCount; i++)
+        ResetSetting(i);
 
     return true;
 }
@@ -105,180 +272,127 @@ bool TAppSettings::Reset() // virtual
     return Reset_Private();
 }
 //---------------------------------------------------------------------------
-bool TAppSettings::ParseSection_General()
+void TAppSettings::ResetSetting(size_t settingIdx)
 {
-    std::string sectionName = SectionName_General;
-    std::string searchKey, tmpStr;
-    TSection* secP;
-    TKeyVal* keyValP;
-    size_t idx;
+    TSettingDesc const& desc = SettingDescs[settingIdx];
 
-    if (Sections.size() == 0)
+    switch (desc.Type)
     {
-        // All sections are missing - use defaults
-        NeedsResaved = true;
-        return true;
+    case ESettingType::String:
+        this->*desc.StrMember = desc.DefaultStr;
+        break;
+    case ESettingType::Bool:
+        this->*desc.BoolMember = 0 != desc.DefaultNum;
+        break;
+    case ESettingType::UInt:
+        this->*desc.UIntMember = desc.DefaultNum;
+        break;
     }
+}
+//---------------------------------------------------------------------------
+// -Returns false, leaving the member as it was, if 'value' is not valid for the setting.
+bool TAppSettings::ParseSetting(size_t settingIdx, TStrView value)
+{
+    TSettingDesc const& desc = SettingDescs[settingIdx];
 
-    idx = FindSection(sectionName, true);
-
-    if (TSection::NotFound == idx)
+    switch (desc.Type)
     {
-        // Section missing - use defaults
-        NeedsResaved = true;
-        return true;
-    }
+    case ESettingType::String:
+    {
+        TStrView const trimmedVal = TStrTool::Trim_View(value);
 
-    // Found section - parse key values
-    secP = &Sections[idx];
+        if (trimmedVal.length() == 0 && 0 != (desc.Flags & SF_NotEmpty))
+            return false;
 
-    searchKey = KeyName_Gen_ImagesPath;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
-    {
-        // Key is missing - use default
-        NeedsResaved = true;
+        this->*desc.StrMember = trimmedVal.ToString();
+        return true;
     }
-    else
+    case ESettingType::Bool:
+        this->*desc.BoolMember = TStrTool::ToBool(value);
+        return true;
+    case ESettingType::UInt:
     {
-        keyValP = &secP->KeyVals[idx];
-        Gen_ImagesPath = TStrTool::Trim_Copy(keyValP->Value);
-    }
+        std::string const tmpStr = TStrTool::Trim_View(value).ToString();
+        int const valInt = std::atoi(tmpStr.c_str());
 
-    searchKey = KeyName_Gen_EnableCheats;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
-    {
-        // Key is missing - use default
-    }
-    else
-    {
-        m_EnableCheatsWasPresent = true;
-        keyValP = &secP->KeyVals[idx];
-        Gen_EnableCheats = TStrTool::ToBool(keyValP->Value);
-    }
+        if (tmpStr.length() == 0 || valInt < 0)
+            return false;
 
-    searchKey = KeyName_Gen_UseQuestionMarksInit;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
-    {
-        // Key is missing - use default
-        NeedsResaved = true;
+        this->*desc.UIntMember = static_cast<DWORD>(valInt);
+        return true;
     }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        Gen_UseQuestionMarksInit = TStrTool::ToBool(keyValP->Value);
     }
 
-    searchKey = KeyName_Gen_DirLogs;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
+    return false;
+}
+//---------------------------------------------------------------------------
+std::string TAppSettings::FormatSetting(size_t settingIdx) const
+{
+    TSettingDesc const& desc = SettingDescs[settingIdx];
+
+    switch (desc.Type)
     {
-        // Key is missing - use default
-        NeedsResaved = true;
+    case ESettingType::String:
+        return this->*desc.StrMember;
+    case ESettingType::Bool:
+        return this->*desc.BoolMember ? "1" : "0";
+    case ESettingType::UInt:
+#if __cplusplus >= 201103L
+        return std::to_string(this->*desc.UIntMember);
+#else
+        return TStrTool::ToStringA(this->*desc.UIntMember);
+#endif
     }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        tmpStr = TStrTool::Trim_Copy(keyValP->Value);
 
-        if (tmpStr.length() == 0)
-        {
-            // Invalid value - use default
-            NeedsResaved = true;
-        }
-        else
-        {
-            Gen_DirLogs = tmpStr;
-        }
-    }
+    return std::string();
+}
+//---------------------------------------------------------------------------
+bool TAppSettings::ParseSection_General()
+{
+    std::string sectionName = SectionName_General;
+    TSection* secP;
+    size_t idx;
 
-    searchKey = KeyName_Gen_LogPrefix;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
+    if (Sections.size() == 0)
     {
-        // Key is missing - use default
+        // All sections are missing - use defaults
         NeedsResaved = true;
+        return true;
     }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        tmpStr = TStrTool::Trim_Copy(keyValP->Value);
 
-        if (tmpStr.length() == 0)
-        {
-            // Invalid value - use default
-            NeedsResaved = true;
-        }
-        else
-        {
-            Gen_LogPrefix = tmpStr;
-        }
-    }
+    idx = FindSection(sectionName, true);
 
-    searchKey = KeyName_Gen_LogLevel;
-    idx = secP->FindKey(searchKey, true);
     if (TSection::NotFound == idx)
     {
-        // Key is missing - use default
+        // Section missing - use defaults
         NeedsResaved = true;
+        return true;
     }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        tmpStr = TStrTool::Trim_Copy(keyValP->Value);
 
-        int valInt = std::atoi(tmpStr.c_str());
+    // Found section - parse key values
+    secP = &Sections[idx];
 
-        if (tmpStr.length() == 0 || valInt < 0)
-        {
-//            ELog.fwprintf(ELogMsgLevel::LML_Light,
-//                L"%s: Warning: Section \"%s\" has invalid value for key: \"%s\". Valid range: 0 - 4, "
-//                    "higher number = heavier logging. Using default.\n",
-//                codeSectStr, sectionNameW.c_str(), TStrTool::Utf8ToUnicodeStr(searchKey).c_str());
-            NeedsResaved = true;
-        }
-//        else if (valInt > (int)ELogMsgLevel::LML_Debug)
-//        {
-//            //max log level exceeded - cap to max
-//            Gen_LogLevel = ELogMsgLevel::LML_Debug;
-//            NeedsResaved = true;
-//        }
-        else
-        {
-//            Gen_LogLevel = static_cast<ELogMsgLevel>(valInt);
-            Gen_LogLevel = static_cast<DWORD>(valInt);
-        }
-    }
+    size_t keyIdx[SettingCount];
+    FindSettingKeys(*secP, keyIdx);
 
-    searchKey = KeyName_Gen_NDaysRetainLogs;
-    idx = secP->FindKey(searchKey, true);
-    if (TSection::NotFound == idx)
-    {
-//        ELog.fwprintf(ELogMsgLevel::LML_Light, L"%s: Warning: Missing key: \"%s\". Using default.\n",
-//            codeSectStr, TStrTool::Utf8ToUnicodeStr(searchKey).c_str());
-        NeedsResaved = true;
-    }
-    else
+    for (size_t i = 0; i < SettingCount; i++)
     {
-        keyValP = &secP->KeyVals[idx];
-        tmpStr = TStrTool::Trim_Copy(keyValP->Value);
+        if (TSection::NotFound == keyIdx[i])
+        {
+            // Key is missing - use default
+            if (0 == (SettingDescs[i].Flags & SF_Hidden))
+                NeedsResaved = true;
 
-        int valInt = std::atoi(tmpStr.c_str());
+            continue;
+        }
 
-        if (tmpStr.length() == 0 || valInt < 0)
+        m_SettingsInFile |= static_cast<uint32_t>(1) << i;
+
+        if (!ParseSetting(i, secP->KeyVals[keyIdx[i]].Value))
         {
-//            ELog.fwprintf(ELogMsgLevel::LML_Light,
-//                L"%s: Warning: Section \"%s\" has invalid value for key: \"%s\". Valid range: 0 - N, 0=never delete "
-//                    "old logs. Using default.\n",
-//                codeSectStr, sectionNameW.c_str(), TStrTool::Utf8ToUnicodeStr(searchKey).c_str());
+            // Invalid value - use default
             NeedsResaved = true;
         }
-        else
-        {
-            Gen_NDaysRetainLogs = static_cast<DWORD>(valInt);
-        }
     }
 
     return true;
@@ -287,10 +401,8 @@ bool TAppSettings::ParseSection_General()
 bool TAppSettings::ApplyChanges_General()
 {
     std::string sectionName = SectionName_General;
-    std::string searchKey;
     bool result = true;
     TSection* secP;
-    TKeyVal* keyValP;
     size_t idx;
 
     idx = FindOrCreateSection(sectionName, true);
@@ -299,130 +411,49 @@ bool TAppSettings::ApplyChanges_General()
         return false;
 
     secP = &Sections[idx];
-    secP->Name = sectionName;
+    secP->SetName(sectionName);
 
     // Apply values to the section
 
-    // Images directory
-    searchKey = KeyName_Gen_ImagesPath;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-        keyValP->Value = Gen_ImagesPath;
-
-        // Insert comment if a comment is not already before this element
-        if (idx == 0 || !secP->KeyVals[idx - 1].IsComment() ||
-            secP->KeyVals[idx - 1].Value != KeyName_Gen_ImagesPath_Comment)
-        {
-            secP->InsertComment(idx, KeyName_Gen_ImagesPath_Comment);
-        }
-    }
+    size_t keyIdx[SettingCount];
+    FindSettingKeys(*secP, keyIdx);
 
-    // EnableCheats - only save if it was present when loading from the ini
-    if (m_EnableCheatsWasPresent)
+    for (size_t i = 0; i < SettingCount; i++)
     {
-        searchKey = KeyName_Gen_EnableCheats;
-        if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-        {
-            result = false;
-        }
-        else
-        {
-            keyValP = &secP->KeyVals[idx];
-            keyValP->Key = searchKey;
-            keyValP->Value = (Gen_EnableCheats ? "1" : "0");
-        }
-    }
+        TSettingDesc const& desc = SettingDescs[i];
 
-    // UseQuestionMarksInit
-    searchKey = KeyName_Gen_UseQuestionMarksInit;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-        keyValP->Value = (Gen_UseQuestionMarksInit ? "1" : "0");
-    }
+        if (0 != (desc.Flags & SF_Hidden) && 0 == (m_SettingsInFile & (static_cast<uint32_t>(1) << i)))
+            continue;
 
-    //logs directory
-    searchKey = KeyName_Gen_DirLogs;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-        keyValP->Value = Gen_DirLogs;
-    }
-
-    //log prefix
-    searchKey = KeyName_Gen_LogPrefix;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-        keyValP->Value = Gen_LogPrefix;
-    }
+        idx = keyIdx[i];
 
-    //log level
-    searchKey = KeyName_Gen_LogLevel;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-#if __cplusplus >= 201103L
-        keyValP->Value = std::to_string(static_cast<int>(Gen_LogLevel));
-#else
-        keyValP->Value = TStrTool::ToStringA(static_cast<int>(Gen_LogLevel));
-#endif
+        if (TSection::NotFound == idx)
+        {
+            if (!secP->AddKeyVal(desc.Name, FormatSetting(i)))
+            {
+                result = false;
+                continue;
+            }
 
-        //insert comment if a comment is not already before this element
-        if (idx == 0 || !secP->KeyVals[idx - 1].IsComment() ||
-            secP->KeyVals[idx - 1].Value != KeyName_Gen_LogLevel_Comment)
+            idx = secP->KeyVals.size() - 1;
+        }
+        else
         {
-            secP->InsertComment(idx, KeyName_Gen_LogLevel_Comment);
+            secP->SetKeyVal(idx, desc.Name, FormatSetting(i));
         }
-    }
 
-    //retain logs
-    searchKey = KeyName_Gen_NDaysRetainLogs;
-    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
-    {
-        result = false;
-    }
-    else
-    {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
-#if __cplusplus >= 201103L
-        keyValP->Value = std::to_string(Gen_NDaysRetainLogs);
-#else
-        keyValP->Value = TStrTool::ToStringA(Gen_NDaysRetainLogs);
-#endif
-
-        //insert comment if a comment is not already before this element
-        if (idx == 0 || !secP->KeyVals[idx - 1].IsComment() ||
-            secP->KeyVals[idx - 1].Value != KeyName_Gen_NDaysRetainLogs_Comment)
+        // Insert comment if a comment is not already before this element
+        if (nullptr != desc.Comment &&
+            (idx == 0 || !secP->KeyVals[idx - 1].IsComment() || secP->KeyVals[idx - 1].Value != desc.Comment))
         {
-            secP->InsertComment(idx, KeyName_Gen_NDaysRetainLogs_Comment);
+            secP->InsertComment(idx, desc.Comment);
+
+            // Keys from 'idx' on moved down one
+            for (size_t j = 0; j < SettingCount; j++)
+            {
+                if (TSection::NotFound != keyIdx[j] && keyIdx[j] >= idx)
+                    keyIdx[j]++;
+            }
         }
     }
 
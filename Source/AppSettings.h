@@ -24,6 +24,7 @@ limitations under the License.
 #define AppSettingsH
 //---------------------------------------------------------------------------
 #include <windows.h>
+#include <stdint.h>
 #include <string>
 //---------------------------------------------------------------------------
 #include "ASWTools_BasicINI.h"
@@ -36,6 +37,11 @@ namespace SweepThemMines
 
 /////////////////////////////////////////////////////////////////////////////
 // TAppSettings
+//
+// The settings are described once, in a table in AppSettings.cpp: key name,
+// type, default, comment and the member that holds the value. Defaults,
+// parsing and saving all come from that table, and keys are matched to it
+// through a perfect hash built at compile time.
 /////////////////////////////////////////////////////////////////////////////
 class TAppSettings : public ASWTools::BasicINI::TBasicINI
 {
@@ -49,26 +55,16 @@ public: // Static variables
     // Section names
     static char const* SectionName_General;
 
-    // Key names - General
-    static char const* const KeyName_Gen_ImagesPath;
-    static char const* const KeyName_Gen_EnableCheats;
-    static char const* const KeyName_Gen_UseQuestionMarksInit;
-    static char const* const KeyName_Gen_DirLogs;
-    static char const* const KeyName_Gen_LogPrefix;
-    static char const* const KeyName_Gen_LogLevel;
-    static char const* const KeyName_Gen_NDaysRetainLogs;
-
-    //ini comments
-    static char const* const KeyName_Gen_ImagesPath_Comment;
-    static char const* const KeyName_Gen_LogLevel_Comment;
-    static char const* const KeyName_Gen_NDaysRetainLogs_Comment;
-
 private:
     void Destroy_Private();
     bool Reset_Private();
 
+    void ResetSetting(size_t settingIdx);
+    bool ParseSetting(size_t settingIdx, ASWTools::TStrView value);
+    std::string FormatSetting(size_t settingIdx) const;
+
 private:
-    bool m_EnableCheatsWasPresent;
+    uint32_t m_SettingsInFile; // Bit per setting, set for those found by the last load
 
 public:
     bool NeedsResaved;
@@ -29,6 +29,8 @@ limitations under the License.
 #pragma package(smart_init)
 #pragma resource "*.dfm"
 //---------------------------------------------------------------------------
+#include <algorithm>
+//---------------------------------------------------------------------------
 #include <Vcl.Dialogs.hpp>
 //---------------------------------------------------------------------------
 #include "ASWTools_Path.h"
@@ -77,7 +79,25 @@ __fastcall TFormMain::TFormMain(TComponent* Owner)
         MsgDlg(msg, "", TMsgDlgType::mtError, TMsgDlgButtons() << TMsgDlgBtn::mbOK);
     }
 
-    m_MineSweeper.Sprites.LoadSprites(imagesDir.c_str());
+#if defined(USE_ELOG)
+    TSprite::ResetStats();
+#endif
+    // Decoded images are cached per user, keyed by images folder
+    std::string const spriteCacheFile = TSpriteCache::GetCacheFileName(app->DirAppData, imagesDir.c_str());
+    m_MineSweeper.Sprites.LoadSprites(imagesDir.c_str(), spriteCacheFile);
+#if defined(USE_ELOG)
+    TSprite::TStats const spriteStats = TSprite::GetStats();
+    ELog.fprintf(ELogMsgLevel::LML_Debug, "Sprites loaded: images: %u, shared copies: %u, moves: %u\n",
+        spriteStats.ImageAllocs, spriteStats.SharedCopies, spriteStats.Moves);
+
+    TSpriteLoader::TTimings const& loadTimings = m_MineSweeper.Sprites.GetLoadTimings();
+    ELog.fprintf(ELogMsgLevel::LML_Debug,
+        "Sprites load: %u files, %u threads, %u from cache, read/decode: %lld us, build: %lld us, total: %lld us%s\n",
+        static_cast<unsigned int>(loadTimings.NumSprites), static_cast<unsigned int>(loadTimings.NumThreads),
+        static_cast<unsigned int>(loadTimings.NumFromCache), static_cast<long long>(loadTimings.ReadDecodeMicroSecs),
+        static_cast<long long>(loadTimings.BuildMicroSecs), static_cast<long long>(loadTimings.TotalMicroSecs),
+        m_MineSweeper.Sprites.GetCacheSaved() ? ", cache saved" : "");
+#endif
     BtnReact->Glyph->Assign(m_MineSweeper.Sprites.FaceHappy.Bmp);
     MnuQuestionMarks->Checked = app->Settings.Gen_UseQuestionMarksInit;
 }
@@ -98,7 +118,7 @@ void TFormMain::AddScoresToLines(TStrings* lines, TScores::TScoreList const& sco
     for (TScores::TScoreList::const_iterator it = scores.begin(); it != scores.end(); it++)
     {
         TScore const& item = *it;
-        lines->Add(IntToStr(item.Seconds) + " seconds\t " + item.Name.c_str());
+        lines->Add(FormatFloat("0.000", item.MilliSecs / 1000.0) + " seconds\t " + item.Name.c_str());
     }
 }
 //---------------------------------------------------------------------------
@@ -123,6 +143,7 @@ void __fastcall TFormMain::ApplicationEventsRestore(TObject* /*sender*/)
             m_MineSweeper.ResumeTime();
         }
         DrawScoreboards();
+        ScheduleScoreboardTimer();
     }
 }
 //---------------------------------------------------------------------------
@@ -132,6 +153,13 @@ void TFormMain::DrawScoreboards()
     m_MineSweeper.DrawMinesRemaining(ImageMinesRemaining);
 }
 //---------------------------------------------------------------------------
+// Draws any pending map changes now, regardless of frame pacing.
+void TFormMain::FlushRender()
+{
+    TimerRender->Enabled = false;
+    m_RenderScheduler.Render(m_MineSweeper, ImageMap);
+}
+//---------------------------------------------------------------------------
 void __fastcall TFormMain::FormClose(TObject* /*sender*/, TCloseAction& /*action*/)
 {
     ExitApp();
@@ -140,10 +168,12 @@ void __fastcall TFormMain::FormClose(TObject* /*sender*/, TCloseAction& /*action
 void __fastcall TFormMain::FormResize(TObject* /*sender*/)
 {
     ReCenter();
+    UpdateMinimap();
 }
 //---------------------------------------------------------------------------
 void TFormMain::ExitApp()
 {
+    LogRenderStats();
     TApp::GetInstance().TerminateApp();
     Application->Terminate();
 }
@@ -158,11 +188,15 @@ void __fastcall TFormMain::FormKeyDown(TObject* /*sender*/, WORD& key, TShiftSta
 //---------------------------------------------------------------------------
 void __fastcall TFormMain::FormMouseMove(TObject* /*sender*/, TShiftState shift, int /*x*/, int /*y*/)
 {
-    m_MineSweeper.DrawMap(ImageMap, shift, -1, -1);
+    RequestRender(shift, -1, -1);
 }
 //---------------------------------------------------------------------------
 void __fastcall TFormMain::FormShow(TObject* /*sender*/)
 {
+    // Pace map drawing to the display. VREFRESH returns 0 or 1 when the rate is unknown (the scheduler's default).
+    m_RenderScheduler.SetFrameRate(::GetDeviceCaps(Canvas->Handle, VREFRESH));
+
+    UpdateZoomMenu();
     NewGame();
 }
 //---------------------------------------------------------------------------
@@ -186,6 +220,20 @@ String TFormMain::GetHighScoresFilename()
     return TPathTool::Combine(app->DirAppData, BaseFilename_HighScores).c_str();
 }
 //---------------------------------------------------------------------------
+void __fastcall TFormMain::ImageMinimapMouseDown(
+    TObject* /*sender*/, TMouseButton button, TShiftState /*shift*/, int x, int y)
+{
+    if (mbLeft == button)
+        JumpToMinimapPoint(x, y);
+}
+//---------------------------------------------------------------------------
+// Dragging on the minimap pans the map
+void __fastcall TFormMain::ImageMinimapMouseMove(TObject* /*sender*/, TShiftState shift, int x, int y)
+{
+    if (shift.Contains(ssLeft))
+        JumpToMinimapPoint(x, y);
+}
+//---------------------------------------------------------------------------
 void __fastcall TFormMain::ImageMapMouseDown(
     TObject* /*sender*/, TMouseButton /*button*/, TShiftState shift, int /*x*/, int /*y*/)
 {
@@ -197,7 +245,7 @@ void __fastcall TFormMain::ImageMapMouseDown(
     TPoint pos = GetExtendedImageMapMousePos();
 
     m_MineSweeper.MouseDown(shift, pos.x, pos.y);
-    m_MineSweeper.DrawMap(ImageMap, shift, pos.x, pos.y);
+    RequestRender(shift, pos.x, pos.y);
 
     EGameState state = m_MineSweeper.GetGameState();
     if (shift.Contains(ssLeft) && EGameState::GameOver_Boom != state)
@@ -210,7 +258,7 @@ void __fastcall TFormMain::ImageMapMouseMove(TObject* /*sender*/, TShiftState sh
         return;
 
     TPoint pos = GetExtendedImageMapMousePos();
-    m_MineSweeper.DrawMap(ImageMap, shift, pos.x, pos.y);
+    RequestRender(shift, pos.x, pos.y);
 }
 //---------------------------------------------------------------------------
 void __fastcall TFormMain::ImageMapMouseUp(
@@ -232,7 +280,14 @@ void __fastcall TFormMain::ImageMapMouseUp(
     TPoint pos = GetExtendedImageMapMousePos();
 
     m_MineSweeper.MouseUp(shift, pos.x, pos.y);
-    m_MineSweeper.DrawMap(ImageMap, shift, pos.x, pos.y);
+    RequestRender(shift, pos.x, pos.y);
+
+    if (PanelMinimap->Visible)
+        m_MineSweeper.DrawMinimap(ImageMinimap);
+
+    // Show the final board before any dialog, rather than waiting for the next frame
+    if (m_MineSweeper.IsGameOver())
+        FlushRender();
 
     EGameState state = m_MineSweeper.GetGameState();
     if (EGameState::GameOver_Boom == state)
@@ -240,7 +295,7 @@ void __fastcall TFormMain::ImageMapMouseUp(
     else
         BtnReact->Glyph->Assign(m_MineSweeper.Sprites.FaceHappy.Bmp);
 
-    int seconds = m_MineSweeper.GetEllapsedTimeMilliSecs() / 1000;
+    int64_t milliSecs = m_MineSweeper.GetEllapsedTimeMilliSecs64();
 
     if (m_MineSweeper.IsGameOver())
     {
@@ -252,41 +307,45 @@ void __fastcall TFormMain::ImageMapMouseUp(
     if (mbRight == button)
         m_MineSweeper.DrawMinesRemaining(ImageMinesRemaining);
 
+    // The first click starts the clock - line the timer up with its second boundaries
+    if (m_MineSweeper.IsGameRunning())
+        ScheduleScoreboardTimer();
+
     if (EGameState::GameOver_Win == state)
     {
         BtnReact->Glyph->Assign(m_MineSweeper.Sprites.FaceWin.Bmp);
 
         if (MnuBeginner->Checked || MnuIntermediate->Checked || MnuExpert->Checked)
         {
-            TScores scores;
+            TScores& scores = m_HighScores;
             LoadHighScores(&scores);
             bool addScore = false;
 
             if (MnuBeginner->Checked)
             {
                 addScore = (scores.Beginner.size() < TScores::Default_MaxScoresToKeep ||
-                    scores.Beginner[scores.Beginner.size() - 1].Seconds > seconds);
+                    scores.Beginner[scores.Beginner.size() - 1].MilliSecs > milliSecs);
             }
             else if (MnuIntermediate->Checked)
             {
                 addScore = (scores.Intermediate.size() < TScores::Default_MaxScoresToKeep ||
-                    scores.Intermediate[scores.Intermediate.size() - 1].Seconds > seconds);
+                    scores.Intermediate[scores.Intermediate.size() - 1].MilliSecs > milliSecs);
             }
             else
             {
                 addScore = (scores.Expert.size() < TScores::Default_MaxScoresToKeep ||
-                    scores.Expert[scores.Expert.size() - 1].Seconds > seconds);
+                    scores.Expert[scores.Expert.size() - 1].MilliSecs > milliSecs);
             }
 
             UnicodeString playerName;
             if (addScore && InputQuery("You Won!", "Please enter your name for the scoreboard: ", playerName))
             {
                 if (MnuBeginner->Checked)
-                    SaveBestTime_Beginner(seconds, playerName);
+                    SaveBestTime_Beginner(milliSecs, playerName);
                 else if (MnuIntermediate->Checked)
-                    SaveBestTime_Intermediate(seconds, playerName);
+                    SaveBestTime_Intermediate(milliSecs, playerName);
                 else
-                    SaveBestTime_Expert(seconds, playerName);
+                    SaveBestTime_Expert(milliSecs, playerName);
             }
         }
         else
@@ -297,13 +356,30 @@ void __fastcall TFormMain::ImageMapMouseUp(
     }
 }
 //---------------------------------------------------------------------------
+// Scrolls the map so that the cell under minimap point x, y is in the middle of the view.
+void TFormMain::JumpToMinimapPoint(int x, int y)
+{
+    int mapX;
+    int mapY;
+    if (!m_MineSweeper.MinimapToMapPoint(x, y, &mapX, &mapY))
+        return;
+
+    // The scroll bars clamp positions past either end
+    ScrollBoxMap->HorzScrollBar->Position = mapX - ScrollBoxMap->ClientWidth / 2;
+    ScrollBoxMap->VertScrollBar->Position = mapY - ScrollBoxMap->ClientHeight / 2;
+}
+//---------------------------------------------------------------------------
+// Reads the file only if it changed since 'scores' last loaded or saved it.
 bool TFormMain::LoadHighScores(TScores* scores)
 {
     try
     {
         AnsiString filename = GetHighScoresFilename();
         if (!FileExists(filename))
+        {
+            scores->Reset(); // Deleted, or never saved - nothing kept from an earlier load applies
             return true;
+        }
 
         scores->Load(filename.c_str());
 
@@ -330,6 +406,37 @@ bool TFormMain::LoadHighScores(TScores* scores)
     return false;
 }
 //---------------------------------------------------------------------------
+// Writes the map's input latency and frame time to the log, at debug level.
+void TFormMain::LogRenderStats()
+{
+#if defined(USE_ELOG)
+    ELog.fprintf(ELogMsgLevel::LML_Debug, "Render: inputs: %llu, merged: %llu, renders: %llu\n",
+        static_cast<unsigned long long>(m_RenderScheduler.GetNumInputs()),
+        static_cast<unsigned long long>(m_RenderScheduler.GetNumMerged()),
+        static_cast<unsigned long long>(m_RenderScheduler.GetNumRenders()));
+
+    char const* const names[] = { "input latency", "frame time" };
+    TTimingHistogram const* const histograms[] =
+    {
+        &m_RenderScheduler.GetInputLatencyHistogram(),
+        &m_RenderScheduler.GetFrameTimeHistogram(),
+    };
+
+    for (size_t i = 0; i < sizeof(histograms) / sizeof(histograms[0]); i++)
+    {
+        TTimingHistogram const& histogram = *histograms[i];
+        ELog.fprintf(ELogMsgLevel::LML_Debug,
+            "Render %s: count: %llu, mean: %lld us, p50: %lld us, p95: %lld us, p99: %lld us, max: %lld us\n",
+            names[i], static_cast<unsigned long long>(histogram.GetCount()),
+            static_cast<long long>(histogram.GetMeanMicroSecs()),
+            static_cast<long long>(histogram.GetPercentileMicroSecs(50)),
+            static_cast<long long>(histogram.GetPercentileMicroSecs(95)),
+            static_cast<long long>(histogram.GetPercentileMicroSecs(99)),
+            static_cast<long long>(histogram.GetMaxMicroSecs()));
+    }
+#endif
+}
+//---------------------------------------------------------------------------
 void __fastcall TFormMain::MnuAboutClick(TObject* /*sender*/)
 {
     TApp* app = &TApp::GetInstance();
@@ -363,6 +470,12 @@ void __fastcall TFormMain::MnuHintsClick(TObject* /*sender*/)
     ShowHints();
 }
 //---------------------------------------------------------------------------
+void __fastcall TFormMain::MnuMinimapClick(TObject* /*sender*/)
+{
+    MnuMinimap->Checked = !MnuMinimap->Checked;
+    UpdateMinimap();
+}
+//---------------------------------------------------------------------------
 void __fastcall TFormMain::MnuNewGameClick(TObject* /*sender*/)
 {
     NewGame();
@@ -408,6 +521,25 @@ void __fastcall TFormMain::MnuQuestionMarksClick(TObject* /*sender*/)
     m_MineSweeper.SetUseQuestionMarks(MnuQuestionMarks->Checked);
 }
 //---------------------------------------------------------------------------
+void __fastcall TFormMain::MnuZoomActualSizeClick(TObject* /*sender*/)
+{
+    SetZoomLevel(TSprites::DefaultZoomLevel);
+}
+//---------------------------------------------------------------------------
+void __fastcall TFormMain::MnuZoomInClick(TObject* /*sender*/)
+{
+    size_t const zoomLevel = m_MineSweeper.GetZoomLevel();
+    if (zoomLevel + 1 < TSprites::NumZoomLevels)
+        SetZoomLevel(zoomLevel + 1);
+}
+//---------------------------------------------------------------------------
+void __fastcall TFormMain::MnuZoomOutClick(TObject* /*sender*/)
+{
+    size_t const zoomLevel = m_MineSweeper.GetZoomLevel();
+    if (zoomLevel > 0)
+        SetZoomLevel(zoomLevel - 1);
+}
+//---------------------------------------------------------------------------
 void TFormMain::NewGame()
 {
     size_t nRows;
@@ -450,6 +582,7 @@ void TFormMain::NewGame()
         ResizeFormToImageMap();
 
     ReCenter();
+    UpdateMinimap();
     BtnReact->Glyph->Assign(m_MineSweeper.Sprites.FaceHappy.Bmp);
     TimerScoreboard->Enabled = true;
 
@@ -464,6 +597,25 @@ void TFormMain::ReCenter()
     BtnReact->Left = (Width / 2) - (BtnReact->Width / 2);
 }
 //---------------------------------------------------------------------------
+// Mouse input only records what to draw. The map is drawn now if a display frame is due, otherwise the render
+// timer draws it once the frame comes up, with whatever input arrived in the meantime.
+void TFormMain::RequestRender(TShiftState shift, int mouseX, int mouseY)
+{
+    m_RenderScheduler.PostInput(shift, mouseX, mouseY);
+
+    if (m_RenderScheduler.RenderIfDue(m_MineSweeper, ImageMap))
+    {
+        TimerRender->Enabled = false;
+        return;
+    }
+
+    if (!TimerRender->Enabled)
+    {
+        TimerRender->Interval = static_cast<unsigned int>(std::max(1, m_RenderScheduler.GetMilliSecsToNextFrame()));
+        TimerRender->Enabled = true;
+    }
+}
+//---------------------------------------------------------------------------
 void TFormMain::ResetBestTimes()
 {
     String filename =  GetHighScoresFilename();
@@ -525,36 +677,58 @@ void TFormMain::SaveBestScores(TScores& scores)
     }
 }
 //---------------------------------------------------------------------------
-void TFormMain::SaveBestTime_Beginner(int seconds, AnsiString const& name)
+void TFormMain::SaveBestTime_Beginner(int64_t milliSecs, AnsiString const& name)
 {
-    TScores scores;
+    TScores& scores = m_HighScores;
     if (!LoadHighScores(&scores))
         return;
-    scores.AddScore(scores.Beginner, seconds, name.c_str());
+    scores.AddScore(scores.Beginner, milliSecs, name.c_str());
     SaveBestScores(scores);
 }
 //---------------------------------------------------------------------------
-void TFormMain::SaveBestTime_Expert(int seconds, AnsiString const& name)
+void TFormMain::SaveBestTime_Expert(int64_t milliSecs, AnsiString const& name)
 {
-    TScores scores;
+    TScores& scores = m_HighScores;
     if (!LoadHighScores(&scores))
         return;
-    scores.AddScore(scores.Expert, seconds, name.c_str());
+    scores.AddScore(scores.Expert, milliSecs, name.c_str());
     SaveBestScores(scores);
 }
 //---------------------------------------------------------------------------
-void TFormMain::SaveBestTime_Intermediate(int seconds, AnsiString const& name)
+void TFormMain::SaveBestTime_Intermediate(int64_t milliSecs, AnsiString const& name)
 {
-    TScores scores;
+    TScores& scores = m_HighScores;
     if (!LoadHighScores(&scores))
         return;
-    scores.AddScore(scores.Intermediate, seconds, name.c_str());
+    scores.AddScore(scores.Intermediate, milliSecs, name.c_str());
     SaveBestScores(scores);
 }
 //---------------------------------------------------------------------------
+// Wakes the scoreboard timer when the displayed time next changes, instead of polling.
+void TFormMain::ScheduleScoreboardTimer()
+{
+    TimerScoreboard->Interval = static_cast<unsigned int>(m_MineSweeper.GetMilliSecsToNextSecond());
+}
+//---------------------------------------------------------------------------
+// Every zoom level's sprites were scaled at load, so this only swaps them in and redraws the map once.
+void TFormMain::SetZoomLevel(size_t zoomLevel)
+{
+    // Draw anything still pending at the old cell size first
+    FlushRender();
+
+    if (!m_MineSweeper.SetZoomLevel(zoomLevel, ImageMap))
+        return;
+
+    m_MineSweeper.DrawMap(ImageMap);
+    ResizeFormToImageMap();
+    ReCenter();
+    UpdateMinimap();
+    UpdateZoomMenu();
+}
+//---------------------------------------------------------------------------
 void TFormMain::ShowBestTimes()
 {
-    TScores scores;
+    TScores& scores = m_HighScores;
     if (!LoadHighScores(&scores))
         return;
 
@@ -632,8 +806,42 @@ TModalResult TFormMain::ShowCustomDifficulty()
     return mRes;
 }
 //---------------------------------------------------------------------------
+void __fastcall TFormMain::TimerRenderTimer(TObject* /*sender*/)
+{
+    FlushRender();
+}
+//---------------------------------------------------------------------------
 void __fastcall TFormMain::TimerScoreboardTimer(TObject* /*sender*/)
 {
     DrawScoreboards();
+    ScheduleScoreboardTimer();
+}
+//---------------------------------------------------------------------------
+// The minimap only shows when the map doesn't fit in its scroll box, over the top right corner of the map.
+void TFormMain::UpdateMinimap()
+{
+    bool const mapClipped =
+        ImageMap->Width > ScrollBoxMap->ClientWidth || ImageMap->Height > ScrollBoxMap->ClientHeight;
+
+    PanelMinimap->Visible = MnuMinimap->Checked && mapClipped;
+    if (!PanelMinimap->Visible)
+        return;
+
+    // Brings the image up to date, which also sizes it (and the panel) for a new board
+    m_MineSweeper.DrawMinimap(ImageMinimap);
+
+    PanelMinimap->Left = ScrollBoxMap->Left + ScrollBoxMap->Width - PanelMinimap->Width -
+        ::GetSystemMetrics(SM_CXVSCROLL) - 8;
+    PanelMinimap->Top = ScrollBoxMap->Top + 8;
+    PanelMinimap->BringToFront();
+}
+//---------------------------------------------------------------------------
+// Disabled items don't respond to their shortcuts either, so this runs whenever the zoom level changes.
+void TFormMain::UpdateZoomMenu()
+{
+    size_t const zoomLevel = m_MineSweeper.GetZoomLevel();
+    MnuZoomIn->Enabled = zoomLevel + 1 < TSprites::NumZoomLevels;
+    MnuZoomOut->Enabled = zoomLevel > 0;
+    MnuZoomActualSize->Enabled = zoomLevel != TSprites::DefaultZoomLevel;
 }
 //---------------------------------------------------------------------------
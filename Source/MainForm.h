@@ -33,6 +33,7 @@ limitations under the License.
 // END OF IDE INCLUDES
 //---------------------------------------------------------------------------
 #include "ASWMS_Engine.h"
+#include "ASWMS_RenderScheduler.h"
 #include "Scores.h"
 //---------------------------------------------------------------------------
 
@@ -69,6 +70,15 @@ __published: // IDE-managed Components
     TMenuItem* N5;
     TMenuItem* MnuRules;
     TMenuItem* MnuHints;
+    TTimer* TimerRender;
+    TMenuItem* MnuView;
+    TMenuItem* MnuZoomIn;
+    TMenuItem* MnuZoomOut;
+    TMenuItem* MnuZoomActualSize;
+    TPanel* PanelMinimap;
+    TImage* ImageMinimap;
+    TMenuItem* N6;
+    TMenuItem* MnuMinimap;
     void __fastcall FormDestroy(TObject* Sender);
     void __fastcall MnuExitClick(TObject* Sender);
     void __fastcall MnuAboutClick(TObject* Sender);
@@ -91,6 +101,13 @@ __published: // IDE-managed Components
     void __fastcall FormKeyDown(TObject* Sender, WORD& Key, TShiftState Shift);
     void __fastcall MnuRulesClick(TObject* Sender);
     void __fastcall MnuHintsClick(TObject* Sender);
+    void __fastcall TimerRenderTimer(TObject* Sender);
+    void __fastcall MnuZoomInClick(TObject* Sender);
+    void __fastcall MnuZoomOutClick(TObject* Sender);
+    void __fastcall MnuZoomActualSizeClick(TObject* Sender);
+    void __fastcall ImageMinimapMouseDown(TObject* Sender, TMouseButton Button, TShiftState Shift, int X, int Y);
+    void __fastcall ImageMinimapMouseMove(TObject* Sender, TShiftState Shift, int X, int Y);
+    void __fastcall MnuMinimapClick(TObject* Sender);
 private: // User declarations
     static char const* const BaseFilename_HighScores;
 
@@ -102,25 +119,35 @@ private: // User declarations
     System::String m_BaseFormCaption;
 
     ASWMS::TMSEngine m_MineSweeper;
+    ASWMS::TRenderScheduler m_RenderScheduler;
+    SweepThemMines::TScores m_HighScores; // Kept between games, so the file is only re-read when it changes
 
 private:
     void AddScoresToLines(System::Classes::TStrings* lines, SweepThemMines::TScores::TScoreList const& scores);
     void DrawScoreboards();
+    void FlushRender();
     TPoint GetExtendedImageMapMousePos();
     System::String GetHighScoresFilename();
+    void JumpToMinimapPoint(int x, int y);
     bool LoadHighScores(SweepThemMines::TScores* scores);
+    void LogRenderStats();
     void NewGame();
     void ReCenter();
+    void RequestRender(TShiftState shift, int mouseX, int mouseY);
     void ResetBestTimes();
     void ResizeFormToImageMap();
     void SaveBestScores(SweepThemMines::TScores& scores);
-    void SaveBestTime_Beginner(int seconds, AnsiString const& name);
-    void SaveBestTime_Expert(int seconds, AnsiString const& name);
-    void SaveBestTime_Intermediate(int seconds, AnsiString const& name);
+    void SaveBestTime_Beginner(int64_t milliSecs, AnsiString const& name);
+    void SaveBestTime_Expert(int64_t milliSecs, AnsiString const& name);
+    void SaveBestTime_Intermediate(int64_t milliSecs, AnsiString const& name);
+    void ScheduleScoreboardTimer();
+    void SetZoomLevel(size_t zoomLevel);
     void ShowBestTimes();
     void ShowHints();
     void ShowRules();
     TModalResult ShowCustomDifficulty();
+    void UpdateMinimap();
+    void UpdateZoomMenu();
 
 public:  // User declarations
 #if defined(__clang__)
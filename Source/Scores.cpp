@@ -52,6 +52,7 @@ char const* TScores::SectionName_Scores = "[Scores]";
 
 // Key names - General
 char const* TScores::KeyName_Gen_Check = "Check";
+char const* TScores::KeyName_Gen_CheckVersion = "CheckVersion";
 
 // Key names - Scores
 char const* TScores::KeyName_Scores_Beginner = "Beginner";
@@ -60,7 +61,8 @@ char const* TScores::KeyName_Scores_Expert = "Expert";
 
 //---------------------------------------------------------------------------
 TScores::TScores()
-    : m_Check(Check_NotSetVal)
+    : m_Check(Check_NotSetVal),
+      m_CheckVersion(CheckVersion_Legacy)
 {
     Reset();
 }
@@ -76,23 +78,32 @@ bool TScores::Reset()
         return false;
 
     m_Check = Check_NotSetVal;
+    m_CheckVersion = CheckVersion_Legacy;
     Beginner.clear();
     Intermediate.clear();
     Expert.clear();
     return true;
 }
 //---------------------------------------------------------------------------
+// The score lists are only written into the document by Save(), so they count as dirty once they no longer match
+// the check hash they were loaded or saved with. A file that failed ValidateCheck() stays dirty, so it is re-read.
+bool TScores::IsDirty() const
+{
+    return Inherited::IsDirty() || CalcCheckHash() != m_Check;
+}
+//---------------------------------------------------------------------------
 void TScores::AddScore(TScoreList& list, TScore const& score)
 {
     list.push_back(score);
 }
 //---------------------------------------------------------------------------
-void TScores::AddScore(TScoreList& list, int seconds, std::string const& name)
+void TScores::AddScore(TScoreList& list, int64_t milliSecs, std::string const& name)
 {
     TScore score;
-    score.Seconds = seconds;
+    score.Seconds = static_cast<int>(milliSecs / 1000);
+    score.MilliSecs = milliSecs;
     score.Name = name;
-    score.TimeUtcStr = TStrTool::DateTime_GetUTCNow_ISO8601();
+    score.TimeUtcMs = TStrTool::DateTime_GetUTCNow_EpochMs();
     AddScore(list, score);
 }
 //---------------------------------------------------------------------------
@@ -102,7 +113,6 @@ bool TScores::ApplyChanges_General()
     std::string searchKey;
     bool result = true;
     TSection* secP;
-    TKeyVal* keyValP;
     size_t idx;
 
     idx = FindOrCreateSection(sectionName, true);
@@ -111,7 +121,7 @@ bool TScores::ApplyChanges_General()
         return false;
 
     secP = &Sections[idx];
-    secP->Name = sectionName;
+    secP->SetName(sectionName);
 
     // Apply values to the section
 
@@ -123,13 +133,27 @@ bool TScores::ApplyChanges_General()
     }
     else
     {
-        keyValP = &secP->KeyVals[idx];
-        keyValP->Key = searchKey;
+        m_CheckVersion = CheckVersion_Current;
         m_Check = CalcCheckHash();
 #if __cplusplus >= 201103L
-        keyValP->Value = std::to_string(m_Check);
+        secP->SetKeyVal(idx, searchKey, std::to_string(m_Check));
 #else
-        keyValP->Value = TStrTool::ToStringA(m_Check);
+        secP->SetKeyVal(idx, searchKey, TStrTool::ToStringA(m_Check));
+#endif
+    }
+
+    // Check hash version
+    searchKey = KeyName_Gen_CheckVersion;
+    if (TSection::NotFound == (idx = secP->FindOrCreateKey(searchKey, true)))
+    {
+        result = false;
+    }
+    else
+    {
+#if __cplusplus >= 201103L
+        secP->SetKeyVal(idx, searchKey, std::to_string(m_CheckVersion));
+#else
+        secP->SetKeyVal(idx, searchKey, TStrTool::ToStringA(m_CheckVersion));
 #endif
     }
 
@@ -149,38 +173,54 @@ bool TScores::ApplyChanges_Scores()
         return false;
 
     secP = &Sections[idx];
-    secP->Name = sectionName;
+    secP->SetName(sectionName);
 
     // Apply values to the section
 
-    // Clear underyling key value pairs because each list will be re-added fresh.
-    secP->KeyVals.clear();
+    // Each list is written out fresh, into a section of its own first so that it can be compared with what is there
+    TSection scoresSec;
 
     // Beginner score(s)
     for (TScores::TScoreList::const_iterator it = Beginner.begin(); it != Beginner.end(); it++)
     {
         TScore const& score = *it;
-        secP->AddKeyVal(KeyName_Scores_Beginner, EncodeScoreToB64(score));
+        scoresSec.AddKeyVal(KeyName_Scores_Beginner, EncodeScoreToB64(score));
     }
 
     // Intermediate score(s)
     for (TScores::TScoreList::const_iterator it = Intermediate.begin(); it != Intermediate.end(); it++)
     {
         TScore const& score = *it;
-        secP->AddKeyVal(KeyName_Scores_Intermediate, EncodeScoreToB64(score));
+        scoresSec.AddKeyVal(KeyName_Scores_Intermediate, EncodeScoreToB64(score));
     }
 
     // Expert score(s)
     for (TScores::TScoreList::const_iterator it = Expert.begin(); it != Expert.end(); it++)
     {
         TScore const& score = *it;
-        secP->AddKeyVal(KeyName_Scores_Expert, EncodeScoreToB64(score));
+        scoresSec.AddKeyVal(KeyName_Scores_Expert, EncodeScoreToB64(score));
+    }
+
+    // Replace the old key value pairs only if the scores changed, so an unchanged file isn't rewritten
+    bool same = secP->KeyVals.size() == scoresSec.KeyVals.size();
+
+    for (size_t i = 0; same && i < scoresSec.KeyVals.size(); i++)
+    {
+        same = secP->KeyVals[i].Key == scoresSec.KeyVals[i].Key &&
+            secP->KeyVals[i].Value == scoresSec.KeyVals[i].Value;
+    }
+
+    if (!same)
+    {
+        secP->KeyVals.swap(scoresSec.KeyVals);
+        secP->InvalidateIndex();
+        secP->SetDirty();
     }
 
     return result;
 }
 //---------------------------------------------------------------------------
-uint32_t TScores::CalcCheckHash()
+uint32_t TScores::CalcCheckHash() const
 {
     uint64_t adlerBeginner = GetAdler32(Beginner);
     uint64_t adlerIntermediate = GetAdler32(Intermediate);
@@ -189,66 +229,139 @@ uint32_t TScores::CalcCheckHash()
     return static_cast<uint32_t>(adlerBeginner + adlerIntermediate + adlerExpert);
 }
 //---------------------------------------------------------------------------
+// -Static
+// -The file, and the check hash, hold the time as ISO-8601 text. Whole seconds are written without milliseconds,
+//  which is exactly what scores saved as "%Y-%m-%dT%H:%M:%SZ" text read back as, so their check still matches.
+// -Returns the end of what was written, or 'first' if the time is out of range.
+char* TScores::FormatTimeUtc(char* first, char* last, int64_t timeUtcMs)
+{
+    char* end = TStrTool::DateTime_EpochMsToChars_ISO8601(first, last, timeUtcMs, 0 != timeUtcMs % 1000);
+    return nullptr == end ? first : end;
+}
+//---------------------------------------------------------------------------
 std::string TScores::EncodeScoreToB64(TScore const& score) const
 {
-#if __cplusplus >= 201103L
-    std::string delim = std::to_string(score.Seconds) + ScoreSplitChar + score.Name + ScoreSplitChar + score.TimeUtcStr;
-#else
-    std::string delim =
-        TStrTool::ToStringA(score.Seconds) + ScoreSplitChar + score.Name + ScoreSplitChar + score.TimeUtcStr;
-#endif
+    char numBuffer[TStrTool::ToChars_MaxIntLen];
+    char timeBuffer[TStrTool::DateTime_ISO8601_MaxLen];
+    std::string delim;
+
+    delim.reserve(2 * TStrTool::ToChars_MaxIntLen + score.Name.length() + sizeof(timeBuffer) + 3);
+    delim.append(numBuffer, TStrTool::ToChars(numBuffer, numBuffer + sizeof(numBuffer), score.Seconds));
+    delim += ScoreSplitChar;
+    delim += score.Name;
+    delim += ScoreSplitChar;
+    delim.append(timeBuffer, FormatTimeUtc(timeBuffer, timeBuffer + sizeof(timeBuffer), score.TimeUtcMs));
+    delim += ScoreSplitChar;
+    delim.append(numBuffer, TStrTool::ToChars(numBuffer, numBuffer + sizeof(numBuffer), score.MilliSecs));
+
     return TStrTool::EncodeStrToBase64Str(delim, false);
 }
 //---------------------------------------------------------------------------
 // On success, and if score is not null, score is populated with the delimited values from 'b64'.
-bool TScores::DecodeScoreFromB64(std::string b64, TScore* score) const
+// Scores saved before millisecond support have no 4th element - their milliseconds are derived from the seconds.
+// Records are short, so they decode into a stack buffer. Longer ones (tampered with?) fall back to the heap.
+bool TScores::DecodeScoreFromB64(TStrView b64, TScore* score) const
 {
     static size_t const expectedElementCount = 3;
+    static size_t const idxMilliSecs = 3;
+    static size_t const stackBufferSize = 256;
 
     if (nullptr != score)
         score->Reset();
 
-    std::string scoreAndName = TStrTool::DecodeBase64ToStrA(b64);
-    std::vector<std::string> elements = TStrTool::Split(scoreAndName, ScoreSplitChar);
+    size_t const decodedSize = TStrTool::GetBase64DecodedSize(b64.data(), b64.length());
+    if (0 == decodedSize || TStrTool::Base64_InvalidSize == decodedSize)
+        return false; // User tampering with scores?
+
+    BYTE stackBuffer[stackBufferSize];
+    std::vector<BYTE> heapBuffer;
+    BYTE* decoded = stackBuffer;
 
-    if (elements.size() < expectedElementCount)
+    if (decodedSize > stackBufferSize)
+    {
+        heapBuffer.resize(decodedSize);
+        decoded = &heapBuffer[0];
+    }
+
+    if (!TStrTool::DecodeBase64ToBytes(b64.data(), b64.length(), decoded, decodedSize, nullptr))
+        return false; // User tampering with scores?
+
+    // Walk the fields in place. Only the name, which the score keeps, is copied.
+    TStrSplitter splitter(TStrView(reinterpret_cast<char const*>(decoded), decodedSize), ScoreSplitChar);
+    TStrView elements[idxMilliSecs + 1];
+    size_t elementCount = 0;
+
+    while (elementCount < idxMilliSecs + 1 && splitter.Next(&elements[elementCount]))
+        elementCount++;
+
+    if (elementCount < expectedElementCount)
         return false; // User tampering with scores?
 
     int seconds = 0;
     if (!TStrTool::TryStrToInt32(elements[0], &seconds))
         return false; // User tampering with scores?
 
+    int64_t milliSecs = static_cast<int64_t>(seconds) * 1000;
+    if (elementCount > idxMilliSecs)
+    {
+        if (!TStrTool::TryStrToInt64(elements[idxMilliSecs], &milliSecs) || milliSecs / 1000 != seconds)
+            return false; // User tampering with scores?
+    }
+
+    int64_t timeUtcMs = 0;
+    if (!TStrTool::DateTime_CharsToEpochMs_ISO8601(elements[2].begin(), elements[2].end(), &timeUtcMs))
+        return false; // User tampering with scores?
+
     if (nullptr != score)
     {
         score->Seconds = seconds;
-        score->Name = elements[1];
-        score->TimeUtcStr = elements[2];
+        score->MilliSecs = milliSecs;
+        score->Name.assign(elements[1].data(), elements[1].size());
+        score->TimeUtcMs = timeUtcMs;
     }
 
     return true;
 }
 //---------------------------------------------------------------------------
-uint32_t TScores::GetAdler32(TScoreList const& scores)
+// The milliseconds are only part of the hash for files saved with CheckVersion_Current, so older files still validate.
+uint32_t TScores::GetAdler32(TScoreList const& scores) const
 {
-    std::string data;
+    char numBuffer[TStrTool::ToChars_MaxIntLen];
+    char timeBuffer[TStrTool::DateTime_ISO8601_MaxLen];
+    Crypt::TAdler::TState adler;
+    bool const includeMilliSecs = m_CheckVersion >= CheckVersion_Current;
 
+    // Hashed piece by piece, with numbers formatted on the stack - the same bytes as the old joined string
     for (TScores::TScoreList::const_iterator it = scores.begin(); it != scores.end(); it++)
     {
         TScore const& item = *it;
-#if __cplusplus >= 201103L
-        data += (std::to_string(item.Seconds) + "|" + item.Name + "|" + item.TimeUtcStr + "\n");
-#else
-        data += (TStrTool::ToStringA(item.Seconds) + "|" + item.Name + "|" + item.TimeUtcStr + "\n");
-#endif
+
+        char const* numEnd = TStrTool::ToChars(numBuffer, numBuffer + sizeof(numBuffer), item.Seconds);
+        adler.Update(numBuffer, static_cast<size_t>(numEnd - numBuffer));
+        adler.Update("|", 1);
+        adler.Update(item.Name);
+        adler.Update("|", 1);
+        char const* timeEnd = FormatTimeUtc(timeBuffer, timeBuffer + sizeof(timeBuffer), item.TimeUtcMs);
+        adler.Update(timeBuffer, static_cast<size_t>(timeEnd - timeBuffer));
+
+        if (includeMilliSecs)
+        {
+            numEnd = TStrTool::ToChars(numBuffer, numBuffer + sizeof(numBuffer), item.MilliSecs);
+            adler.Update("|", 1);
+            adler.Update(numBuffer, static_cast<size_t>(numEnd - numBuffer));
+        }
+
+        adler.Update("\n", 1);
     }
 
-    return Crypt::TAdler::Adler32(data);
+    return adler.Final();
 }
 //---------------------------------------------------------------------------
 bool TScores::ParseSection_General()
 {
     std::string sectionName = SectionName_General;
-    std::string searchKey, tmpStr;
+    std::string searchKey;
+    TStrView trimmedVal;
     TSection* secP;
     TKeyVal* keyValP;
     size_t idx;
@@ -279,10 +392,10 @@ bool TScores::ParseSection_General()
     else
     {
         keyValP = &secP->KeyVals[idx];
-        tmpStr = TStrTool::Trim_Copy(keyValP->Value);
+        trimmedVal = TStrTool::Trim_View(keyValP->Value);
 
         uint32_t valUInt32 = 0;
-        if (tmpStr.length() == 0 || !TStrTool::TryStrToUInt32(tmpStr, &valUInt32))
+        if (trimmedVal.length() == 0 || !TStrTool::TryStrToUInt32(trimmedVal, &valUInt32))
         {
 //            ELog.fwprintf(ELogMsgLevel::LML_Light,
 //                L"%s: Warning: Section \"%s\" has invalid value for key: \"%s\".\n",
@@ -294,6 +407,23 @@ bool TScores::ParseSection_General()
         }
     }
 
+    searchKey = KeyName_Gen_CheckVersion;
+    idx = secP->FindKey(searchKey, true);
+    if (TSection::NotFound == idx)
+    {
+        // Key is missing - saved before milliseconds were recorded
+        m_CheckVersion = CheckVersion_Legacy;
+    }
+    else
+    {
+        keyValP = &secP->KeyVals[idx];
+        trimmedVal = TStrTool::Trim_View(keyValP->Value);
+
+        uint32_t valUInt32 = 0;
+        if (trimmedVal.length() > 0 && TStrTool::TryStrToUInt32(trimmedVal, &valUInt32))
+            m_CheckVersion = valUInt32;
+    }
+
     return true;
 }
 //---------------------------------------------------------------------------
@@ -332,11 +462,11 @@ bool TScores::ParseSection_Scores()
         if (!DecodeScoreFromB64(keyValP->Value, &score))
             continue;
 
-        if (TStrTool::CompareIC(KeyName_Scores_Beginner, keyValP->Key) == 0)
+        if (TStrTool::EqualsIC(KeyName_Scores_Beginner, keyValP->Key))
             Beginner.push_back(score);
-        else if (TStrTool::CompareIC(KeyName_Scores_Intermediate, keyValP->Key) == 0)
+        else if (TStrTool::EqualsIC(KeyName_Scores_Intermediate, keyValP->Key))
             Intermediate.push_back(score);
-        else if (TStrTool::CompareIC(KeyName_Scores_Expert, keyValP->Key) == 0)
+        else if (TStrTool::EqualsIC(KeyName_Scores_Expert, keyValP->Key))
             Expert.push_back(score);
     }
 
@@ -345,6 +475,10 @@ bool TScores::ParseSection_Scores()
 //---------------------------------------------------------------------------
 EErrINI TScores::Load(const std::string& fileNameINI, const char assignOperator, size_t maxLineLen)
 {
+    // Unchanged since it was last loaded - the scores parsed then are still right
+    if (IsLoadCurrent(fileNameINI, assignOperator, maxLineLen))
+        return EErrINI::EI_NoError;
+
     EErrINI result = Inherited::Load(fileNameINI, assignOperator, maxLineLen);
 
     if (EErrINI::EI_NoError != result)
@@ -36,35 +36,40 @@ namespace SweepThemMines
 struct TScore
 {
     int Seconds;
+    int64_t MilliSecs; // Full precision time. Scores saved before millisecond support use Seconds * 1000.
     std::string Name;
-    std::string TimeUtcStr;
+    int64_t TimeUtcMs; // When the score was set, in milliseconds since 1970-01-01T00:00:00Z. ISO-8601 in the file.
 
     TScore()
-        : Seconds(0)
+        : Seconds(0),
+          MilliSecs(0),
+          TimeUtcMs(0)
     {
     }
-    TScore(int seconds, std::string const& name, std::string const& timeUtc)
-        : Seconds(seconds),
+    TScore(int64_t milliSecs, std::string const& name, int64_t timeUtcMs)
+        : Seconds(static_cast<int>(milliSecs / 1000)),
+          MilliSecs(milliSecs),
           Name(name),
-          TimeUtcStr(timeUtc)
+          TimeUtcMs(timeUtcMs)
     {
     }
 
     void Reset()
     {
         Seconds = 0;
+        MilliSecs = 0;
         Name = "";
-        TimeUtcStr = "";
+        TimeUtcMs = 0;
     }
 
     static bool CompareAsc(TScore const& a, TScore const& b)
     {
-        if (a.Seconds != b.Seconds)
-            return a.Seconds < b.Seconds; // Sort by Score ascending
+        if (a.MilliSecs != b.MilliSecs)
+            return a.MilliSecs < b.MilliSecs; // Sort by Score ascending
         else if (a.Name != b.Name)
             return a.Name < b.Name; // Sort by Name alphabetically
         else
-            return a.TimeUtcStr < b.TimeUtcStr; // Keep oldest time first
+            return a.TimeUtcMs < b.TimeUtcMs; // Keep oldest time first
     }
 };
 
@@ -83,6 +88,8 @@ public:
 public: // Static variables
     static char const ScoreSplitChar = '|';
     static unsigned int const Check_NotSetVal = static_cast<unsigned int>(-1);
+    static uint32_t const CheckVersion_Legacy = 1; // Check hash without milliseconds (key missing from file)
+    static uint32_t const CheckVersion_Current = 2; // Check hash includes milliseconds
     static size_t const Default_MaxScoresToKeep = 5;
 
     // Section names
@@ -91,6 +98,7 @@ public: // Static variables
 
     // Key names - General
     static char const* KeyName_Gen_Check;
+    static char const* KeyName_Gen_CheckVersion;
 
     // Key names - Scores
     static char const* KeyName_Scores_Beginner;
@@ -99,6 +107,7 @@ public: // Static variables
 
 private:
     uint32_t m_Check;
+    uint32_t m_CheckVersion;
 
 public:
     TScoreList Beginner;
@@ -113,16 +122,18 @@ private:
     bool ApplyChanges_Scores();
 
 private:
+    static char* FormatTimeUtc(char* first, char* last, int64_t timeUtcMs);
     std::string EncodeScoreToB64(TScore const& score) const;
-    bool DecodeScoreFromB64(std::string b64, TScore* score) const;
-    uint32_t GetAdler32(TScoreList const& scores);
-    uint32_t CalcCheckHash();
+    bool DecodeScoreFromB64(ASWTools::TStrView b64, TScore* score) const;
+    uint32_t GetAdler32(TScoreList const& scores) const;
+    uint32_t CalcCheckHash() const;
 
 public:
     TScores();
     ~TScores();
 
     bool Reset() override;
+    bool IsDirty() const override;
 
     ASWTools::BasicINI::EErrINI Load(const std::string& fileNameINI, const char assignOperator = DefaultAssignOperator,
         size_t maxLineLen = DefaultMaxLineLength) override;
@@ -135,7 +146,7 @@ public:
 
 public:
     static void AddScore(TScoreList& list, TScore const& score);
-    static void AddScore(TScoreList& list, int seconds, std::string const& name);
+    static void AddScore(TScoreList& list, int64_t milliSecs, std::string const& name);
 };
 
 } // namespace SweepThemMines